@@ -67,27 +67,10 @@ macro(find_boost)
     "1.69.1" "1.69.0" "1.69"
     "1.68.1" "1.68.0" "1.68"
     "1.67.1" "1.67.0" "1.67"
-    "1.66.1" "1.66.0" "1.66"
-    "1.65.1" "1.65.0" "1.65"
-    "1.64.1" "1.64.0" "1.64"
-    "1.63.1" "1.63.0" "1.63"
-    "1.62.1" "1.62.0" "1.62"
-    "1.61.1" "1.61.0" "1.61"
-    "1.60.1" "1.60.0" "1.60"
-    "1.59.1" "1.59.0" "1.59"
-    "1.58.1" "1.58.0" "1.58"
-    "1.57.1" "1.57.0" "1.57"
-    "1.56.1" "1.56.0" "1.56"
-    "1.55.1" "1.55.0" "1.55"
-    "1.54.1" "1.54.0" "1.54"
-    "1.53.1" "1.53.0" "1.53"
-    "1.52.1" "1.52.0" "1.52"
-    "1.51.1" "1.51.0" "1.51"
-    "1.50.1" "1.50.0" "1.50"
-    "1.49.1" "1.49.0" "1.49"
-    "1.48.1" "1.48.0" "1.48")
+    "1.66.1" "1.66.0" "1.66")
 
-  find_package(Boost 1.48.0 COMPONENTS ${ARGN})
+  ## 1.66 is required for boost::container::flat_map on top of a small_vector (EmpiricalFormula)
+  find_package(Boost 1.66.0 COMPONENTS ${ARGN})
 
 endmacro(find_boost)
 
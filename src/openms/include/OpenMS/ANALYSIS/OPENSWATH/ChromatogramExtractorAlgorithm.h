@@ -87,6 +87,12 @@ public:
     /**
      * @brief Extract chromatograms at the m/z and RT defined by the ExtractionCoordinates.
      *
+     * The extraction windows are computed once and each spectrum is
+     * traversed in a single merge-sweep over the (sorted) coordinates, so the
+     * cost per spectrum is linear in the number of data points plus the
+     * number of coordinates. The result is the same as calling
+     * extract_value_tophat for each coordinate separately.
+     *
      * @param input Input spectral map
      * @param output Output chromatograms (XICs)
      * @param extraction_coordinates Extracts around these coordinates (from
@@ -0,0 +1,127 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
+
+#include <OpenMS/CONCEPT/Types.h>
+
+namespace OpenMS
+{
+  /**
+   * @brief A wrapper around spectrum access that indexes spectra by ion mobility
+   *
+   * Spectra with ion mobility information (e.g. PASEF / diaPASEF frames)
+   * contain the peaks of all ion mobility scans, sorted by m/z only. Selecting
+   * the peaks of a small drift time window from such a spectrum requires
+   * scanning all of its peaks, which dominates scoring time when the same
+   * frame is accessed for many peptides.
+   *
+   * This wrapper builds an index for each accessed spectrum once: the peaks
+   * are grouped into equally spaced ion mobility bins, and within each bin
+   * they are kept in m/z order. getSpectrumByIdAndDrift() then only touches
+   * the bins overlapping the requested drift time window and merges them back
+   * into m/z order. The result is identical to filtering the full spectrum by
+   * drift time (drift_lower < im < drift_upper), including the order of peaks
+   * with identical m/z.
+   *
+   * The indices are held in a least-recently-used cache with a memory budget,
+   * which is shared between light clones (and may be accessed from multiple
+   * threads at once). All other calls, including getSpectrumById(), are
+   * passed on unchanged to the underlying spectrum access.
+   *
+   */
+  class OPENMS_DLLAPI SpectrumAccessIonMobilityIndexed :
+    public SpectrumAccessTransforming
+  {
+public:
+
+    /** @brief Constructor
+     *
+     * @param sptr Underlying spectrum access
+     * @param nr_im_bins Number of ion mobility bins per spectrum
+     * @param max_bytes Memory budget for the cached indices (in bytes)
+     *
+    */
+    explicit SpectrumAccessIonMobilityIndexed(OpenSwath::SpectrumAccessPtr sptr,
+        Size nr_im_bins = 64, Size max_bytes = 512 * 1024 * 1024);
+
+    ~SpectrumAccessIonMobilityIndexed() override;
+
+    /// Light clone which shares the index cache with this object
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override;
+
+    /**
+     * @brief Retrieve the peaks of a spectrum inside a drift time window
+     *
+     * Returns a spectrum with m/z, intensity and ion mobility arrays containing
+     * all peaks with drift_lower < ion mobility < drift_upper, sorted by m/z.
+     * If the spectrum has no ion mobility array, it is returned unfiltered.
+     *
+     * @param id Index of the spectrum
+     * @param drift_lower Lower drift time boundary (exclusive)
+     * @param drift_upper Upper drift time boundary (exclusive)
+     *
+    */
+    OpenSwath::SpectrumPtr getSpectrumByIdAndDrift(int id, double drift_lower, double drift_upper);
+
+    /// Number of spectrum indices currently held in the cache
+    Size getNrIndexedSpectra() const;
+
+    /// Number of spectrum indices built so far (by this object and its light clones)
+    Size getNrIndexBuilds() const;
+
+private:
+
+    struct IonMobilityIndex;
+    class IndexCache;
+
+    typedef boost::shared_ptr<const IonMobilityIndex> IonMobilityIndexPtr;
+
+    SpectrumAccessIonMobilityIndexed(OpenSwath::SpectrumAccessPtr sptr, Size nr_im_bins,
+        boost::shared_ptr<IndexCache> cache);
+
+    /// Retrieve the index of a spectrum from the cache or build it (@p spectrum is set if it had to be read)
+    IonMobilityIndexPtr getIndex_(int id, OpenSwath::SpectrumPtr& spectrum);
+
+    /// Build the ion mobility index of a spectrum
+    IonMobilityIndexPtr buildIndex_(const OpenSwath::Spectrum& spectrum) const;
+
+    Size nr_im_bins_;
+    boost::shared_ptr<IndexCache> cache_;
+
+  };
+}
+
@@ -41,6 +41,8 @@
 
 #include <OpenMS/FORMAT/CachedMzML.h>
 
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumLRUCache.h>
+
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
 
 #include <fstream>
@@ -60,6 +62,10 @@ namespace OpenMS
     data item. The caller is responsible to ensure that access is performed
     atomically.
 
+    Optionally, recently read spectra can be kept in memory (see
+    setCacheSize()) which avoids reading the same spectrum from disk
+    repeatedly.
+
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
     public OpenSwath::ISpectrumAccess,
@@ -109,6 +115,25 @@ public:
     ChromatogramSettings getChromatogramMetaInfo(int id) const;
 
     std::string getChromatogramNativeID(int id) const override;
+
+    /**
+      @brief Keep recently read spectra in memory
+
+      Enables a cache of decoded spectra (see SpectrumLRUCache) which is
+      shared with all light clones created afterwards, so that spectra
+      accessed repeatedly are only read from disk once.
+
+      @param max_bytes Memory budget of the cache in bytes (0 disables the cache)
+    */
+    void setCacheSize(Size max_bytes);
+
+    /// The spectrum cache with its hit and miss counters (a null pointer if caching is disabled)
+    boost::shared_ptr<SpectrumLRUCache> getCache() const;
+
+protected:
+
+    /// Cache of recently read spectra (shared with light clones, may be null)
+    boost::shared_ptr<SpectrumLRUCache> cache_;
   };
 
 } //end namespace
@@ -41,6 +41,8 @@
 
 #include <OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>
 
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumLRUCache.h>
+
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
 
 #include <boost/shared_ptr.hpp>
@@ -70,6 +72,9 @@ namespace OpenMS
    * sqlite3 supports multiple parallel read threads as long as they use a
    * different db connection.
    *
+   * Since reading a single spectrum is expensive, recently read spectra can
+   * be kept in memory (see setCacheSize()).
+   *
    * Sample usage:
    *
    *
@@ -124,12 +129,28 @@ public:
 
     std::string getChromatogramNativeID(int /* id */) const override;
 
+    /**
+      @brief Keep recently read spectra in memory
+
+      Enables a cache of decoded spectra (see SpectrumLRUCache) which is
+      shared with all light clones and subsets created afterwards, so that spectra
+      accessed repeatedly are only read from disk once.
+
+      @param max_bytes Memory budget of the cache in bytes (0 disables the cache)
+    */
+    void setCacheSize(Size max_bytes);
+
+    /// The spectrum cache with its hit and miss counters (a null pointer if caching is disabled)
+    boost::shared_ptr<SpectrumLRUCache> getCache() const;
+
 private:
 
     /// Access to underlying sqMass file
     OpenMS::Internal::MzMLSqliteHandler handler_;
     /// Optional subset of spectral indices
     std::vector<int> sidx_;
+    /// Cache of recently read spectra, indexed by their position in the file (shared with clones, may be null)
+    boost::shared_ptr<SpectrumLRUCache> cache_;
   };
 } //end namespace OpenMS
 
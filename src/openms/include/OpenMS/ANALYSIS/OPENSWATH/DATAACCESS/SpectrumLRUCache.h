@@ -0,0 +1,142 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace OpenMS
+{
+
+  /**
+    @brief A thread-safe least-recently-used cache of spectra with a memory budget
+
+    Used by the on-disk implementations of the Spectrum Access interface
+    (SpectrumAccessOpenMSCached, SpectrumAccessSqMass) to avoid reading and
+    decoding the same spectrum from disk repeatedly, e.g. when the retention
+    time windows of multiple transition groups overlap.
+
+    The cache holds its own copy of each spectrum and hands out copies, so
+    callers may modify the returned data (e.g. SpectrumAccessQuadMZTransforming
+    does) without affecting the cached data. When the data arrays of the
+    cached spectra exceed the memory budget, the least recently used spectra
+    are removed.
+
+    All functions may be called from multiple threads at once, so a single
+    cache can be shared between light clones of a Spectrum Access object.
+
+  */
+  class OPENMS_DLLAPI SpectrumLRUCache
+  {
+
+public:
+
+    /**
+      @brief Constructor
+
+      @param max_bytes Memory budget for the data arrays of the cached spectra (in bytes)
+    */
+    explicit SpectrumLRUCache(Size max_bytes);
+
+    /// Destructor
+    ~SpectrumLRUCache();
+
+    /**
+      @brief Retrieve a spectrum from the cache
+
+      @param id Index of the spectrum
+      @param spectrum Output spectrum (a copy of the cached spectrum)
+
+      @return Whether the spectrum was found in the cache
+    */
+    bool get(Size id, OpenSwath::SpectrumPtr& spectrum);
+
+    /**
+      @brief Add a spectrum to the cache
+
+      Stores a copy of @p spectrum and removes the least recently used spectra
+      if the memory budget is exceeded. Spectra that are larger than the whole
+      budget are not stored.
+    */
+    void put(Size id, const OpenSwath::SpectrumPtr& spectrum);
+
+    /// Remove all spectra from the cache (the counters are kept)
+    void clear();
+
+    /// Number of successful lookups
+    Size getHits() const;
+
+    /// Number of lookups of spectra that were not cached
+    Size getMisses() const;
+
+    /// Number of spectra currently held in the cache
+    Size getNrSpectra() const;
+
+    /// Memory used by the data arrays of the cached spectra (in bytes)
+    Size getBytes() const;
+
+    /// Memory budget (in bytes)
+    Size getMaxBytes() const;
+
+private:
+
+    typedef std::list< std::pair<Size, OpenSwath::SpectrumPtr> > EntryList;
+
+    /// Deep copy of all data arrays of a spectrum
+    static OpenSwath::SpectrumPtr copySpectrum_(const OpenSwath::Spectrum& spectrum);
+
+    /// Memory used by the data arrays of a spectrum (in bytes)
+    static Size byteSize_(const OpenSwath::Spectrum& spectrum);
+
+    /// Cached spectra, most recently used first
+    EntryList entries_;
+    /// Position of each cached spectrum in entries_
+    std::unordered_map<Size, EntryList::iterator> index_;
+
+    Size max_bytes_;
+    Size bytes_;
+    Size hits_;
+    Size misses_;
+
+    mutable std::mutex mutex_;
+  };
+
+} //end namespace OpenMS
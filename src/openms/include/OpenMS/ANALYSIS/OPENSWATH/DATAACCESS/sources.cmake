@@ -6,12 +6,14 @@ set(sources_list_h
 DataAccessHelper.h
 MRMFeatureAccessOpenMS.h
 SimpleOpenMSSpectraAccessFactory.h
+SpectrumAccessIonMobilityIndexed.h
 SpectrumAccessOpenMS.h
 SpectrumAccessOpenMSCached.h
 SpectrumAccessOpenMSInMemory.h
 SpectrumAccessSqMass.h
 SpectrumAccessTransforming.h
 SpectrumAccessQuadMZTransforming.h
+SpectrumLRUCache.h
 )
 
 ### add path to the filenames
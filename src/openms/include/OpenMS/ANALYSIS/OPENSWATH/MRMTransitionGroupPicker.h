@@ -117,6 +117,8 @@ public:
 
       std::vector<MSChromatogram > picked_chroms;
       std::vector<MSChromatogram > smoothed_chroms;
+      picked_chroms.reserve(transition_group.getChromatograms().size() + transition_group.getPrecursorChromatograms().size());
+      smoothed_chroms.reserve(picked_chroms.capacity());
 
       // Pick fragment ion chromatograms
       for (Size k = 0; k < transition_group.getChromatograms().size(); k++)
@@ -150,8 +152,8 @@ public:
 
           picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
           picked_chrom.sortByIntensity();
-          picked_chroms.push_back(picked_chrom);
-          smoothed_chroms.push_back(smoothed_chrom);
+          picked_chroms.push_back(std::move(picked_chrom));
+          smoothed_chroms.push_back(std::move(smoothed_chrom));
         }
       }
 
@@ -405,6 +407,29 @@ public:
                                     const int chr_idx,
                                     const int peak_idx)
     {
+      // intensities of the detecting transitions, needed for the total MI of every transition:
+      std::vector<std::vector<double> > det_intensities;
+      std::vector<double> chrom_vect_id;
+      if (compute_total_mi_)
+      {
+        for (Size m = 0; m < transition_group.getTransitions().size(); m++)
+        {
+          if (transition_group.getTransitions()[m].isDetectingTransition())
+          {
+            const SpectrumT& chromatogram_det = selectChromHelper_(transition_group, transition_group.getTransitions()[m].getNativeID());
+            std::vector<double> chrom_vect_det;
+            chrom_vect_det.reserve(chromatogram_det.size());
+            for (typename SpectrumT::const_iterator it = chromatogram_det.begin(); it != chromatogram_det.end(); it++)
+            {
+              chrom_vect_det.push_back(it->getIntensity());
+            }
+            det_intensities.push_back(std::move(chrom_vect_det));
+          }
+        }
+      }
+
+      // resampled chromatogram, reused for all transitions:
+      SpectrumT used_chromatogram;
       for (Size k = 0; k < transition_group.getTransitions().size(); k++)
       {
 
@@ -445,7 +470,7 @@ public:
         double transition_total_mi = 0;
         if (compute_total_mi_)
         {
-          std::vector<double> chrom_vect_id, chrom_vect_det;
+          chrom_vect_id.clear();
           for (typename SpectrumT::const_iterator it = chromatogram.begin(); it != chromatogram.end(); it++)
           {
             chrom_vect_id.push_back(it->getIntensity());
@@ -453,19 +478,10 @@ public:
 
           // compute baseline mutual information
           int transition_total_mi_norm = 0;
-          for (Size m = 0; m < transition_group.getTransitions().size(); m++)
+          for (std::vector<double>& chrom_vect_det : det_intensities)
           {
-            if (transition_group.getTransitions()[m].isDetectingTransition())
-            {
-              const SpectrumT& chromatogram_det = selectChromHelper_(transition_group, transition_group.getTransitions()[m].getNativeID());
-              chrom_vect_det.clear();
-              for (typename SpectrumT::const_iterator it = chromatogram_det.begin(); it != chromatogram_det.end(); it++)
-              {
-                chrom_vect_det.push_back(it->getIntensity());
-              }
-              transition_total_mi += OpenSwath::Scoring::rankedMutualInformation(chrom_vect_det, chrom_vect_id);
-              transition_total_mi_norm++;
-            }
+            transition_total_mi += OpenSwath::Scoring::rankedMutualInformation(chrom_vect_det, chrom_vect_id);
+            transition_total_mi_norm++;
           }
           if (transition_total_mi_norm > 0) { transition_total_mi /= transition_total_mi_norm; }
 
@@ -476,11 +492,10 @@ public:
           }
         }
 
-        SpectrumT used_chromatogram;
         // resample the current chromatogram
         if (peak_integration_ == "original")
         {
-          used_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
+          resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right, used_chromatogram);
         }
         else if (peak_integration_ == "smoothed")
         {
@@ -489,7 +504,7 @@ public:
             throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                              "Tried to calculate peak area and height without any smoothed chromatograms");
           }
-          used_chromatogram = resampleChromatogram_(smoothed_chroms[k], master_peak_container, local_left, local_right);
+          resampleChromatogram_(smoothed_chroms[k], master_peak_container, local_left, local_right, used_chromatogram);
         }
         else
         {
@@ -512,9 +527,11 @@ public:
           double avg_noise_level{0};
           if (background_subtraction_ == "original")
           {
-            const double intensity_left = chromatogram.PosBegin(local_left)->getIntensity();
-            const double intensity_right = (chromatogram.PosEnd(local_right) - 1)->getIntensity();
-            const UInt n_points = std::distance(chromatogram.PosBegin(local_left), chromatogram.PosEnd(local_right));
+            const typename SpectrumT::const_iterator it_left = chromatogram.PosBegin(local_left);
+            const typename SpectrumT::const_iterator it_right = chromatogram.PosEnd(local_right);
+            const double intensity_left = it_left->getIntensity();
+            const double intensity_right = (it_right - 1)->getIntensity();
+            const UInt n_points = std::distance(it_left, it_right);
             avg_noise_level = (intensity_right + intensity_left) / 2;
             background = avg_noise_level * n_points;
           }
@@ -603,6 +620,8 @@ public:
                                     const int chr_idx,
                                     const int peak_idx)
     {
+      // resampled chromatogram, reused for all precursors:
+      SpectrumT used_chromatogram;
       for (Size k = 0; k < transition_group.getPrecursorChromatograms().size(); k++)
       {
         const SpectrumT& chromatogram = transition_group.getPrecursorChromatograms()[k];
@@ -619,11 +638,10 @@ public:
           local_right = right_edges[prec_idx];
         }
 
-        SpectrumT used_chromatogram;
         // resample the current chromatogram
         if (peak_integration_ == "original")
         {
-          used_chromatogram = resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right);
+          resampleChromatogram_(chromatogram, master_peak_container, local_left, local_right, used_chromatogram);
           // const SpectrumT& used_chromatogram = chromatogram; // instead of resampling
         }
         else if (peak_integration_ == "smoothed" && smoothed_chroms.size() <= prec_idx)
@@ -633,7 +651,7 @@ public:
         }
         else if (peak_integration_ == "smoothed")
         {
-          used_chromatogram = resampleChromatogram_(smoothed_chroms[prec_idx], master_peak_container, local_left, local_right);
+          resampleChromatogram_(smoothed_chroms[prec_idx], master_peak_container, local_left, local_right, used_chromatogram);
         }
         else
         {
@@ -661,9 +679,11 @@ public:
           }
           else if (background_subtraction_ == "original")
           {
-            const double intensity_left = chromatogram.PosBegin(local_left)->getIntensity();
-            const double intensity_right = (chromatogram.PosEnd(local_right) - 1)->getIntensity();
-            const UInt n_points = std::distance(chromatogram.PosBegin(local_left), chromatogram.PosEnd(local_right));
+            const typename SpectrumT::const_iterator it_left = chromatogram.PosBegin(local_left);
+            const typename SpectrumT::const_iterator it_right = chromatogram.PosEnd(local_right);
+            const double intensity_left = it_left->getIntensity();
+            const double intensity_right = (it_right - 1)->getIntensity();
+            const UInt n_points = std::distance(it_left, it_right);
             avg_noise_level = (intensity_right + intensity_left) / 2;
             background = avg_noise_level * n_points;
           }
@@ -833,17 +853,19 @@ protected:
       const SpectrumT& ref_chromatogram = selectChromHelper_(transition_group, picked_chroms[chr_idx].getNativeID());
       prepareMasterContainer_(ref_chromatogram, master_peak_container, best_left - resample_boundary, best_right + resample_boundary);
       std::vector<std::vector<double> > all_ints;
+      SpectrumT used_chromatogram;
       for (Size k = 0; k < picked_chroms.size(); k++)
       {
         const SpectrumT& chromatogram = selectChromHelper_(transition_group, picked_chroms[k].getNativeID());
-        const SpectrumT used_chromatogram = resampleChromatogram_(chromatogram, 
-            master_peak_container, best_left - resample_boundary, best_right + resample_boundary);
+        resampleChromatogram_(chromatogram, master_peak_container,
+            best_left - resample_boundary, best_right + resample_boundary, used_chromatogram);
 
         std::vector<double> int_here;
+        int_here.reserve(used_chromatogram.size());
         for (const auto& peak : used_chromatogram) int_here.push_back(peak.getIntensity());
         // Remove chromatograms without a single peak
         double tic = std::accumulate(int_here.begin(), int_here.end(), 0.0);
-        if (tic > 0.0) all_ints.push_back(int_here);
+        if (tic > 0.0) all_ints.push_back(std::move(int_here));
       }
 
       // Compute the cross-correlation for the collected intensities
@@ -1115,6 +1137,22 @@ protected:
     template <typename SpectrumT>
     SpectrumT resampleChromatogram_(const SpectrumT& chromatogram,
                                     const SpectrumT& master_peak_container, double left_boundary, double right_boundary)
+    {
+      SpectrumT resampled_peak_container;
+      resampleChromatogram_(chromatogram, master_peak_container, left_boundary, right_boundary, resampled_peak_container);
+      return resampled_peak_container;
+    }
+
+    /**
+      @brief Resample a container at the positions indicated by the master peak container
+
+      Same as above, but writes into @p resampled_peak_container so that its
+      memory can be reused when resampling many chromatograms in a row.
+    */
+    template <typename SpectrumT>
+    void resampleChromatogram_(const SpectrumT& chromatogram,
+                               const SpectrumT& master_peak_container, double left_boundary, double right_boundary,
+                               SpectrumT& resampled_peak_container)
     {
       // get the start / end point of this chromatogram => then add one more
       // point beyond the two boundaries to make the resampling accurate also
@@ -1127,11 +1165,9 @@ protected:
       while (end != chromatogram.end() && end->getMZ() < right_boundary) {end++;}
       if (end != chromatogram.end()) {end++;}
 
-      SpectrumT resampled_peak_container = master_peak_container; // copy the master container, which contains the RT values
+      resampled_peak_container = master_peak_container; // copy the master container, which contains the RT values
       LinearResamplerAlign lresampler;
       lresampler.raster(begin, end, resampled_peak_container.begin(), resampled_peak_container.end());
-
-      return resampled_peak_container;
     }
 
     //@}
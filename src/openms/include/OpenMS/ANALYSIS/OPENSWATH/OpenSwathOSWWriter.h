@@ -111,6 +111,14 @@ namespace OpenMS
         <tr> <td BGCOLOR="#EBEBEB">VAR_...</td> <td>REAL</td> <td>Fragment ion score used in pyProphet  </td> </tr>
       </table>
 
+    The partial output of one shard of a sharded analysis (see setShard) additionally has the following table, which is removed when the shards are merged by OpenSwathShardMerger:
+
+      <table>
+        <tr> <th BGCOLOR="#EBEBEB" colspan=3>SHARD</th> </tr>
+        <tr> <td BGCOLOR="#EBEBEB">SHARD_INDEX</td> <td>INT</td> <td>Index of the shard (0 to SHARD_COUNT - 1)</td> </tr>
+        <tr> <td BGCOLOR="#EBEBEB">SHARD_COUNT</td> <td>INT</td> <td>Total number of shards of the analysis</td> </tr>
+      </table>
+
    */
   class OPENMS_DLLAPI OpenSwathOSWWriter
   {
@@ -121,6 +129,8 @@ namespace OpenMS
     bool use_ms1_traces_;
     bool sonar_;
     bool enable_uis_scoring_;
+    Size shard_index_;
+    Size nr_shards_;
 
   public:
 
@@ -133,6 +143,16 @@ namespace OpenMS
 
     bool isActive() const;
 
+    /**
+     * @brief Marks the output as the partial result of one shard of a sharded analysis
+     *
+     * If @p nr_shards is larger than one, writeHeader() also creates the
+     * SHARD table, which OpenSwathShardMerger uses to check that all shards
+     * are merged.
+     *
+     */
+    void setShard(Size shard_index, Size nr_shards);
+
     /**
      * @brief Initializes file by generating SQLite tables
      *
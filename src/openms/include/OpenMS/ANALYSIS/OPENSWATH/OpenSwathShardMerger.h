@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Combines the partial results of a sharded OpenSWATH analysis
+
+    OpenSwathWorkflow can split an analysis into several shards, each of
+    which analyzes a deterministic subset of the SWATH windows in a separate
+    process (see OpenSwathWorkflow::setShard) and writes a partial OSW or TSV
+    file. This class combines these partial files into a single output.
+
+    The merged output contains exactly the peak groups of a single-process
+    run. Since the order in which peak groups are written depends on thread
+    scheduling, the merged rows are written in a canonical order (by
+    precursor / transition group and retention time), which does not depend
+    on the number of shards or threads. Merging the output of a single
+    process (one input file) therefore yields the same canonical file. Note
+    that feature identifiers are random numbers generated during scoring and
+    differ between any two runs.
+
+    Each partial file records which shard of how many it is (see
+    OpenSwathOSWWriter::setShard and OpenSwathTSVWriter::setShard). Merging
+    requires exactly the shards 0 to n - 1 of an analysis, each given once;
+    a single file without shard information (the output of an unsharded
+    analysis) is accepted on its own.
+
+  */
+  class OPENMS_DLLAPI OpenSwathShardMerger
+  {
+public:
+
+    /**
+      @brief Merge partial OSW files
+
+      The library tables and the run entry are taken from the first file, the
+      peak groups (tables FEATURE, FEATURE_MS1, FEATURE_MS2, FEATURE_PRECURSOR
+      and FEATURE_TRANSITION) of all files are combined and assigned to the
+      run of the first file. The shards and runs of all files are checked
+      before the output is written, and the output is removed if merging
+      fails. The SHARD table is not copied to the output.
+
+      @param shard_files Partial OSW files (one per shard)
+      @param output_file Merged OSW file (will be overwritten)
+
+      @throw Exception::IllegalArgument if no input is given, the output file is one of the shards, the files are not exactly the shards of one analysis (e.g. if a shard is missing or given twice), the shards were generated from different input files or cannot be merged
+      @throw Exception::FileNotFound if an input file does not exist
+      @throw Exception::UnableToCreateFile if the output file cannot be written
+      @throw Exception::SqlOperationFailed if an input file cannot be opened as an SQLite database
+    */
+    static void mergeOSW(const StringList& shard_files, const String& output_file);
+
+    /**
+      @brief Merge partial TSV files
+
+      All files need to have the same header and, if they have a "filename"
+      column, the same entry in it. The shard information line is not copied
+      to the output.
+
+      @param shard_files Partial TSV files (one per shard)
+      @param output_file Merged TSV file (will be overwritten)
+
+      @throw Exception::IllegalArgument if no input is given, the files are not exactly the shards of one analysis (e.g. if a shard is missing or given twice), have different headers or were generated from different input files
+      @throw Exception::FileNotFound if an input file does not exist
+    */
+    static void mergeTSV(const StringList& shard_files, const String& output_file);
+
+  };
+
+}
@@ -133,6 +133,8 @@ namespace OpenMS
     bool doWrite_;
     bool use_ms1_traces_;
     bool sonar_;
+    Size shard_index_;
+    Size nr_shards_;
 
   public:
 
@@ -143,6 +145,16 @@ namespace OpenMS
 
     bool isActive() const;
 
+    /**
+     * @brief Marks the output as the partial result of one shard of a sharded analysis
+     *
+     * If @p nr_shards is larger than one, writeHeader() writes the line
+     * "# shard <shard_index> of <nr_shards>" before the column header, which
+     * OpenSwathShardMerger uses to check that all shards are merged.
+     *
+     */
+    void setShard(Size shard_index, Size nr_shards);
+
     /**
      * @brief Initializes file by writing TSV header
      *
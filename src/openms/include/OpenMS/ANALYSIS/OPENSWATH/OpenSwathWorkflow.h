@@ -394,6 +394,9 @@ protected:
      *  @param threads_outer_loop How many threads should be used for the outer
      *  loop (-1 will use all threads in the outer loop)
      *  @param prm Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
+     *  @param prefetch_memory Memory (in bytes) that may be used to load the
+     *  next SWATH maps in the background while the current ones are
+     *  processed (only used when loading data into memory, 0 disables prefetching)
      *
      *  @note The total number of threads should be divisible by this number
      *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
@@ -401,11 +404,63 @@ protected:
      *
      *
      **/
-    OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
-      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop)
+    OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop, Size prefetch_memory = 0) :
+      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop),
+      prefetch_memory_(prefetch_memory),
+      shard_index_(0),
+      nr_shards_(1),
+      lean_output_(false),
+      im_index_memory_(512 * 1024 * 1024)
     {
     }
 
+    /** @brief Restrict the analysis to one shard of the SWATH windows
+     *
+     *  The analysis can be split across several independent (worker)
+     *  processes which each analyze a deterministic subset of the SWATH
+     *  windows: the k-th MS2 map (in the order of the swath maps passed to
+     *  performExtraction) is analyzed by shard k % nr_shards. MS1-only
+     *  analyses are performed by shard 0. The partial results of all shards
+     *  can be combined with OpenSwathShardMerger.
+     *
+     *  @param shard_index Index of the shard analyzed by this object (0 to nr_shards - 1)
+     *  @param nr_shards Total number of shards
+     *
+     *  @throw Exception::IllegalArgument if nr_shards is zero or shard_index is not smaller than nr_shards
+     *
+     **/
+    void setShard(Size shard_index, Size nr_shards);
+
+    /** @brief Stream scoring results instead of collecting them per batch
+     *
+     *  In lean output mode, the TSV / OSW lines of scored transition groups
+     *  are written every few groups and each MS2 chromatogram is written as
+     *  the segment within the RT extraction window that was used for scoring
+     *  (instead of the full extracted trace). The transient chromatograms of
+     *  the transition groups are recycled per thread, so the memory used
+     *  for scoring depends on the number of threads and the batch size
+     *  but not on the size of the assay library. MS1 chromatograms are
+     *  written unchanged.
+     *
+     *  @param lean_output Whether to use the lean output mode (disabled by default)
+     *
+     **/
+    void setLeanOutput(bool lean_output);
+
+    /** @brief Set the memory budget for the ion mobility indices of the spectra
+     *
+     *  With ion mobility extraction, the spectra of each SWATH map (and of
+     *  the MS1 map) are indexed by ion mobility when they are first scored
+     *  (see SpectrumAccessIonMobilityIndexed). The indices of each map are
+     *  kept in a least-recently-used cache that may use at most this much
+     *  memory, so the total is bounded by this budget times the number of maps
+     *  analyzed at once (see threads_outer_loop) plus one for the MS1 map.
+     *
+     *  @param im_index_memory Memory budget per map in bytes (512 MB by default, 0 disables the index)
+     *
+     **/
+    void setIonMobilityIndexMemory(Size im_index_memory);
+
     /** @brief Execute OpenSWATH analysis on a set of SwathMaps and transitions.
      *
      * See OpenSwathWorkflow class for a detailed description of this function.
@@ -429,6 +484,9 @@ protected:
      * \p load_into_memory where larger batch sizes increase memory and
      * potentially decrease the utility of parallelization while loading data
      * into memory will increase memory usage but decrease execution time.
+     * If \p load_into_memory is set and a prefetch memory budget was given in
+     * the constructor, the next SWATH maps are loaded in the background
+     * while the current ones are extracted and scored.
      *
     */
     void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps,
@@ -503,6 +561,7 @@ protected:
      * @param tsv_writer TSV writer for storing output (on the fly)
      * @param osw_writer OSW Writer object to store identified features in SQLite format
      * @param ms1only If true, will only score on MS1 level and ignore MS2 level
+     * @param chromConsumer In lean output mode, the scored (RT-filtered) chromatograms are written to this consumer (if given)
      *
     */
     void scoreAllChromatograms_(
@@ -517,7 +576,8 @@ protected:
         OpenSwathTSVWriter & tsv_writer,
         OpenSwathOSWWriter & osw_writer,
         int nr_ms1_isotopes = 0,
-        bool ms1only = false) const;
+        bool ms1only = false,
+        Interfaces::IMSDataConsumer * chromConsumer = nullptr) const;
 
     /** @brief Select which compounds to analyze in the next batch (and copy to output)
      *
@@ -550,6 +610,26 @@ protected:
     void copyBatchTransitions_(const std::vector<OpenSwath::LightCompound>& used_compounds,
       const std::vector<OpenSwath::LightTransition>& all_transitions,
       std::vector<OpenSwath::LightTransition>& output);
+
+    /** @brief Memory budget (in bytes) for SWATH maps loaded ahead of time
+     *
+     *  Maps that were loaded in the background but are not yet processed
+     *  may use at most this much memory (0 disables prefetching).
+     *
+     **/
+    Size prefetch_memory_;
+
+    /// Index of the shard (subset of SWATH windows) analyzed by this object
+    Size shard_index_;
+
+    /// Total number of shards (1 analyzes all SWATH windows)
+    Size nr_shards_;
+
+    /// Whether scoring results are streamed to the output (see setLeanOutput())
+    bool lean_output_;
+
+    /// Memory budget (in bytes) for the ion mobility indices of each map (see setIonMobilityIndexMemory())
+    Size im_index_memory_;
   };
 
   /**
@@ -43,6 +43,8 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/MATH/MISC/EmgGradientDescent.h>
 
+#include <memory>
+
 namespace OpenMS
 {
   /**
@@ -543,36 +545,18 @@ protected:
     PeakArea integratePeak_(const PeakContainerT& pc, double left, double right) const
     {
       OPENMS_PRECONDITION(left <= right, "Left peak boundary must be smaller than right boundary!") // otherwise the code below will segfault (due to PosBegin/PosEnd)
-      PeakContainerT emg_pc;
+      std::unique_ptr<PeakContainerT> emg_pc;
       const PeakContainerT& p = EMGPreProcess_(pc, emg_pc, left, right);
 
-      std::function<double(const double, const double)>
-      compute_peak_area_trapezoid = [&p](const double left, const double right)
-      {
-        double peak_area { 0.0 };
-        for (typename PeakContainerT::ConstIterator it = p.PosBegin(left); it != p.PosEnd(right) - 1; ++it)
-        {
-          peak_area += ((it + 1)->getPos() - it->getPos()) * ((it->getIntensity() + (it + 1)->getIntensity()) / 2.0);
-        }
-        return peak_area;
-      };
-
-      std::function<double(const double, const double)>
-      compute_peak_area_intensity_sum = [&p](const double left, const double right)
-      {
-        // OPENMS_LOG_WARN << "WARNING: intensity_sum method is being used." << std::endl;
-        double peak_area { 0.0 };
-        for (typename PeakContainerT::ConstIterator it = p.PosBegin(left); it != p.PosEnd(right); ++it)
-        {
-          peak_area += it->getIntensity();
-        }
-        return peak_area;
-      };
+      // look up the peak boundaries only once (each lookup is a binary search)
+      const typename PeakContainerT::ConstIterator it_begin = p.PosBegin(left);
+      const typename PeakContainerT::ConstIterator it_end = p.PosEnd(right);
 
       PeakArea pa;
       pa.apex_pos = (left + right) / 2; // initial estimate, to avoid apex being outside of [left,right]
-      UInt n_points = std::distance(p.PosBegin(left), p.PosEnd(right));
-      for (auto it = p.PosBegin(left); it != p.PosEnd(right); ++it) //OMS_CODING_TEST_EXCLUDE
+      UInt n_points = std::distance(it_begin, it_end);
+      pa.hull_points.reserve(n_points);
+      for (auto it = it_begin; it != it_end; ++it) //OMS_CODING_TEST_EXCLUDE
       {
         pa.hull_points.push_back(DPosition<2>(it->getPos(), it->getIntensity()));
         if (pa.height < it->getIntensity())
@@ -586,7 +570,7 @@ protected:
       {
         if (n_points >= 2)
         {
-          pa.area = compute_peak_area_trapezoid(left, right);
+          pa.area = trapezoid_(it_begin, it_end);
         }
       }
       else if (integration_type_ == INTEGRATION_TYPE_SIMPSON)
@@ -595,26 +579,26 @@ protected:
         {
           OPENMS_LOG_WARN << std::endl << "PeakIntegrator::integratePeak:"
             "number of points is 2, falling back to `trapezoid`." << std::endl;
-          pa.area = compute_peak_area_trapezoid(left, right);
+          pa.area = trapezoid_(it_begin, it_end);
         }
         else if (n_points > 2)
         {
           if (n_points % 2)
           {
-            pa.area = simpson_(p.PosBegin(left), p.PosEnd(right));
+            pa.area = simpson_(it_begin, it_end);
           }
           else
           {
             double areas[4] = {-1.0, -1.0, -1.0, -1.0};
-            areas[0] = simpson_(p.PosBegin(left), p.PosEnd(right) - 1);   // without last point
-            areas[1] = simpson_(p.PosBegin(left) + 1, p.PosEnd(right));   // without first point
-            if (p.begin() <= p.PosBegin(left) - 1)
+            areas[0] = simpson_(it_begin, it_end - 1);   // without last point
+            areas[1] = simpson_(it_begin + 1, it_end);   // without first point
+            if (p.begin() < it_begin)
             {
-              areas[2] = simpson_(p.PosBegin(left) - 1, p.PosEnd(right)); // with one more point on the left
+              areas[2] = simpson_(it_begin - 1, it_end); // with one more point on the left
             }
-            if (p.PosEnd(right) < p.end())
+            if (it_end < p.end())
             {
-              areas[3] = simpson_(p.PosBegin(left), p.PosEnd(right) + 1); // with one more point on the right
+              areas[3] = simpson_(it_begin, it_end + 1); // with one more point on the right
             }
             UInt valids = 0;
             for (const auto& area : areas)
@@ -631,7 +615,10 @@ protected:
       }
       else if (integration_type_ == INTEGRATION_TYPE_INTENSITYSUM)
       {
-        pa.area = compute_peak_area_intensity_sum(left, right);
+        for (auto it = it_begin; it != it_end; ++it) //OMS_CODING_TEST_EXCLUDE
+        {
+          pa.area += it->getIntensity();
+        }
       }
       else
       {
@@ -649,14 +636,16 @@ protected:
       const double peak_apex_pos
     ) const
     {
-      PeakContainerT emg_pc;
+      std::unique_ptr<PeakContainerT> emg_pc;
       const PeakContainerT& p = EMGPreProcess_(pc, emg_pc, left, right);
 
-      const double int_l = p.PosBegin(left)->getIntensity();
-      const double int_r = (p.PosEnd(right) - 1)->getIntensity();
+      const typename PeakContainerT::ConstIterator it_begin = p.PosBegin(left);
+      const typename PeakContainerT::ConstIterator it_end = p.PosEnd(right);
+      const double int_l = it_begin->getIntensity();
+      const double int_r = (it_end - 1)->getIntensity();
       const double delta_int = int_r - int_l;
-      const double delta_pos = (p.PosEnd(right) - 1)->getPos() - p.PosBegin(left)->getPos();
-      const double min_int_pos = int_r <= int_l ? (p.PosEnd(right) - 1)->getPos() : p.PosBegin(left)->getPos();
+      const double delta_pos = (it_end - 1)->getPos() - it_begin->getPos();
+      const double min_int_pos = int_r <= int_l ? (it_end - 1)->getPos() : it_begin->getPos();
       const double delta_int_apex = std::fabs(delta_int) * std::fabs(min_int_pos - peak_apex_pos) / delta_pos;
       double area {0.0};
       double height {0.0};
@@ -677,18 +666,18 @@ protected:
           // sign of delta_int will determine line direction
           // area += delta_int / delta_pos * (it->getPos() - left) + int_l;
           double pos_sum = 0.0; // rt or mz
-          for (auto it = p.PosBegin(left); it != p.PosEnd(right); ++it) //OMS_CODING_TEST_EXCLUDE
+          for (auto it = it_begin; it != it_end; ++it) //OMS_CODING_TEST_EXCLUDE
           {
             pos_sum += it->getPos();
           }
-          UInt n_points = std::distance(p.PosBegin(left), p.PosEnd(right));
+          UInt n_points = std::distance(it_begin, it_end);
 
           // We construct the background area as the sum of a rectangular part
           // and a triangle on top. The triangle is constructed as the sum of the
           // line's y value at each sampled point: \sum_{i=0}^{n} (x_i - x_0)  * m
           const double rectangle_area = n_points * int_l;
           const double slope = delta_int / delta_pos;
-          const double triangle_area = (pos_sum - n_points * p.PosBegin(left)->getPos()) * slope;
+          const double triangle_area = (pos_sum - n_points * it_begin->getPos()) * slope;
           area = triangle_area + rectangle_area;
         }
       }
@@ -701,7 +690,7 @@ protected:
         }
         else if (integration_type_ == INTEGRATION_TYPE_INTENSITYSUM)
         {
-          area = std::min(int_r, int_l) * std::distance(p.PosBegin(left), p.PosEnd(right));;
+          area = std::min(int_r, int_l) * std::distance(it_begin, it_end);
         }
       }
       else if (baseline_type_ == BASELINE_TYPE_VERTICALDIVISION_MAX)
@@ -713,7 +702,7 @@ protected:
         }
         else if (integration_type_ == INTEGRATION_TYPE_INTENSITYSUM)
         {
-          area = std::max(int_r, int_l) * std::distance(p.PosBegin(left), p.PosEnd(right));
+          area = std::max(int_r, int_l) * std::distance(it_begin, it_end);
         }
       }
       else
@@ -751,7 +740,36 @@ protected:
         const double y_h = (it - 1)->getIntensity();
         const double y_0 = it->getIntensity();
         const double y_k = (it + 1)->getIntensity();
-        integral += (1.0 / 6.0) * (h + k) * ((2.0 - k / h) * y_h + (pow(h + k, 2) / (h * k)) * y_0 + (2.0 - h / k) * y_k);
+        integral += (1.0 / 6.0) * (h + k) * ((2.0 - k / h) * y_h + (((h + k) * (h + k)) / (h * k)) * y_0 + (2.0 - h / k) * y_k);
+      }
+      return integral;
+    }
+
+    /**
+      @brief Trapezoidal rule algorithm
+
+      Each point is read only once, as the right end of one trapezoid and
+      then as the left end of the next one.
+
+      @note Make sure the container (chromatogram or spectrum) is sorted with respect to position (RT or m/z).
+
+      @param[in] it_begin The iterator to the first point
+      @param[in] it_end The iterator to the past-the-last point (at least two points are expected)
+      @return The computed area
+    */
+    template <typename PeakContainerConstIteratorT>
+    double trapezoid_(PeakContainerConstIteratorT it_begin, PeakContainerConstIteratorT it_end) const
+    {
+      double integral = 0.0;
+      double pos_prev = it_begin->getPos();
+      auto int_prev = it_begin->getIntensity(); // keep the precision of the container
+      for (auto it = it_begin + 1; it != it_end; ++it) //OMS_CODING_TEST_EXCLUDE
+      {
+        const double pos = it->getPos();
+        const auto intensity = it->getIntensity();
+        integral += (pos - pos_prev) * ((int_prev + intensity) / 2.0);
+        pos_prev = pos;
+        int_prev = intensity;
       }
       return integral;
     }
@@ -770,7 +788,7 @@ protected:
       // enforce order: left <= peakapex <= right
       if (!(left <= peak_apex_pos && peak_apex_pos <= right)) throw Exception::InvalidRange(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
 
-      PeakContainerT emg_pc;
+      std::unique_ptr<PeakContainerT> emg_pc;
       const PeakContainerT& p = EMGPreProcess_(pc, emg_pc, left, right);
     
       typename PeakContainerT::ConstIterator it_PosBegin_l = p.PosBegin(left);
@@ -796,8 +814,8 @@ protected:
       psm.width_at_5 = psm.end_position_at_5 - psm.start_position_at_5;
       psm.width_at_10 = psm.end_position_at_10 - psm.start_position_at_10;
       psm.width_at_50 = psm.end_position_at_50 - psm.start_position_at_50;
-      psm.total_width = (p.PosEnd(right) - 1)->getPos() - p.PosBegin(left)->getPos();
-      psm.slope_of_baseline = (p.PosEnd(right) - 1)->getIntensity() - p.PosBegin(left)->getIntensity();
+      psm.total_width = (it_PosEnd_r - 1)->getPos() - it_PosBegin_l->getPos();
+      psm.slope_of_baseline = (it_PosEnd_r - 1)->getIntensity() - it_PosBegin_l->getIntensity();
       psm.baseline_delta_2_height = psm.slope_of_baseline / peak_height;
       // Source of tailing_factor and asymmetry_factor formulas:
       // USP 40 - NF 35 The United States Pharmacopeia and National Formulary - Supplementary
@@ -897,25 +915,26 @@ private:
 
       @tparam PeakContainerT Either a MSChromatogram or a MSSpectrum
       @param[in] pc Input peak
-      @param[out] emg_pc Will possibly contain the processed peak
+      @param[out] emg_pc Will possibly contain the processed peak (only allocated if the fitting is executed)
       @param[in] left RT or MZ value of the first point of interest
       @param[in] right RT or MZ value of the first point of interest
-      @return A const reference to `emg_pc` if the fitting is executed, `pc` otherwise.
+      @return A const reference to `*emg_pc` if the fitting is executed, `pc` otherwise.
     */
     template <typename PeakContainerT>
     const PeakContainerT& EMGPreProcess_(
       const PeakContainerT& pc,
-      PeakContainerT& emg_pc,
+      std::unique_ptr<PeakContainerT>& emg_pc,
       double& left,
       double& right
     ) const
     {
       if (fit_EMG_)
       {
-        emg_.fitEMGPeakModel(pc, emg_pc, left, right);
-        left = emg_pc.front().getPos();
-        right = emg_pc.back().getPos();
-        return emg_pc;
+        emg_pc.reset(new PeakContainerT());
+        emg_.fitEMGPeakModel(pc, *emg_pc, left, right);
+        left = emg_pc->front().getPos();
+        right = emg_pc->back().getPos();
+        return *emg_pc;
       }
       return pc;
     }
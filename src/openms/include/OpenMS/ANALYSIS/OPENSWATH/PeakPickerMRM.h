@@ -41,6 +41,7 @@
 #include <OpenMS/KERNEL/ChromatogramPeak.h>
 
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianExact.h>
 #include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
@@ -156,6 +157,8 @@ protected:
     double sn_win_len_;
     /// Signal to noise bin count
     UInt sn_bin_count_;
+    /// Use the exact median instead of the histogram for noise estimation
+    bool sn_estimator_exact_;
     /// Whether to write out log messages of the SN estimator
     bool write_sn_log_messages_;
     /// Peak picker method
@@ -172,6 +175,7 @@ protected:
     SavitzkyGolayFilter sgolay_;
     GaussFilter gauss_;
     SignalToNoiseEstimatorMedian<MSChromatogram > snt_;
+    SignalToNoiseEstimatorMedianExact<MSChromatogram > snt_exact_;
   };
 }
 
@@ -234,6 +234,7 @@ private:
     String retentionTimeInterpretation_;
     bool override_group_label_check_;
     bool force_invalid_mods_;
+    Size chunk_size_;
 
     // Typedefs
     typedef std::vector<OpenMS::TargetedExperiment::Protein> ProteinVectorType;
@@ -267,6 +268,25 @@ private:
     */
     void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list);
 
+    /** @brief Parse a single line of tab or comma separated input
+     *
+     * Does not modify any members and can be called for several lines in
+     * parallel (used by readUnstructuredTSVInput_ to parse chunks of lines).
+     *
+     * @param line The line to be parsed
+     * @param line_nr The number of the line (used in error messages and as default transition name)
+     * @param delimiter The delimiter of the columns
+     * @param filetype The type of file ("mrm" or "tsv")
+     * @param header_dict The map which maps the fields in the header to their position
+     * @param mytransition The parsed transition
+     * @param spectrast_legacy Set to true if a SpectraST retention time without RT normalization was found
+     *
+     * @return Whether the transition should be skipped (unannotated SpectraST transitions)
+     *
+    */
+    bool parseTSVLine_(const std::string& line, int line_nr, char delimiter, FileTypes::Type filetype,
+                       const std::map<std::string, int>& header_dict, TSVTransition& mytransition, bool& spectrast_legacy);
+
     /// Extract retention time from a SpectraST comment string
     void spectrastRTExtract(const String str_inp, double & value, bool & spectrast_legacy);
 
@@ -42,6 +42,9 @@
 
 #include <OpenMS/CONCEPT/Types.h>
 
+#include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
+
 namespace OpenMS
 {
   class String;
@@ -77,24 +80,32 @@ namespace OpenMS
     are supported in different flavors. However, one must be careful, because this can lead to negative
     frequencies. In most cases this might be misleading, however, the class therefore supports difference
     formulae. E.g. formula differences of reactions from post-translational modifications.
+
+    Internally, the element counts are kept in a flat map sorted by element, which stores the first
+    few elements (enough for CHNOPS and some extras) inline. Hence, copies, additions and subtractions
+    of typical (bio)molecular formulae do not allocate memory and are implemented as linear merges.
   */
 
   class OPENMS_DLLAPI EmpiricalFormula
   {
 
 protected:
-	  /// Internal typedef for the used map type
-	  typedef std::map<const Element*, SignedSize> MapType_;
+    /// Number of distinct elements stored without heap allocation
+    static constexpr Size INLINE_ELEMENTS_ = 8;
+
+    /// Internal typedef for the used map type (sorted by element, small-buffer optimized)
+    typedef boost::container::flat_map<const Element*, SignedSize, std::less<const Element*>,
+      boost::container::small_vector<std::pair<const Element*, SignedSize>, INLINE_ELEMENTS_> > MapType_;
 
 public:
     /** @name Typedefs
     */
     //@{
-    /// Iterators
+    /// Iterators (all constant: the elements are sorted by their address, which must not be changed)
     typedef MapType_::const_iterator ConstIterator;
     typedef MapType_::const_iterator const_iterator;
-    typedef MapType_::iterator Iterator;
-    typedef MapType_::iterator iterator;
+    typedef MapType_::const_iterator Iterator;
+    typedef MapType_::const_iterator iterator;
     //@}
 
     /** @name Constructors and Destructors
@@ -272,10 +283,6 @@ public:
     inline ConstIterator begin() const { return formula_.begin(); }
 
     inline ConstIterator end() const { return formula_.end(); }
-    
-    inline Iterator begin() { return formula_.begin(); }
-
-    inline Iterator end() { return formula_.end(); }
     //@}
 
 protected:
@@ -287,7 +294,10 @@ protected:
 
     Int charge_;
 
-    Int parseFormula_(std::map<const Element*, SignedSize>& ef, const String& formula) const;
+    Int parseFormula_(MapType_& ef, const String& formula) const;
+
+    /// merges the sorted element counts of @p lhs and @p factor times @p rhs into @p result (omitting zero counts)
+    static void mergeFormulas_(const MapType_& lhs, const MapType_& rhs, SignedSize factor, MapType_& result);
 
   };
 
@@ -0,0 +1,105 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+namespace OpenMS
+{
+  /**
+    @brief Keeps the first exception thrown inside a parallel (OpenMP) region
+
+    Exceptions must not leave an OpenMP region. Wrap the body of the parallel
+    loop in run(), which catches and stores the first exception and skips all
+    remaining iterations once an error occurred, then call rethrow() after
+    the region:
+
+    @code
+    ParallelExceptionCollector errors;
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)data.size(); ++i)
+    {
+      errors.run([&]() { process(data[i]); });
+    }
+    errors.rethrow();
+    @endcode
+  */
+  class ParallelExceptionCollector
+  {
+  public:
+    /// Calls @p f (unless an error occurred before) and stores an exception thrown by it
+    template <typename FunctionT>
+    void run(FunctionT&& f)
+    {
+      if (failed()) return; // no "break" in OpenMP loops
+      try
+      {
+        f();
+      }
+      catch (...)
+      {
+        capture();
+      }
+    }
+
+    /// Stores the exception currently handled (call from a catch block), unless another one was stored before
+    void capture()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+      failed_ = true;
+    }
+
+    /// Whether an exception was stored
+    bool failed() const
+    {
+      return failed_;
+    }
+
+    /// Rethrows the stored exception (if any)
+    void rethrow() const
+    {
+      if (error_) std::rethrow_exception(error_);
+    }
+
+  private:
+    std::exception_ptr error_; ///< first exception
+    std::atomic<bool> failed_{false}; ///< set once an exception was stored
+    std::mutex mutex_; ///< protects error_
+  };
+
+} // namespace OpenMS
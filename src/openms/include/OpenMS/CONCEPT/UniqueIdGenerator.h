@@ -54,6 +54,18 @@ namespace OpenMS
     The class is implemented as a singleton.
     The random generator is implemented using boost::random.
 
+    Outside of OpenMP parallel regions, ids are drawn from a single global
+    random generator, i.e. a given seed always results in the same sequence of ids.
+    Inside of a parallel region, every thread draws from its own generator,
+    which is seeded from the global seed, so no locking is required.
+    By default, these per-thread generators are seeded in the order in which
+    the threads request their first id, so ids generated in parallel regions
+    differ between runs. If reproducible ids are needed, use
+    setReproducibleParallelIds(): the per-thread generators are then tied to
+    the OpenMP thread number and a fixed seed, number of threads and (static)
+    schedule result in identical ids. In this mode, nested parallel regions
+    fall back to the (locked) global generator.
+
     @ingroup Concept
   */
   class OPENMS_DLLAPI UniqueIdGenerator
@@ -70,6 +82,23 @@ public:
     /// Get the seed
     static UInt64 getSeed();
 
+    /**
+      @brief Derives the seed of an independent stream of ids from @p seed (SplitMix64 finalizer)
+
+      Used to seed the per-thread generators. Processes started with the same seed (e.g. the shards of one analysis) can use it to obtain distinct seeds; unlike seed + stream, the derived seeds do not overlap for neighbouring base seeds.
+    */
+    static UInt64 deriveSeed(UInt64 seed, UInt64 stream);
+
+    /**
+      @brief Ties the generators used in parallel regions to the OpenMP thread number (default: false)
+
+      Should be called outside of parallel regions, after the number of threads has been set.
+    */
+    static void setReproducibleParallelIds(bool reproducible);
+
+    /// Are the ids generated in parallel regions reproducible for a fixed seed and number of threads?
+    static bool getReproducibleParallelIds();
+
 protected:
     UniqueIdGenerator();
     ~UniqueIdGenerator();
@@ -79,9 +108,11 @@ private:
     static UniqueIdGenerator* instance_;
     static boost::mt19937_64* rng_;
     static boost::uniform_int<UInt64>* dist_;
+    static bool reproducible_parallel_ids_;
 
     static UniqueIdGenerator& getInstance_();
     void init_();
+    static void seedThreadGenerators_();
     UniqueIdGenerator(const UniqueIdGenerator& );//protect from c++ auto-generation
   };
 
@@ -17,6 +17,7 @@ LogConfigHandler.h
 LogStream.h
 Macros.h
 MacrosTest.h
+ParallelExceptionCollector.h
 PrecisionWrapper.h
 ProgressLogger.h
 RAIICleanup.h
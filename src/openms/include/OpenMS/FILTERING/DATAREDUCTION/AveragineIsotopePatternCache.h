@@ -0,0 +1,124 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+namespace OpenMS
+{
+  /**
+    @brief A thread-safe cache of averagine isotope patterns
+
+    Scoring functions (e.g. the isotope scores of DIAScoring) estimate the
+    isotope pattern of an averagine peptide for every fragment or precursor
+    m/z of every peak group they score, which mostly recomputes the same
+    patterns over and over again.
+
+    Other than IsotopeDistributionCache, which pre-calculates approximate
+    patterns for fixed mass windows, this cache is filled on demand and
+    returns exactly the distribution that
+    CoarseIsotopePatternGenerator(max_isotope).estimateFromPeptideWeight(weight)
+    would return: the averagine model rounds the estimated element counts, so
+    all weights in a mass bin of roughly one hydrogen mass share the same sum
+    formula and thus the same distribution. Patterns are stored per
+    (max_isotope, sum formula), which bounds the size of the cache by the
+    number of distinct mass bins used.
+
+    All functions except clear() may be called from multiple threads at once:
+    look-ups only take a shared lock, storing a new pattern an exclusive one.
+    A single process-wide instance is available through getInstance(); it
+    counts how many patterns were requested and how many of them had to be
+    computed.
+  */
+  class OPENMS_DLLAPI AveragineIsotopePatternCache
+  {
+public:
+
+    /// Default constructor
+    AveragineIsotopePatternCache();
+
+    /// Returns the process-wide instance shared by all scoring classes
+    static AveragineIsotopePatternCache& getInstance();
+
+    /**
+      @brief Returns the averagine isotope distribution of a peptide of the given average weight
+
+      Identical to CoarseIsotopePatternGenerator(max_isotope).estimateFromPeptideWeight(average_weight).
+      The returned reference stays valid until clear() is called; scoring code (DIAScoring, DIAHelper) holds on to it.
+    */
+    const IsotopeDistribution& estimateFromPeptideWeight(double average_weight, Size max_isotope);
+
+    /// Number of patterns requested since construction or the last clear()
+    Size getNrRequests() const;
+
+    /// Number of patterns that had to be computed and stored since construction or the last clear()
+    Size getNrComputed() const;
+
+    /// Number of distinct patterns currently stored
+    Size size() const;
+
+    /**
+      @brief Removes all patterns and resets the counters
+
+      Invalidates all references returned by estimateFromPeptideWeight().
+      Must therefore not be called while any thread is scoring (or otherwise using the cache), e.g. during an OpenSwath run.
+    */
+    void clear();
+
+private:
+
+    /// Not copyable (holds a mutex and atomics)
+    AveragineIsotopePatternCache(const AveragineIsotopePatternCache&) = delete;
+    AveragineIsotopePatternCache& operator=(const AveragineIsotopePatternCache&) = delete;
+
+    typedef std::pair<Size, EmpiricalFormula> KeyType;
+
+    /// Patterns by (max_isotope, sum formula); map nodes keep references stable
+    std::map<KeyType, IsotopeDistribution> patterns_;
+
+    std::atomic<Size> nr_requests_;
+    std::atomic<Size> nr_computed_;
+
+    /// Guards @p patterns_ (shared for look-ups, exclusive for inserts)
+    mutable std::shared_mutex mutex_;
+  };
+}
@@ -100,6 +100,30 @@ class OPENMS_DLLAPI Deisotoper
             bool use_decreasing_model = true,
             unsigned int start_intensity_check = 2,
             bool add_up_intensity = false);
+
+  /** @brief Detect isotopic clusters in all spectra of an experiment.
+
+    Same as the single-spectrum version, applied to every spectrum of @p exp
+    (in parallel, if OpenMP is enabled). The isotope spacings per charge and the
+    positions of the decreasing-model checks are tabulated once for all spectra.
+    Each spectrum must be sorted by m/z.
+
+    @see deisotopeAndSingleCharge(MSSpectrum&, double, bool, int, int, bool, unsigned int, unsigned int, bool, bool, bool, bool, unsigned int, bool)
+  */
+  static void deisotopeAndSingleCharge(PeakMap& exp,
+            double fragment_tolerance,
+            bool fragment_unit_ppm,
+            int min_charge = 1,
+            int max_charge = 3,
+            bool keep_only_deisotoped = false,
+            unsigned int min_isopeaks = 3,
+            unsigned int max_isopeaks = 10,
+            bool make_single_charged = true,
+            bool annotate_charge = false,
+            bool annotate_iso_peak_count = false,
+            bool use_decreasing_model = true,
+            unsigned int start_intensity_check = 2,
+            bool add_up_intensity = false);
 };
 
 }
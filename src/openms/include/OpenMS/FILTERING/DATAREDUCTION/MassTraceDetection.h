@@ -65,6 +65,15 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      With OpenMP, the extension phase runs in parallel: the m/z axis is
+      partitioned into overlapping stripes (with a similar number of apices each),
+      and each stripe extends its apices independently using its own bitmap of
+      used peaks. For each trace, the used flags it consulted are recorded. The
+      traces are then merged in the order of decreasing apex intensity; a trace
+      whose consulted flags differ from the state of the sequential algorithm at
+      this point (which can only happen close to stripe borders) is extended
+      again. Therefore, the result is identical to the single-threaded one.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -110,6 +119,44 @@ namespace OpenMS
           Size peak_idx;
         };
 
+        /// A mass trace extended from a single apex (see extendTrace_)
+        struct TraceCandidate_
+        {
+          /// whether the trace passed the length and quality criteria
+          bool accepted = false;
+          /// the mass trace (without label), only valid if accepted
+          MassTrace trace;
+          /// (scan, peak) indices of the gathered peaks
+          std::vector<std::pair<Size, Size> > gathered_idx;
+          /// global peak indices whose used flag was consulted during the extension, and the flag found
+          std::vector<std::pair<Size, bool> > reads;
+        };
+
+        /**
+          @brief Extends a mass trace from @p apex (if its peak is not used yet) and checks the trace criteria
+
+          @p is_used(scan_idx, peak_idx) reports whether a peak already belongs to another
+          trace. The result only depends on the input data and on the values returned by @p is_used.
+        */
+        template <typename IsUsed>
+        void extendTrace_(const Apex& apex,
+                          const PeakMap& work_exp,
+                          const int fwhm_meta_idx,
+                          IsUsed&& is_used,
+                          TraceCandidate_& candidate);
+
+        /**
+          @brief Speculatively extends all apices in parallel, partitioning the m/z axis into stripes
+
+          @p candidates[i] is the trace of the i-th most intense apex, computed with the used
+          flags of its stripe, and holds the flags it consulted (for validation in run_).
+        */
+        void extendTracesParallel_(const std::vector<Apex>& chrom_apices,
+                                   const PeakMap& work_exp,
+                                   const std::vector<Size>& spec_offsets,
+                                   const int fwhm_meta_idx,
+                                   std::vector<TraceCandidate_>& candidates);
+
         /// The internal run method
         void run_(const std::vector<Apex>& chrom_apices,
                   const Size peak_count,
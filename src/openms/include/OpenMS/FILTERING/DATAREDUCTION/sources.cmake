@@ -3,6 +3,7 @@ set(directory include/OpenMS/FILTERING/DATAREDUCTION)
 
 ### list all header files of the directory here
 set(sources_list_h
+AveragineIsotopePatternCache.h
 DataFilters.h
 Deisotoper.h
 ElutionPeakDetection.h
@@ -0,0 +1,299 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimator.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Estimates the signal/noise (S/N) ratio of each data point in a scan by using the exact median of a sliding window
+
+    Works like SignalToNoiseEstimatorMedian (same window definition,
+    parameters and handling of sparse windows), but the noise is the exact
+    median of the intensities in the window instead of the center of a
+    histogram bin. Therefore, no intensity range or bin count has to be
+    chosen.
+
+    The median is the lower median, i.e. the ceil(n/2)-th smallest of the
+    n intensities in the window (the same element the histogram of
+    SignalToNoiseEstimatorMedian looks for). As in SignalToNoiseEstimatorMedian,
+    the noise is at least 1 (to avoid division by zero).
+
+    The window content is kept in an order-statistic tree (a Fenwick tree
+    over the intensity ranks of the data points), so adding or removing a
+    data point and looking up the median of the window take O(log n) time
+    each. The buffers are kept between calls of init(), so an estimator
+    that is used for many spectra or chromatograms doesn't allocate memory
+    once it has seen the largest one.
+
+    @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>OPENMS_LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
+
+    @htmlinclude OpenMS_SignalToNoiseEstimatorMedianExact.parameters
+
+    @ingroup SignalProcessing
+  */
+  template <typename Container = MSSpectrum>
+  class SignalToNoiseEstimatorMedianExact :
+    public SignalToNoiseEstimator<Container>
+  {
+
+public:
+
+    using SignalToNoiseEstimator<Container>::stn_estimates_;
+    using SignalToNoiseEstimator<Container>::defaults_;
+    using SignalToNoiseEstimator<Container>::param_;
+
+    typedef typename SignalToNoiseEstimator<Container>::PeakIterator PeakIterator;
+    typedef typename SignalToNoiseEstimator<Container>::PeakType PeakType;
+
+    /// default constructor
+    inline SignalToNoiseEstimatorMedianExact()
+    {
+      //set the name for DefaultParamHandler error messages
+      this->setName("SignalToNoiseEstimatorMedianExact");
+
+      defaults_.setValue("win_len", 200.0, "window length in Thomson");
+      defaults_.setMinFloat("win_len", 1.0);
+
+      defaults_.setValue("min_required_elements", 10, "minimum number of elements required in a window (otherwise it is considered sparse)");
+      defaults_.setMinInt("min_required_elements", 1);
+
+      defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
+
+      defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows");
+      defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
+
+      SignalToNoiseEstimator<Container>::defaultsToParam_();
+    }
+
+    /// Copy Constructor
+    inline SignalToNoiseEstimatorMedianExact(const SignalToNoiseEstimatorMedianExact & source) :
+      SignalToNoiseEstimator<Container>(source)
+    {
+      updateMembers_();
+    }
+
+    /** @name Assignment
+     */
+    //@{
+    ///
+    inline SignalToNoiseEstimatorMedianExact & operator=(const SignalToNoiseEstimatorMedianExact & source)
+    {
+      if (&source == this) return *this;
+
+      SignalToNoiseEstimator<Container>::operator=(source);
+      updateMembers_();
+      return *this;
+    }
+
+    //@}
+
+    /// Destructor
+    ~SignalToNoiseEstimatorMedianExact() override
+    {}
+
+    /// Returns how many percent of the windows were sparse
+    double getSparseWindowPercent() const
+    {
+      return sparse_window_percent_;
+    }
+
+protected:
+
+    /** Calculate signal-to-noise values for all data points given, by using a sliding window approach
+
+        @param c Raw data, usually an MSSpectrum
+    */
+    void computeSTN_(const Container& c) override
+    {
+      const Size n = c.size();
+
+      // reset counter for sparse windows
+      sparse_window_percent_ = 0;
+
+      // reset the results
+      stn_estimates_.clear();
+      stn_estimates_.resize(n);
+      if (n == 0) return;
+
+      // rank of every data point by intensity (ties broken by position, so ranks are unique)
+      by_intensity_.resize(n);
+      for (Size i = 0; i < n; ++i)
+      {
+        by_intensity_[i] = i;
+      }
+      std::sort(by_intensity_.begin(), by_intensity_.end(), [&c](Size a, Size b)
+      {
+        return (c[a].getIntensity() < c[b].getIntensity()) || ((c[a].getIntensity() == c[b].getIntensity()) && (a < b));
+      });
+      rank_.resize(n);
+      for (Size r = 0; r < n; ++r)
+      {
+        rank_[by_intensity_[r]] = r;
+      }
+
+      // Fenwick tree over the ranks: counts the data points in the window
+      tree_.assign(n + 1, 0);
+      Size highest_bit = 1;
+      while (highest_bit * 2 <= n) highest_bit *= 2;
+
+      PeakIterator scan_first_ = c.begin();
+      PeakIterator scan_last_ = c.end();
+      PeakIterator window_pos_center = scan_first_;
+      PeakIterator window_pos_borderleft = scan_first_;
+      PeakIterator window_pos_borderright = scan_first_;
+      Size left = 0, right = 0; // indices of the window borders
+
+      double window_half_size = win_len_ / 2;
+      // tracks elements in current window, which may vary because of unevenly spaced data
+      int elements_in_window = 0;
+      // number of windows
+      Size window_count = 0;
+      double noise; // noise value of a datapoint
+
+      ///start progress estimation
+      SignalToNoiseEstimator<Container>::startProgress(0, n, "noise estimation of data");
+
+      // MAIN LOOP
+      while (window_pos_center != scan_last_)
+      {
+        // remove all elements that will leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() < (*window_pos_center).getMZ() - window_half_size)
+        {
+          for (Size k = rank_[left] + 1; k <= n; k += k & (~k + 1)) --tree_[k];
+          --elements_in_window;
+          ++window_pos_borderleft;
+          ++left;
+        }
+
+        // add all elements that will enter the window on the RIGHT side
+        while ((window_pos_borderright != scan_last_)
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          for (Size k = rank_[right] + 1; k <= n; k += k & (~k + 1)) ++tree_[k];
+          ++elements_in_window;
+          ++window_pos_borderright;
+          ++right;
+        }
+
+        if (elements_in_window < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          // find the smallest rank r with ceil[elements_in_window/2] elements of rank <= r in the window
+          int remaining = (elements_in_window + 1) / 2;
+          Size pos = 0;
+          for (Size step = highest_bit; step > 0; step /= 2)
+          {
+            if ((pos + step <= n) && (tree_[pos + step] < remaining))
+            {
+              pos += step;
+              remaining -= tree_[pos];
+            }
+          }
+          // just avoid division by 0
+          noise = std::max(1.0, (double)c[by_intensity_[pos]].getIntensity());
+        }
+
+        // store result
+        stn_estimates_[window_count] = (*window_pos_center).getIntensity() / noise;
+
+        // advance the window center by one datapoint
+        ++window_pos_center;
+        ++window_count;
+        // update progress
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+      } // end while
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
+
+      // warn if percentage of sparse windows is above 20%
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedianExact: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
+    /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
+    void updateMembers_() override
+    {
+      win_len_                 = (double)param_.getValue("win_len");
+      min_required_elements_   = param_.getValue("min_required_elements");
+      noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
+      write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      stn_estimates_.clear();
+    }
+
+    /// range of data points which belong to a window in Thomson
+    double win_len_;
+    /// minimal number of elements a window needs to cover to be used
+    int min_required_elements_;
+    /// used as noise value for windows which cover less than "min_required_elements_"
+    /// use a very high value if you want to get a low S/N result
+    double noise_for_empty_window_;
+
+    // whether to write out log messages in the case of failure
+    bool write_log_messages_;
+
+    // counter for sparse windows
+    double sparse_window_percent_;
+
+    /// @name Workspace (kept between calls to avoid reallocation)
+    //@{
+    /// indices of the data points, sorted by intensity
+    std::vector<Size> by_intensity_;
+    /// rank of each data point in @p by_intensity_
+    std::vector<Size> rank_;
+    /// Fenwick tree (1-based) counting the data points of the window per rank
+    std::vector<int> tree_;
+    //@}
+  };
+
+} // namespace OpenMS
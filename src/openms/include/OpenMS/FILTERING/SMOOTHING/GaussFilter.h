@@ -86,134 +86,72 @@ public:
         @brief Smoothes an MSSpectrum containing profile data.
 
         Convolutes the filter and the profile data and writes the result back to the spectrum.
+        This function is thread-safe, i.e. different spectra can be smoothed concurrently.
 
         @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
       */
-    void filter(MSSpectrum & spectrum)
-    {
-      typedef std::vector<double> ContainerT;
-
-      // make sure the right data type is set
-      spectrum.setType(SpectrumSettings::PROFILE);
-      bool found_signal = false;
-      const Size data_size = spectrum.size();
-      ContainerT mz_in(data_size), int_in(data_size), mz_out(data_size), int_out(data_size);
-
-      // copy spectrum to container
-      for (Size p = 0; p < spectrum.size(); ++p)
-      {
-        mz_in[p] = spectrum[p].getMZ();
-        int_in[p] = static_cast<double>(spectrum[p].getIntensity());
-      }
+    void filter(MSSpectrum & spectrum);
 
-      // apply filter
-      ContainerT::iterator mz_out_it = mz_out.begin();
-      ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(mz_in.begin(), mz_in.end(), int_in.begin(), mz_out_it, int_out_it);
+      /**
+        @brief Smoothes an MSChromatogram.
 
-      // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
-      // This is the case if the Gaussian filter is smaller than the spacing of raw data
-      if (!found_signal && spectrum.size() >= 3)
-      {
-        String error_message = "Found no signal. The Gaussian width is probably smaller than the spacing in your profile data. Try to use a bigger width.";
-        if (spectrum.getRT() > 0.0)
-        {
-          error_message += String(" The error occurred in the spectrum with retention time ") + spectrum.getRT() + ".";
-        }
-        OPENMS_LOG_ERROR << error_message << std::endl;
-      }
-      else
-      {
-        // copy the new data into the spectrum
-        ContainerT::iterator mz_it = mz_out.begin();
-        ContainerT::iterator int_it = int_out.begin();
-        for (Size p = 0; mz_it != mz_out.end(); mz_it++, int_it++, p++)
-        {
-          spectrum[p].setIntensity(*int_it);
-          spectrum[p].setMZ(*mz_it);
-        }
-      }
-    }
+        @exception Exception::IllegalArgument is thrown, if @em use_ppm_tolerance is set.
+      */
+    void filter(MSChromatogram & chromatogram);
 
-    void filter(MSChromatogram & chromatogram)
-    {
-      typedef std::vector<double> ContainerT;
+    /**
+      @brief Smoothes an MSExperiment containing profile data.
 
-      if (param_.getValue("use_ppm_tolerance").toBool())
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          "GaussFilter: Cannot use ppm tolerance on chromatograms");
-      }
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
 
-      bool found_signal = false;
-      const Size data_size = chromatogram.size();
-      ContainerT rt_in(data_size), int_in(data_size), rt_out(data_size), int_out(data_size);
+      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
+    */
+    void filterExperiment(PeakMap & map);
 
-      // copy spectrum to container
-      for (Size p = 0; p < chromatogram.size(); ++p)
-      {
-        rt_in[p] = chromatogram[p].getRT();
-        int_in[p] = chromatogram[p].getIntensity();
-      }
+protected:
 
-      // apply filter
-      ContainerT::iterator mz_out_it = rt_out.begin();
-      ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(rt_in.begin(), rt_in.end(), int_in.begin(), mz_out_it, int_out_it);
+    /// Input and output buffers of the filter
+    struct Workspace_
+    {
+      std::vector<double> pos_in;
+      std::vector<double> int_in;
+      std::vector<double> pos_out;
+      std::vector<double> int_out;
 
-      // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
-      // This is the case if the Gaussian filter is smaller than the spacing of raw data
-      if (!found_signal && chromatogram.size() >= 3)
+      /// Resizes all buffers (keeps their capacity)
+      void resize(Size size)
       {
-        String error_message = "Found no signal. The Gaussian width is probably smaller than the spacing in your chromatogram data. Try to use a bigger width.";
-        if (chromatogram.getMZ() > 0.0)
-        {
-          error_message += String(" The error occurred in the chromatogram with m/z time ") + chromatogram.getMZ() + ".";
-        }
-        OPENMS_LOG_ERROR << error_message << std::endl;
+        pos_in.resize(size);
+        int_in.resize(size);
+        pos_out.resize(size);
+        int_out.resize(size);
       }
-      else
-      {
-        // copy the new data into the spectrum
-        ContainerT::iterator mz_it = rt_out.begin();
-        ContainerT::iterator int_it = int_out.begin();
-        for (Size p = 0; mz_it != rt_out.end(); mz_it++, int_it++, p++)
-        {
-          chromatogram[p].setIntensity(*int_it);
-          chromatogram[p].setMZ(*mz_it);
-        }
-      }
-    }
+    };
 
-    /**
-      @brief Smoothes an MSExperiment containing profile data.
+    /// Returns the buffers of the calling thread
+    static Workspace_& threadWorkspace_();
 
-      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
-    */
-    void filterExperiment(PeakMap & map)
+    /// Applies the filter to the input buffers of @p ws
+    bool filterData_(Workspace_& ws)
     {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
+      if (!use_ppm_tolerance_)
       {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
+        // the algorithm doesn't change its state, so it can be shared between threads
+        return gauss_algo_.filter(ws.pos_in.begin(), ws.pos_in.end(), ws.int_in.begin(), ws.pos_out.begin(), ws.int_out.begin());
       }
-      endProgress();
+      // the kernel is re-initialized at every data point, so every call needs its own copy
+      GaussFilterAlgorithm algo = gauss_algo_;
+      return algo.filter(ws.pos_in.begin(), ws.pos_in.end(), ws.int_in.begin(), ws.pos_out.begin(), ws.int_out.begin());
     }
 
-protected:
-
     GaussFilterAlgorithm gauss_algo_;
 
     /// The spacing of the pre-tabulated kernel coefficients
     double spacing_;
 
+    /// Is the kernel width given in ppm (i.e. computed anew at every data point)?
+    bool use_ppm_tolerance_;
+
     // Docu in base class
     void updateMembers_() override;
   };
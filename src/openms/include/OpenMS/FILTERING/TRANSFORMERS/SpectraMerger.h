@@ -755,8 +755,7 @@ protected:
         }
 
         // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
-        average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
+        typename MapType::SpectrumType average_spec = copyWithoutPeaks_(exp[it->first]);
         //average_spec.setMSLevel(ms_level);
 
         // refill spectrum
@@ -873,8 +872,7 @@ protected:
         }
 
         // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
-        average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
+        typename MapType::SpectrumType average_spec = copyWithoutPeaks_(exp[it->first]);
         //average_spec.setMSLevel(ms_level);
 
         // refill spectrum
@@ -903,6 +901,24 @@ protected:
 
     }
 
+    /**
+     * @brief copies a spectrum without its peaks
+     *
+     * Precursors are part of the meta data and are kept. The peaks are shared
+     * (see MSSpectrum::setCopyOnWrite()) instead of being copied and cleared.
+     */
+    template <typename SpectrumType>
+    static SpectrumType copyWithoutPeaks_(SpectrumType& spectrum)
+    {
+      const bool cow = spectrum.isCopyOnWrite();
+      spectrum.setCopyOnWrite(true);
+      SpectrumType copy = spectrum;
+      copy.clear(false);
+      spectrum.setCopyOnWrite(cow);
+      copy.setCopyOnWrite(cow);
+      return copy;
+    }
+
     /**
      * @brief comparator for sorting peaks (m/z, intensity)
      */
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+    /**
+      @brief Transforming consumer of MS data which processes batches of spectra/chromatograms in parallel
+
+      Works like MSDataTransformingConsumer, but collects the consumed
+      spectra/chromatograms in batches, applies the processing functions to
+      all members of a batch in parallel (if OpenMP is enabled) and passes the
+      results to the next consumer (see Constructor) in the order in which
+      they were consumed. This allows e.g. to smooth or pick files larger
+      than the available memory on all cores:
+
+      @code
+      PlainMSDataWritingConsumer writer(out_file);
+      MSDataParallelTransformingConsumer parallel_consumer(&writer);
+      parallel_consumer.setSpectraProcessingFunc([&filter](MSSpectrum& s) { filter.filter(s); });
+      MzMLFile().transform(in_file, &parallel_consumer);
+      parallel_consumer.flush();
+      @endcode
+
+      @note The processing functions are called concurrently, so they must
+      be thread-safe.
+
+      @note Consumed spectra/chromatograms are copied (and left unchanged),
+      since they are only processed once the batch is complete.
+    */
+    class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+      public MSDataTransformingConsumer
+    {
+
+    public:
+
+      /**
+        @brief Constructor
+
+        @param next_consumer Consumer which receives the processed data
+        @param batch_size Number of spectra/chromatograms processed at once (0: 16 per thread)
+
+        @note This does not transfer ownership of the consumer
+      */
+      explicit MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0);
+
+      /**
+        @brief Destructor
+
+        Flushes data to next consumer (exceptions thrown by the processing
+        functions are logged, call flush() to receive them)
+
+        @note It is essential to not delete the underlying next_consumer before
+        deleting this object, otherwise we risk a memory error
+      */
+      ~MSDataParallelTransformingConsumer() override;
+
+      /// passed on to the next consumer
+      void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+      /// calls the experimental settings function (if set) and passes the settings on to the next consumer
+      void setExperimentalSettings(const ExperimentalSettings& es) override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      void consumeChromatogram(ChromatogramType& c) override;
+
+      /**
+        @brief Processes all pending spectra/chromatograms and passes them to the next consumer
+
+        Call this after the last spectrum/chromatogram was consumed.
+
+        @exception Any exception thrown by the processing functions (the pending data is discarded in that case)
+      */
+      void flush();
+
+    protected:
+      /// Processes the pending spectra in parallel and passes them to the next consumer
+      void processSpectra_();
+
+      /// Processes the pending chromatograms in parallel and passes them to the next consumer
+      void processChromatograms_();
+
+      Interfaces::IMSDataConsumer* next_consumer_;
+      Size batch_size_;
+      std::vector<SpectrumType> spectra_;
+      std::vector<ChromatogramType> chromatograms_;
+    };
+
+} //end namespace OpenMS
+
@@ -44,6 +44,8 @@
 
 #include <set>
 
+#include <boost/container/flat_set.hpp>
+
 namespace OpenMS
 {
   class FeatureMap;
@@ -62,6 +64,11 @@ namespace OpenMS
     FeatureHandle instances.  Each ConsensusFeature "contains" zero or more
     FeatureHandles.
 
+    The feature handles are stored in a sorted vector (ordered by map index and
+    unique id, see FeatureHandle::IndexLess), which keeps iteration cache-friendly
+    and avoids one allocation per handle. As with any vector, inserting handles
+    invalidates iterators and references to the contained handles.
+
     @see ConsensusMap
 
     @ingroup Kernel
@@ -72,7 +79,7 @@ namespace OpenMS
 public:
     ///Type definitions
     //@{
-    typedef std::set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
+    typedef boost::container::flat_set<FeatureHandle, FeatureHandle::IndexLess> HandleSetType;
     typedef HandleSetType::const_iterator const_iterator;
     typedef HandleSetType::iterator iterator;
     typedef HandleSetType::const_reverse_iterator const_reverse_iterator;
@@ -211,6 +211,17 @@ public:
       chromatograms_.push_back(chromatogram);
     }
 
+    inline void addChromatogram(ChromatogramType&& chromatogram, const String& key)
+    {
+      // store the index where to find the chromatogram, using the key for lookup
+      auto result = chromatogram_map_.emplace(key, int(chromatograms_.size()));
+      if (!result.second) // ouch: key was already used
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Internal error: Chromatogram with nativeID was already present!", key);
+      }
+      chromatograms_.push_back(std::move(chromatogram));
+    }
+
     inline bool hasChromatogram(const String& key) const
     {
       return chromatogram_map_.find(key) != chromatogram_map_.end();
@@ -264,6 +275,17 @@ public:
       precursor_chromatograms_.push_back(chromatogram);
     }
 
+    inline void addPrecursorChromatogram(ChromatogramType&& chromatogram, const String& key)
+    {
+      // store the index where to find the chromatogram, using the key for lookup
+      auto result = precursor_chromatogram_map_.emplace(key, int(precursor_chromatograms_.size()));
+      if (!result.second) // ouch: key was already used
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Internal error: Chromatogram with nativeID was already present!", key);
+      }
+      precursor_chromatograms_.push_back(std::move(chromatogram));
+    }
+
     inline bool hasPrecursorChromatogram(const String& key) const
     {
       return precursor_chromatogram_map_.find(key) != precursor_chromatogram_map_.end();
@@ -42,6 +42,9 @@
 #include <OpenMS/METADATA/DataArrays.h>
 #include <OpenMS/METADATA/MetaInfoDescription.h>
 
+#include <initializer_list>
+#include <memory>
+
 namespace OpenMS
 {
   class Peak1D;
@@ -60,6 +63,8 @@ namespace OpenMS
     spectrum. The precursor spectrum is the first spectrum in MSExperiment, that has a lower
     MS-level than the current spectrum.
 
+    Copies of a spectrum can optionally share their peaks and data arrays until one of them is modified (see @ref setCopyOnWrite()).
+
     @note For range operations, see \ref RangeUtils "RangeUtils module"!
 
     @ingroup Kernel
@@ -132,26 +137,8 @@ public:
     typedef typename ContainerType::const_reverse_iterator ConstReverseIterator;
     //@}
 
-    ///@name Export methods from std::vector<Peak1D>
+    ///@name Export types from std::vector<Peak1D>
     //@{
-    using ContainerType::operator[];
-    using ContainerType::begin;
-    using ContainerType::rbegin;
-    using ContainerType::end;
-    using ContainerType::rend;
-    using ContainerType::resize;
-    using ContainerType::size;
-    using ContainerType::push_back;
-    using ContainerType::emplace_back;
-    using ContainerType::pop_back;
-    using ContainerType::empty;
-    using ContainerType::front;
-    using ContainerType::back;
-    using ContainerType::reserve;
-    using ContainerType::insert;
-    using ContainerType::erase;
-    using ContainerType::swap;
-
     using typename ContainerType::iterator;
     using typename ContainerType::const_iterator;
     using typename ContainerType::size_type;
@@ -164,6 +151,77 @@ public:
     typedef Precursor::DriftTimeUnit DriftTimeUnit;
     //@}
 
+    ///@name Export methods from std::vector<Peak1D>
+    ///
+    /// Non-const methods detach the peaks from other spectra sharing them (see @ref setCopyOnWrite()).
+    //@{
+    reference operator[](size_type n) { return mutablePeakContainer_()[n]; }
+    const_reference operator[](size_type n) const { return peakContainer_()[n]; }
+    iterator begin() { return mutablePeakContainer_().begin(); }
+    const_iterator begin() const { return peakContainer_().begin(); }
+    const_iterator cbegin() const { return peakContainer_().cbegin(); }
+    ReverseIterator rbegin() { return mutablePeakContainer_().rbegin(); }
+    ConstReverseIterator rbegin() const { return peakContainer_().rbegin(); }
+    iterator end() { return mutablePeakContainer_().end(); }
+    const_iterator end() const { return peakContainer_().end(); }
+    const_iterator cend() const { return peakContainer_().cend(); }
+    ReverseIterator rend() { return mutablePeakContainer_().rend(); }
+    ConstReverseIterator rend() const { return peakContainer_().rend(); }
+    void resize(size_type n) { mutablePeakContainer_().resize(n); }
+    void resize(size_type n, const value_type& value) { mutablePeakContainer_().resize(n, value); }
+    size_type size() const { return peakContainer_().size(); }
+    void push_back(const value_type& value) { mutablePeakContainer_().push_back(value); }
+    void push_back(value_type&& value) { mutablePeakContainer_().push_back(std::move(value)); }
+    template <class... Args>
+    reference emplace_back(Args&&... args) { return mutablePeakContainer_().emplace_back(std::forward<Args>(args)...); }
+    void pop_back() { mutablePeakContainer_().pop_back(); }
+    bool empty() const { return peakContainer_().empty(); }
+    reference front() { return mutablePeakContainer_().front(); }
+    const_reference front() const { return peakContainer_().front(); }
+    reference back() { return mutablePeakContainer_().back(); }
+    const_reference back() const { return peakContainer_().back(); }
+    void reserve(size_type n) { mutablePeakContainer_().reserve(n); }
+    // positions are converted to offsets, as detaching may move the peaks:
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().insert(mutablePeakContainer_().begin() + offset, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().insert(mutablePeakContainer_().begin() + offset, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type count, const value_type& value)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().insert(mutablePeakContainer_().begin() + offset, count, value);
+    }
+    template <class InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().insert(mutablePeakContainer_().begin() + offset, first, last);
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().insert(mutablePeakContainer_().begin() + offset, ilist);
+    }
+    iterator erase(const_iterator pos)
+    {
+      difference_type offset = pos - peakContainer_().begin();
+      return mutablePeakContainer_().erase(mutablePeakContainer_().begin() + offset);
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      difference_type offset = first - peakContainer_().begin(), count = last - first;
+      iterator new_first = mutablePeakContainer_().begin() + offset;
+      return mutablePeakContainer_().erase(new_first, new_first + count);
+    }
+    void swap(ContainerType& other) { mutablePeakContainer_().swap(other); }
+    //@}
+
 
     /// Constructor
     MSSpectrum();
@@ -267,10 +325,7 @@ public:
     const FloatDataArrays& getFloatDataArrays() const;
 
     /// Returns a mutable reference to the float meta data arrays
-    FloatDataArrays& getFloatDataArrays()
-    {
-      return float_data_arrays_;
-    }
+    FloatDataArrays& getFloatDataArrays();
 
     /// Sets the float meta data arrays
     void setFloatDataArrays(const FloatDataArrays& fda);
@@ -294,6 +349,32 @@ public:
     void setIntegerDataArrays(const IntegerDataArrays& ida);
     //@}
 
+    ///@name Copy-on-write storage
+    //@{
+    /**
+      @brief Enables or disables copy-on-write storage of peaks and data arrays
+
+      With copy-on-write enabled, copies of this spectrum share the peak container and the data arrays with it,
+      so copying costs only as much as copying the meta data. Copies inherit the setting.
+      The first non-const access to the peaks (e.g. non-const iterators, operator[], push_back) or to the data arrays
+      gives a spectrum its own copy of the respective data, so the sharing is not observable otherwise.
+
+      This is useful if spectra are copied only to change their meta data or to be read by a filter.
+
+      @note Iterators and references into a spectrum that shares its data with other copies become invalid when that data is modified.
+      Do not copy a spectrum while iterating over it with non-const iterators.
+
+      @note The default is off, i.e. every copy owns its data.
+    */
+    void setCopyOnWrite(bool cow);
+
+    /// Is copy-on-write storage enabled (see @ref setCopyOnWrite())?
+    bool isCopyOnWrite() const;
+
+    /// Does this spectrum currently share its peaks or data arrays with another spectrum (see @ref setCopyOnWrite())?
+    bool isShared() const;
+    //@}
+
     ///@name Sorting peaks
     //@{
     /**
@@ -575,6 +656,46 @@ protected:
 
     /// Integer data arrays
     IntegerDataArrays integer_data_arrays_;
+
+    /// Data arrays of a spectrum with copy-on-write storage
+    struct SharedDataArrays_
+    {
+      FloatDataArrays float_data_arrays;
+      StringDataArrays string_data_arrays;
+      IntegerDataArrays integer_data_arrays;
+    };
+
+    /// Peaks if copy-on-write storage is enabled (the base class container is empty then)
+    std::shared_ptr<ContainerType> shared_peaks_;
+
+    /// Data arrays if copy-on-write storage is enabled (the data array members are empty then)
+    std::shared_ptr<SharedDataArrays_> shared_data_arrays_;
+
+    /// Returns the peak container for reading
+    const ContainerType& peakContainer_() const
+    {
+      return shared_peaks_ ? *shared_peaks_ : static_cast<const ContainerType&>(*this);
+    }
+
+    /// Returns the peak container for writing (copying shared peaks first)
+    ContainerType& mutablePeakContainer_()
+    {
+      if (!shared_peaks_) return *this;
+      if (shared_peaks_.use_count() > 1)
+      {
+        shared_peaks_ = std::make_shared<ContainerType>(*shared_peaks_);
+      }
+      return *shared_peaks_;
+    }
+
+    /// Replaces the peaks (without copying shared peaks first)
+    void setPeakContainer_(ContainerType&& peaks);
+
+    /// Gives the spectrum its own data arrays, so they can be modified (shared arrays of the kinds not to copy are left empty)
+    void detachDataArrays_(bool copy_float = true, bool copy_string = true, bool copy_integer = true);
+
+    /// Are there any data arrays?
+    bool hasDataArrays_() const;
   };
 
   inline std::ostream& operator<<(std::ostream& os, const MSSpectrum& spec)
@@ -61,6 +61,13 @@ namespace OpenMS
 
 public:
 
+    /**
+     * @brief default constructor, creating an empty spline
+     *
+     * The spline must be initialized via init() before it is evaluated.
+     */
+    CubicSpline2d();
+
     /**
      * @brief constructor of spline interpolation
      *
@@ -80,6 +87,18 @@ public:
      */
     CubicSpline2d(const std::map<double, double>& m);
 
+    /**
+     * @brief (re-)initializes the spline with new data points
+     *
+     * Same requirements as for the constructor. Memory of a previous
+     * initialization is reused, so interpolating many small data sets (e.g.
+     * peaks) with the same object does not allocate.
+     *
+     * @param x x-coordinates of input data points (knots)
+     * @param y y-coordinates of input data points
+     */
+    void init(const std::vector<double>& x, const std::vector<double>& y);
+
     /**
      * @brief evaluates the spline at position x
      *
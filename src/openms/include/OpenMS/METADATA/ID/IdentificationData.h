@@ -84,6 +84,10 @@ namespace OpenMS
     This means only one item of such a type with a given key can be stored in an IdentificationData object.
     If items with an existing key are registered subsequently, attempts are made to merge new information (e.g. additional scores) into the existing entry.
 
+    When large amounts of data are imported (e.g. conversion of legacy identification data), capacity for the look-up tables used to check references can be reserved in advance using @ref reserve().
+    The containers themselves keep their ordered indices (iteration in key order is relied upon, e.g. when writing output), and references are always checked on registration.
+    Merging of whole IdentificationData objects is not provided.
+
     @ingroup Metadata
   */
   class OPENMS_DLLAPI IdentificationData: public MetaInfoInterface
@@ -380,6 +384,21 @@ namespace OpenMS
       return query_match_groups_;
     }
 
+    /*!
+      @brief Reserve capacity for the expected numbers of elements
+
+      Avoids repeated reallocation of the look-up tables when many elements are registered.
+      The numbers should be the expected numbers of distinct elements; pass 0 where they are not known.
+
+      @param queries Number of data queries
+      @param parents Number of parent molecules
+      @param molecules Number of identified molecules (of type @p molecule_type)
+      @param matches Number of molecule-query matches
+      @param molecule_type Type of the identified molecules
+    */
+    void reserve(Size queries, Size parents, Size molecules, Size matches,
+                 MoleculeType molecule_type = MoleculeType::PROTEIN);
+
     /// Add a score to a molecule-query match (e.g. PSM)
     void addScore(QueryMatchRef match_ref, ScoreTypeRef score_ref,
                   double value);
@@ -83,6 +83,12 @@ namespace OpenMS
                               Feature& feature, double region_start,
                               double region_end, bool asymmetric,
                               double area_limit, double check_boundaries);
+
+    /// Helper function to collect the mass traces of a feature and fit a model to them (@p peaks is reused working memory)
+    void fitFeature_(TraceFitter* fitter, Feature& feature,
+                     std::vector<Peak1D>& peaks, double add_zeros,
+                     bool each_trace, bool asymmetric, double area_limit,
+                     double check_boundaries);
   };
 }
 
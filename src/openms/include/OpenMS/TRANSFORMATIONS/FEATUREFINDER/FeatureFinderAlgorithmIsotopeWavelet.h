@@ -36,6 +36,8 @@
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
 
+#include <memory>
+
 namespace OpenMS
 {
   /**
@@ -56,6 +58,9 @@ namespace OpenMS
 
     @ingroup FeatureFinder
   */
+  template <typename PeakType>
+  class IsotopeWaveletTransform;
+
   class OPENMS_DLLAPI FeatureFinderAlgorithmIsotopeWavelet :
     public FeatureFinderAlgorithm
   {
@@ -70,6 +75,9 @@ public:
     /** @brief Destructor. */
     ~FeatureFinderAlgorithmIsotopeWavelet() override;
 
+    /** @brief Interpolates scan @p i with zeros (high-resolution data).
+        *
+        * @throw Exception::IllegalArgument if the scan is empty or cannot be interpolated */
     MSSpectrum* createHRData(const UInt i);
 
     /** @brief The working horse of this class. */
@@ -93,6 +101,13 @@ protected:
 
     typedef std::map<UInt, BoxElement> Box; ///<Key: RT (index), value: BoxElement
 
+    /** @brief The wavelet transforms of a single scan (one per charge state). */
+    struct TransformedScan_
+    {
+      std::unique_ptr<MSSpectrum> hr_ref; ///<The interpolated scan (high-resolution data only)
+      std::vector<MSSpectrum> trans; ///<The transforms; empty if the scan could not be transformed
+    };
+
     UInt max_charge_; ///<The maximal charge state we will consider
     double intensity_threshold_; ///<The only parameter of the isotope wavelet
     UInt RT_votes_cutoff_, real_RT_votes_cutoff_, RT_interleave_; ///<The number of subsequent scans a pattern must cover in order to be considered as signal
@@ -104,6 +119,11 @@ protected:
 
     void updateMembers_() override;
 
+    /** @brief Computes the transforms of scan @p i for all charge states.
+        *
+        * Only touches @p iwt and @p scan, s.t. several scans can be transformed in parallel. */
+    void transformScan_(const Size i, IsotopeWaveletTransform<PeakType>& iwt, TransformedScan_& scan);
+
   };
 
 } //namespace
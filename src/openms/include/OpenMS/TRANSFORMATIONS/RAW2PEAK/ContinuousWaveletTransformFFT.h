@@ -0,0 +1,216 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransform.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenMS
+{
+  /**
+    @brief This class computes the continuous wavelet transformation using a marr wavelet and the FFT.
+
+    The profile data are linearly interpolated onto an equally spaced grid and
+    convolved with the sampled wavelet via the fast Fourier transform. The
+    transform at the requested positions is then interpolated from the grid.
+    This takes O(m log m) time for a grid of m points, independent of the
+    scale, whereas ContinuousWaveletTransformNumIntegration needs time
+    proportional to the number of data points times the number of data points
+    covered by the wavelet.
+
+    The grid spacing is the median spacing of the input data, but not smaller
+    than the spacing given to init(). Both transforms approximate the same
+    integral and yield very similar (but not identical) values.
+  */
+  class OPENMS_DLLAPI ContinuousWaveletTransformFFT :
+    public ContinuousWaveletTransform
+  {
+public:
+    /// Profile data const iterator type
+    typedef ContinuousWaveletTransform::PeakConstIterator PeakConstIterator;
+
+    using ContinuousWaveletTransform::signal_;
+    using ContinuousWaveletTransform::wavelet_;
+    using ContinuousWaveletTransform::scale_;
+    using ContinuousWaveletTransform::spacing_;
+    using ContinuousWaveletTransform::end_left_padding_;
+    using ContinuousWaveletTransform::begin_right_padding_;
+    using ContinuousWaveletTransform::signal_length_;
+
+    /// Constructor
+    ContinuousWaveletTransformFFT() :
+      ContinuousWaveletTransform(),
+      origin_(0),
+      grid_spacing_(0)
+    {}
+
+    /// Destructor.
+    ~ContinuousWaveletTransformFFT() override {}
+
+    /**
+        @brief Computes the wavelet transform of a given profile data interval [begin_input,end_input)
+
+        - Resolution = 1: the wavelet transform will be computed at every position of the Profile data,
+        - Resolution = 2: the wavelet transform will be computed at 2x(number of Profile data positions) equally spaced positions
+        .
+
+        @note The InputPeakIterator should point to a Peak1D or a class derived from Peak1D.
+
+        @note Before starting the transformation you have to call the init function
+    */
+    template <typename InputPeakIterator>
+    void transform(InputPeakIterator begin_input,
+                   InputPeakIterator end_input,
+                   float resolution)
+    {
+      SignedSize n = distance(begin_input, end_input);
+      signal_.clear();
+      if (n <= 0)
+      {
+        signal_length_ = 0;
+        begin_right_padding_ = 0;
+        end_left_padding_ = -1;
+        return;
+      }
+
+      // the grid is as fine as the typical spacing of the data
+      grid_spacing_ = spacing_;
+      if (n > 1)
+      {
+        spacings_.clear();
+        for (InputPeakIterator it = begin_input + 1; it != end_input; ++it)
+        {
+          spacings_.push_back(it->getMZ() - (it - 1)->getMZ());
+        }
+        std::nth_element(spacings_.begin(), spacings_.begin() + spacings_.size() / 2, spacings_.end());
+        grid_spacing_ = std::max(spacing_, spacings_[spacings_.size() / 2]);
+      }
+
+      // interpolate the profile data onto the grid
+      origin_ = begin_input->getMZ();
+      Size grid_size = (Size)floor(((end_input - 1)->getMZ() - origin_) / grid_spacing_) + 1;
+      grid_.resize(grid_size);
+      InputPeakIterator it_help = begin_input;
+      for (Size k = 0; k < grid_size; ++k)
+      {
+        double x = origin_ + k * grid_spacing_;
+        // go to the real data point next to x
+        while (((it_help + 1) < end_input) && ((it_help + 1)->getMZ() < x))
+        {
+          ++it_help;
+        }
+        if (((it_help + 1) < end_input) && ((it_help + 1)->getMZ() > it_help->getMZ()))
+        {
+          grid_[k] = getInterpolatedValue_(x, it_help);
+        }
+        else
+        {
+          grid_[k] = it_help->getIntensity();
+        }
+      }
+
+      convolve_();
+
+      if (fabs(resolution - 1) < 0.0001)
+      {
+        signal_length_ = n;
+        signal_.resize(n);
+        InputPeakIterator help = begin_input;
+        for (SignedSize i = 0; i < n; ++i, ++help)
+        {
+          signal_[i].setMZ(help->getMZ());
+          signal_[i].setIntensity((Peak1D::IntensityType)gridValue_(help->getMZ()));
+        }
+      }
+      else
+      {
+        n = SignedSize(resolution * n);
+        double spacing = (n > 1) ? ((end_input - 1)->getMZ() - origin_) / (n - 1) : 0.0;
+        signal_.resize(n);
+        for (SignedSize i = 0; i < n; ++i)
+        {
+          signal_[i].setMZ(origin_ + i * spacing);
+          signal_[i].setIntensity((Peak1D::IntensityType)gridValue_(origin_ + i * spacing));
+        }
+      }
+      // no zeropadding
+      begin_right_padding_ = n;
+      end_left_padding_ = -1;
+    }
+
+    /**
+        @brief Perform necessary preprocessing steps like tabulating the Wavelet.
+
+        Tabulates the Marr-Wavelet for the current spacing and scale in wavelet_
+        (up to 5*scale, like ContinuousWaveletTransformNumIntegration). The
+        convolution kernel itself is sampled at the grid spacing in transform().
+    */
+    void init(double scale, double spacing) override;
+
+protected:
+
+    /// Convolves grid_ in place with the wavelet sampled at grid_spacing_
+    void convolve_();
+
+    /// Linear interpolation of the transformed grid at position @p x
+    inline double gridValue_(double x) const
+    {
+      double pos = (x - origin_) / grid_spacing_;
+      if (pos <= 0) return grid_.front();
+      Size k = (Size)pos;
+      if (k + 1 >= grid_.size()) return grid_.back();
+      double d = pos - k;
+      return grid_[k] * (1 - d) + grid_[k + 1] * d;
+    }
+
+    /// Computes the Marr wavelet at position x
+    inline double marr_(const double x) const
+    {
+      return (1 - x * x) * exp(-x * x / 2);
+    }
+
+    /// Position of the first grid point
+    double origin_;
+    /// Spacing of the grid
+    double grid_spacing_;
+    /// Equally spaced profile data, transformed in place by convolve_()
+    std::vector<double> grid_;
+    /// Buffer for the spacings of the input data
+    std::vector<double> spacings_;
+  };
+} //namespace OpenMS
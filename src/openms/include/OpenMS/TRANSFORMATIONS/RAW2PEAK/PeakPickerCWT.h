@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/OptimizePeakDeconvolution.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransform.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformFFT.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformNumIntegration.h>
 
 //#define DEBUG_PEAK_PICKING
@@ -154,6 +155,9 @@ protected:
     /// Switch for the 2D optimization of peak parameters
     bool two_d_optimization_;
 
+    /// Switch for computing the wavelet transform via FFT (ContinuousWaveletTransformFFT) instead of numerical integration
+    bool fft_transform_;
+
 
     void updateMembers_() override;
 
@@ -224,7 +228,7 @@ protected:
                 .
     */
     bool getPeakEndPoints_(PeakIterator first, PeakIterator last, PeakArea_ & area, Int distance_from_scan_border,
-                           Int & peak_left_index, Int & peak_right_index, ContinuousWaveletTransformNumIntegration & wt) const;
+                           Int & peak_left_index, Int & peak_right_index, ContinuousWaveletTransform & wt) const;
 
 
     /**
@@ -251,7 +255,11 @@ protected:
                 is similar to the width of the wavelet. Taking the maximum in the wavelet transform of the
                 Lorentzian peak we have a peak bound in the wavelet transform.
     */
-    void initializeWT_(ContinuousWaveletTransformNumIntegration& wt, const double peak_bound_in, double& peak_bound_ms_cwt) const;
+    void initializeWT_(ContinuousWaveletTransform& wt, const double peak_bound_in, double& peak_bound_ms_cwt) const;
+
+    /// Computes the wavelet transform of [first, last) with the transform selected by 'wavelet_transform:algorithm'
+    void transformWT_(ContinuousWaveletTransformNumIntegration& wt_integration, ContinuousWaveletTransformFFT& wt_fft,
+                      ConstPeakIterator first, ConstPeakIterator last) const;
 
     /** @name Methods needed for separation of overlapping peaks
      */
@@ -131,8 +131,9 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks peaks for each scan in the map, in parallel if OpenMP is
+     * enabled. The resulting picked peaks are written to the output map (in
+     * the order of the input, independent of the number of threads).
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -142,8 +143,9 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks peaks for each scan in the map, in parallel if OpenMP is
+     * enabled. The resulting picked peaks are written to the output map (in
+     * the order of the input, independent of the number of threads).
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -159,8 +161,11 @@ public:
 
     /**
       @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
+      method picks peaks for each scan in the map, in parallel if OpenMP is
+      enabled. The resulting picked peaks are written to the output map.
+
+      Spectra are read from disc in batches by one thread, while the other
+      threads pick the previously read batch.
 
       Currently we have to give up const-correctness but we know that everything on disc is constant
     */
@@ -168,12 +173,24 @@ public:
 
 protected:
 
+    /// Buffers and noise estimators reused between spectra (one per thread in pickExperiment)
+    struct Workspace_;
+
+    /// Picks a spectrum using the buffers of @p ws (see pick())
+    void pick_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const;
+
+    /// Picks a chromatogram using the buffers of @p ws (see pick())
+    void pick_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const;
+
     template <typename ContainerType>
-    void pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings = true) const;
+    void pickPeaks_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const;
 
     // signal-to-noise parameter
     double signal_to_noise_;
 
+    // use the exact median instead of the histogram for noise estimation
+    bool sn_estimator_exact_;
+
     // maximal spacing difference defining a large gap
     double spacing_difference_gap_;
     
@@ -4,6 +4,7 @@ set(directory include/OpenMS/TRANSFORMATIONS/RAW2PEAK)
 ### list all header files of the directory here
 set(sources_list_h
 ContinuousWaveletTransform.h
+ContinuousWaveletTransformFFT.h
 ContinuousWaveletTransformNumIntegration.h
 OptimizePeakDeconvolution.h
 OptimizePick.h
@@ -37,11 +37,62 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
-#include <iostream>
+#include <algorithm>
+#include <limits>
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /*
+      @brief Sums the intensities of a tophat window given by precomputed peak indices
+
+      Adds up exactly the same peaks in exactly the same order as
+      extract_value_tophat (including its treatment of the first and last
+      peak of the spectrum), so that results are bit-identical. Peaks with
+      index in [lower, upper) lie inside the m/z window, center is the first
+      peak with m/z not smaller than the target m/z. If use_im is true, peaks
+      are additionally filtered by the ion mobility window.
+    */
+    template <bool use_im>
+    inline double sumTophatWindow(const double* intensity, const double* im, const Size n,
+                                  const Size lower, const Size center, const Size upper,
+                                  const double left_im, const double right_im)
+    {
+      double integrated_intensity = 0;
+      auto inside_im = [&](Size i) { return !use_im || (im[i] > left_im && im[i] < right_im); };
+
+      // the current peak (or the last one if we moved past the end)
+      const Size c = (center == n) ? n - 1 : center;
+      if (c >= lower && c < upper && inside_im(c))
+      {
+        integrated_intensity += intensity[c];
+      }
+
+      // walk left; the first data point is only reached if it is directly next
+      // to the current peak
+      if (center != 0)
+      {
+        const Size stop = (center >= 2) ? std::max(lower, Size(1)) : lower;
+        for (Size i = center; i > stop; --i)
+        {
+          if (inside_im(i - 1)) integrated_intensity += intensity[i - 1];
+        }
+      }
+
+      // walk right
+      if (center != n)
+      {
+        for (Size i = center + 1; i < upper; ++i)
+        {
+          if (inside_im(i)) integrated_intensity += intensity[i];
+        }
+      }
+      return integrated_intensity;
+    }
+  }
+
   void ChromatogramExtractorAlgorithm::extract_value_tophat(
       const std::vector<double>::const_iterator& mz_start,
             std::vector<double>::const_iterator& mz_it,
@@ -296,6 +347,60 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // The extraction windows do not depend on the spectrum, so compute them
+    // only once (same formulas as in extract_value_tophat). The window
+    // boundaries are sorted just like the coordinates, which allows a single
+    // merge-sweep over each spectrum.
+    const Size nr_coords = extraction_coordinates.size();
+    std::vector<double> target_mz(nr_coords), left(nr_coords), right(nr_coords);
+    std::vector<double> left_im(nr_coords), right_im(nr_coords);
+    // RT range (unbounded if none is given) and ion mobility flag, kept in
+    // flat arrays since they are checked for every spectrum
+    std::vector<double> rt_start(nr_coords), rt_end(nr_coords);
+    std::vector<char> use_im(nr_coords);
+    for (Size k = 0; k < nr_coords; ++k)
+    {
+      const ExtractionCoordinates& coord = extraction_coordinates[k];
+      target_mz[k] = coord.mz;
+      if (ppm)
+      {
+        left[k]  = coord.mz - coord.mz * mz_extraction_window / 2.0 * 1.0e-6;
+        right[k] = coord.mz + coord.mz * mz_extraction_window / 2.0 * 1.0e-6;
+      }
+      else
+      {
+        left[k]  = coord.mz - mz_extraction_window / 2.0;
+        right[k] = coord.mz + mz_extraction_window / 2.0;
+      }
+      left_im[k]  = coord.ion_mobility - im_extraction_window / 2.0;
+      right_im[k] = coord.ion_mobility + im_extraction_window / 2.0;
+      use_im[k] = coord.ion_mobility >= 0.0;
+      if (coord.rt_end - coord.rt_start > 0)
+      {
+        rt_start[k] = coord.rt_start;
+        rt_end[k] = coord.rt_end;
+      }
+      else
+      {
+        rt_start[k] = -std::numeric_limits<double>::infinity();
+        rt_end[k] = std::numeric_limits<double>::infinity();
+      }
+    }
+
+    // resolve the output arrays only once, they are appended to for every
+    // spectrum (coordinates without RT range receive a point in each one)
+    std::vector<std::vector<double>*> out_rt(nr_coords), out_int(nr_coords);
+    for (Size k = 0; k < nr_coords; ++k)
+    {
+      out_rt[k] = &output[k]->getTimeArray()->data;
+      out_int[k] = &output[k]->getIntensityArray()->data;
+      if (rt_end[k] == std::numeric_limits<double>::infinity())
+      {
+        out_rt[k]->reserve(out_rt[k]->size() + input_size);
+        out_int[k]->reserve(out_int[k]->size() + input_size);
+      }
+    }
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
@@ -305,15 +410,11 @@ namespace OpenMS
       OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
       OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
 
-      OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
-      OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
-      std::vector<double>::const_iterator mz_start = mz_arr->data.begin();
-      std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-      std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-      std::vector<double>::const_iterator int_it = int_arr->data.begin();
-      std::vector<double>::const_iterator im_it;
+      const std::vector<double>& mz_data = sptr->getMZArray()->data;
+      const std::vector<double>& int_data = sptr->getIntensityArray()->data;
+      const double* im_data = nullptr;
 
-      if (sptr->getMZArray()->data.size() == 0)
+      if (mz_data.empty())
       {
         continue;
       }
@@ -325,7 +426,7 @@ namespace OpenMS
         OpenSwath::BinaryDataArrayPtr im_arr = sptr->getDriftTimeArray();
         if (im_arr != nullptr)
         {
-          im_it = im_arr->data.begin();
+          im_data = im_arr->data.data();
         }
         else
         {
@@ -336,42 +437,39 @@ namespace OpenMS
 
       // go through all transitions / chromatograms which are sorted by
       // ProductMZ. We can use this to step through the spectrum and at the
-      // same time step through the transitions. We increase the peak counter
-      // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      // same time step through the transitions: three cursors mark the first
+      // peak inside the window (lower), the first peak at or above the target
+      // m/z (center) and the first peak past the window (upper).
+      const double current_rt = s_meta.RT;
+      const Size n = mz_data.size();
+      Size lower = 0, center = 0, upper = 0;
+      for (Size k = 0; k < nr_coords; ++k)
       {
-        double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
-             (current_rt < extraction_coordinates[k].rt_start ||
-              current_rt > extraction_coordinates[k].rt_end) )
+        if (current_rt < rt_start[k] || current_rt > rt_end[k])
         {
           continue;
         }
-
-        const bool use_im = (extraction_coordinates[k].ion_mobility >= 0.0 && has_im);
-        if (!use_im && used_filter == 1)
+        if (used_filter == 2)
         {
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it,
-                               extraction_coordinates[k].mz, integrated_intensity, mz_extraction_window, ppm);
+          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
         }
-        else if (use_im && used_filter == 1)
+
+        while (lower < n && mz_data[lower] <= left[k]) ++lower;
+        while (center < n && mz_data[center] < target_mz[k]) ++center;
+        while (upper < n && mz_data[upper] < right[k]) ++upper;
+
+        double integrated_intensity;
+        if (use_im[k] && has_im)
         {
-          if (extraction_coordinates[k].ion_mobility < 0)
-          {
-            std::cerr << "WARNING : Drift time of ion is negative!" << std::endl;
-          }
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
-                               extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
-                               integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+          integrated_intensity = sumTophatWindow<true>(int_data.data(), im_data, n, lower, center, upper, left_im[k], right_im[k]);
         }
-        else if (used_filter == 2)
+        else
         {
-          throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+          integrated_intensity = sumTophatWindow<false>(int_data.data(), im_data, n, lower, center, upper, 0.0, 0.0);
         }
 
-        output[k]->getTimeArray()->data.push_back(current_rt);
-        output[k]->getIntensityArray()->data.push_back(integrated_intensity);
+        out_rt[k]->push_back(current_rt);
+        out_int[k]->push_back(integrated_intensity);
       }
     }
     endProgress();
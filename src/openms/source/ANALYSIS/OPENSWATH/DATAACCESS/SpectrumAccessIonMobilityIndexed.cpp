@@ -0,0 +1,334 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// Index of the lowest set bit of a non-zero word (de Bruijn multiplication)
+    inline unsigned lowestBit(UInt64 word)
+    {
+      static const unsigned char table[64] =
+      {
+         0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+      };
+      return table[((word & (~word + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+    }
+  }
+
+  /*
+    Ion mobility index of a spectrum. The data arrays are kept in their
+    original (m/z) order, the peaks are additionally grouped by ion mobility
+    bin: bin b holds the ion mobility values and the original positions of its
+    peaks at [bin_offsets[b], bin_offsets[b+1]), in ascending position.
+  */
+  struct SpectrumAccessIonMobilityIndexed::IonMobilityIndex
+  {
+    OpenSwath::BinaryDataArrayPtr mz;
+    OpenSwath::BinaryDataArrayPtr intensity;
+    OpenSwath::BinaryDataArrayPtr im;
+    std::vector<double> bin_im;
+    std::vector<UInt32> bin_position;
+    std::vector<Size> bin_offsets;
+    double im_min = 0.0;
+    double inv_bin_width = 0.0;
+
+    /// Bin of an ion mobility value (monotonically non-decreasing in @p value)
+    Size binOf(double value) const
+    {
+      const Size nr_bins = bin_offsets.size() - 1;
+      const double b = (value - im_min) * inv_bin_width;
+      if (!(b > 0.0)) return 0;
+      if (b >= double(nr_bins)) return nr_bins - 1;
+      return Size(b);
+    }
+
+    Size byteSize() const
+    {
+      return bin_im.size() * (4 * sizeof(double) + sizeof(UInt32)) + bin_offsets.size() * sizeof(Size);
+    }
+  };
+
+  /*
+    Thread-safe least-recently-used cache of spectrum indices, shared between
+    light clones. Indices are immutable once built and are handed out as
+    shared pointers, so they stay valid even if they are evicted.
+  */
+  class SpectrumAccessIonMobilityIndexed::IndexCache
+  {
+public:
+    explicit IndexCache(Size max_bytes) :
+      max_bytes_(max_bytes),
+      bytes_(0),
+      builds_(0)
+    {
+    }
+
+    IonMobilityIndexPtr get(int id)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(id);
+      if (it == index_.end()) return IonMobilityIndexPtr();
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+
+    IonMobilityIndexPtr put(int id, const IonMobilityIndexPtr& im_index)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++builds_;
+      auto it = index_.find(id);
+      if (it != index_.end())
+      {
+        return it->second->second; // another thread was faster
+      }
+      Size bytes = im_index->byteSize();
+      if (bytes > max_bytes_)
+      {
+        return im_index;
+      }
+      entries_.emplace_front(id, im_index);
+      index_[id] = entries_.begin();
+      bytes_ += bytes;
+
+      // remove least recently used indices
+      while (bytes_ > max_bytes_)
+      {
+        bytes_ -= entries_.back().second->byteSize();
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+      return im_index;
+    }
+
+    Size size() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return entries_.size();
+    }
+
+    Size builds() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return builds_;
+    }
+
+private:
+    typedef std::list< std::pair<int, IonMobilityIndexPtr> > EntryList;
+
+    EntryList entries_;
+    std::unordered_map<int, EntryList::iterator> index_;
+    Size max_bytes_;
+    Size bytes_;
+    Size builds_;
+    mutable std::mutex mutex_;
+  };
+
+  SpectrumAccessIonMobilityIndexed::SpectrumAccessIonMobilityIndexed(OpenSwath::SpectrumAccessPtr sptr,
+      Size nr_im_bins, Size max_bytes) :
+    SpectrumAccessIonMobilityIndexed(sptr, nr_im_bins, boost::shared_ptr<IndexCache>(new IndexCache(max_bytes)))
+  {
+  }
+
+  SpectrumAccessIonMobilityIndexed::SpectrumAccessIonMobilityIndexed(OpenSwath::SpectrumAccessPtr sptr,
+      Size nr_im_bins, boost::shared_ptr<IndexCache> cache) :
+    SpectrumAccessTransforming(sptr),
+    nr_im_bins_(std::max(nr_im_bins, Size(1))),
+    cache_(cache)
+  {
+  }
+
+  SpectrumAccessIonMobilityIndexed::~SpectrumAccessIonMobilityIndexed() {}
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessIonMobilityIndexed::lightClone() const
+  {
+    // The light clone uses a light clone of the underlying SpectrumAccess
+    // object but shares the (thread-safe) index cache.
+    return boost::shared_ptr<SpectrumAccessIonMobilityIndexed>(
+        new SpectrumAccessIonMobilityIndexed(sptr_->lightClone(), nr_im_bins_, cache_));
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessIonMobilityIndexed::getSpectrumByIdAndDrift(int id, double drift_lower, double drift_upper)
+  {
+    OpenSwath::SpectrumPtr spectrum;
+    IonMobilityIndexPtr im_index = getIndex_(id, spectrum);
+    if (im_index->im == nullptr)
+    {
+      std::cerr << "Warning: Cannot filter by drift time if no drift time is available.\n";
+      return (spectrum != nullptr) ? spectrum : sptr_->getSpectrumById(id);
+    }
+
+    OpenSwath::SpectrumPtr output(new OpenSwath::Spectrum);
+    OpenSwath::BinaryDataArrayPtr mz_arr_out(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr intens_arr_out(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr im_arr_out(new OpenSwath::BinaryDataArray);
+    im_arr_out->description = im_index->im->description;
+    output->setMZArray(mz_arr_out);
+    output->setIntensityArray(intens_arr_out);
+    output->getDataArrays().push_back(im_arr_out);
+
+    // Only peaks in bins [first_bin, last_bin] can lie inside the window since
+    // binOf is monotonic (this also holds for empty or inverted windows).
+    const Size first_bin = im_index->binOf(drift_lower);
+    const Size last_bin = im_index->binOf(drift_upper);
+    if (im_index->bin_im.empty() || first_bin > last_bin)
+    {
+      return output;
+    }
+
+    // Mark the matching peaks by their original position, collecting them in
+    // the order of the bitmask restores the original m/z order (including ties).
+    std::vector<UInt64> mask((im_index->bin_im.size() + 63) / 64, 0);
+    Size nr_matches = 0, first_word = mask.size(), last_word = 0;
+    for (Size k = im_index->bin_offsets[first_bin]; k < im_index->bin_offsets[last_bin + 1]; ++k)
+    {
+      const double im = im_index->bin_im[k];
+      if (im > drift_lower && im < drift_upper)
+      {
+        const Size pos = im_index->bin_position[k];
+        mask[pos / 64] |= UInt64(1) << (pos % 64);
+        first_word = std::min(first_word, pos / 64);
+        last_word = std::max(last_word, pos / 64);
+        ++nr_matches;
+      }
+    }
+    if (nr_matches == 0)
+    {
+      return output;
+    }
+
+    const std::vector<double>& mz = im_index->mz->data;
+    const std::vector<double>& intensity = im_index->intensity->data;
+    const std::vector<double>& im = im_index->im->data;
+    mz_arr_out->data.reserve(nr_matches);
+    intens_arr_out->data.reserve(nr_matches);
+    im_arr_out->data.reserve(nr_matches);
+    for (Size w = first_word; w <= last_word; ++w)
+    {
+      for (UInt64 word = mask[w]; word != 0; word &= word - 1)
+      {
+        const Size pos = w * 64 + lowestBit(word);
+        mz_arr_out->data.push_back(mz[pos]);
+        intens_arr_out->data.push_back(intensity[pos]);
+        im_arr_out->data.push_back(im[pos]);
+      }
+    }
+    return output;
+  }
+
+  Size SpectrumAccessIonMobilityIndexed::getNrIndexedSpectra() const
+  {
+    return cache_->size();
+  }
+
+  Size SpectrumAccessIonMobilityIndexed::getNrIndexBuilds() const
+  {
+    return cache_->builds();
+  }
+
+  SpectrumAccessIonMobilityIndexed::IonMobilityIndexPtr SpectrumAccessIonMobilityIndexed::getIndex_(int id, OpenSwath::SpectrumPtr& spectrum)
+  {
+    IonMobilityIndexPtr im_index = cache_->get(id);
+    if (im_index)
+    {
+      return im_index;
+    }
+    // build outside of the lock, concurrent builds of the same index are resolved by put()
+    spectrum = sptr_->getSpectrumById(id);
+    return cache_->put(id, buildIndex_(*spectrum));
+  }
+
+  SpectrumAccessIonMobilityIndexed::IonMobilityIndexPtr SpectrumAccessIonMobilityIndexed::buildIndex_(const OpenSwath::Spectrum& spectrum) const
+  {
+    boost::shared_ptr<IonMobilityIndex> im_index(new IonMobilityIndex);
+    im_index->bin_offsets.assign(2, 0);
+    im_index->im = spectrum.getDriftTimeArray();
+    if (im_index->im == nullptr)
+    {
+      return im_index;
+    }
+    // the data arrays are shared, not copied (they are not modified by the index)
+    im_index->mz = spectrum.getMZArray();
+    im_index->intensity = spectrum.getIntensityArray();
+
+    const std::vector<double>& im = im_index->im->data;
+    const Size n = im.size();
+    if (n == 0)
+    {
+      return im_index;
+    }
+
+    // equally spaced bins between the smallest and largest ion mobility
+    auto minmax = std::minmax_element(im.begin(), im.end());
+    im_index->im_min = *minmax.first;
+    im_index->inv_bin_width = (*minmax.second > *minmax.first) ? double(nr_im_bins_) / (*minmax.second - *minmax.first) : 0.0;
+    im_index->bin_offsets.assign(nr_im_bins_ + 1, 0);
+
+    // counting sort by bin, which keeps the original order within each bin
+    std::vector<Size> bins(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      bins[i] = im_index->binOf(im[i]);
+      ++im_index->bin_offsets[bins[i] + 1];
+    }
+    for (Size b = 0; b < nr_im_bins_; ++b)
+    {
+      im_index->bin_offsets[b + 1] += im_index->bin_offsets[b];
+    }
+    std::vector<Size> fill(im_index->bin_offsets.begin(), im_index->bin_offsets.end() - 1);
+    im_index->bin_im.resize(n);
+    im_index->bin_position.resize(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      const Size k = fill[bins[i]]++;
+      im_index->bin_im[k] = im[i];
+      im_index->bin_position[k] = UInt32(i);
+    }
+    return im_index;
+  }
+
+}
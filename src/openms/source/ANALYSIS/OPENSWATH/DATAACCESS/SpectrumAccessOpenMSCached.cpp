@@ -50,9 +50,10 @@ namespace OpenMS
   }
 
   SpectrumAccessOpenMSCached::SpectrumAccessOpenMSCached(const SpectrumAccessOpenMSCached & rhs) :
-    CachedmzML(rhs)
+    CachedmzML(rhs),
+    cache_(rhs.cache_)
   {
-    // this only copies the indices and meta-data
+    // this only copies the indices and meta-data (the spectrum cache is shared)
   }
 
   boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMSCached::lightClone() const
@@ -65,6 +66,12 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    OpenSwath::SpectrumPtr sptr;
+    if (cache_ != nullptr && cache_->get(id, sptr))
+    {
+      return sptr;
+    }
+
     int ms_level = -1;
     double rt = -1.0;
 
@@ -76,9 +83,13 @@ namespace OpenMS
         "Error while changing position of input stream pointer.", filename_cached_);
     }
 
-    OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+    sptr = OpenSwath::SpectrumPtr(new OpenSwath::Spectrum);
     sptr->getDataArrays() = Internal::CachedMzMLHandler::readSpectrumFast(ifs_, ms_level, rt);
 
+    if (cache_ != nullptr)
+    {
+      cache_->put(id, sptr);
+    }
     return sptr;
   }
 
@@ -162,5 +173,22 @@ namespace OpenMS
     return meta_ms_experiment_.getChromatograms()[id].getNativeID();
   }
 
+  void SpectrumAccessOpenMSCached::setCacheSize(Size max_bytes)
+  {
+    if (max_bytes == 0)
+    {
+      cache_.reset();
+    }
+    else
+    {
+      cache_.reset(new SpectrumLRUCache(max_bytes));
+    }
+  }
+
+  boost::shared_ptr<SpectrumLRUCache> SpectrumAccessOpenMSCached::getCache() const
+  {
+    return cache_;
+  }
+
 } //end namespace OpenMS
 
@@ -49,7 +49,8 @@ namespace OpenMS
 
 
     SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices) :
-      handler_(sp.handler_)
+      handler_(sp.handler_),
+      cache_(sp.cache_)
     {
       if (indices.empty())
       {
@@ -77,7 +78,8 @@ namespace OpenMS
     /// Copy constructor
     SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass & rhs) :
       handler_(rhs.handler_),
-      sidx_(rhs.sidx_)
+      sidx_(rhs.sidx_),
+      cache_(rhs.cache_)
     {
     }
 
@@ -99,6 +101,12 @@ namespace OpenMS
         indices.push_back(sidx_[id]);
       }
 
+      OpenSwath::SpectrumPtr sptr;
+      if (cache_ != nullptr && cache_->get(indices[0], sptr))
+      {
+        return sptr;
+      }
+
       // read MSSpectra and prepare for conversion
       std::vector<MSSpectrum> tmp_spectra;
       handler_.readSpectra(tmp_spectra, indices, false);
@@ -112,9 +120,14 @@ namespace OpenMS
         intensity_array->data.push_back(it->getIntensity());
       }
 
-      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr = OpenSwath::SpectrumPtr(new OpenSwath::Spectrum);
       sptr->setMZArray(mz_array);
       sptr->setIntensityArray(intensity_array);
+
+      if (cache_ != nullptr)
+      {
+        cache_->put(indices[0], sptr);
+      }
       return sptr;
     }
 
@@ -243,4 +256,21 @@ namespace OpenMS
       throw Exception::NotImplemented(__FILE__,__LINE__,OPENMS_PRETTY_FUNCTION);
     }
 
+    void SpectrumAccessSqMass::setCacheSize(Size max_bytes)
+    {
+      if (max_bytes == 0)
+      {
+        cache_.reset();
+      }
+      else
+      {
+        cache_.reset(new SpectrumLRUCache(max_bytes));
+      }
+    }
+
+    boost::shared_ptr<SpectrumLRUCache> SpectrumAccessSqMass::getCache() const
+    {
+      return cache_;
+    }
+
 } //end namespace OpenMS
@@ -0,0 +1,159 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumLRUCache.h>
+
+namespace OpenMS
+{
+
+  SpectrumLRUCache::SpectrumLRUCache(Size max_bytes) :
+    max_bytes_(max_bytes),
+    bytes_(0),
+    hits_(0),
+    misses_(0)
+  {
+  }
+
+  SpectrumLRUCache::~SpectrumLRUCache()
+  {
+  }
+
+  bool SpectrumLRUCache::get(Size id, OpenSwath::SpectrumPtr& spectrum)
+  {
+    OpenSwath::SpectrumPtr cached;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(id);
+      if (it == index_.end())
+      {
+        ++misses_;
+        return false;
+      }
+      ++hits_;
+      // move to the front (most recently used)
+      entries_.splice(entries_.begin(), entries_, it->second);
+      cached = it->second->second;
+    }
+
+    // the cached spectrum is never modified, so it can be copied without holding the lock
+    spectrum = copySpectrum_(*cached);
+    return true;
+  }
+
+  void SpectrumLRUCache::put(Size id, const OpenSwath::SpectrumPtr& spectrum)
+  {
+    Size bytes = byteSize_(*spectrum);
+    if (bytes > max_bytes_)
+    {
+      return;
+    }
+    OpenSwath::SpectrumPtr copy = copySpectrum_(*spectrum);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.find(id) != index_.end())
+    {
+      return; // another thread was faster
+    }
+    entries_.emplace_front(id, copy);
+    index_[id] = entries_.begin();
+    bytes_ += bytes;
+
+    // remove least recently used spectra
+    while (bytes_ > max_bytes_)
+    {
+      bytes_ -= byteSize_(*entries_.back().second);
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  void SpectrumLRUCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+  }
+
+  Size SpectrumLRUCache::getHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  Size SpectrumLRUCache::getMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  Size SpectrumLRUCache::getNrSpectra() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  Size SpectrumLRUCache::getBytes() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+  Size SpectrumLRUCache::getMaxBytes() const
+  {
+    return max_bytes_;
+  }
+
+  OpenSwath::SpectrumPtr SpectrumLRUCache::copySpectrum_(const OpenSwath::Spectrum& spectrum)
+  {
+    OpenSwath::SpectrumPtr copy(new OpenSwath::Spectrum);
+    copy->getDataArrays().clear();
+    for (const auto& bda : spectrum.getDataArrays())
+    {
+      copy->getDataArrays().push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray(*bda)));
+    }
+    return copy;
+  }
+
+  Size SpectrumLRUCache::byteSize_(const OpenSwath::Spectrum& spectrum)
+  {
+    Size bytes = 0;
+    for (const auto& bda : spectrum.getDataArrays())
+    {
+      bytes += bda->data.size() * sizeof(double);
+    }
+    return bytes;
+  }
+
+} //end namespace OpenMS
@@ -4,12 +4,14 @@ set(directory source/ANALYSIS/OPENSWATH/DATAACCESS)
 ### list all header files of the directory here
 set(sources_list
 MRMFeatureAccessOpenMS.cpp
+SpectrumAccessIonMobilityIndexed.cpp
 SpectrumAccessOpenMS.cpp
 SpectrumAccessOpenMSCached.cpp
 SpectrumAccessOpenMSInMemory.cpp
 SpectrumAccessSqMass.cpp
 SpectrumAccessTransforming.cpp
 SpectrumAccessQuadMZTransforming.cpp
+SpectrumLRUCache.cpp
 DataAccessHelper.cpp
 SimpleOpenMSSpectraAccessFactory.cpp
 )
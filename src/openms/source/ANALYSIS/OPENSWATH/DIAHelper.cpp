@@ -35,7 +35,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAHelper.h>
 
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
 
@@ -259,15 +259,12 @@ namespace OpenMS
                                          const double mannmass)
     {
       charge = std::abs(charge);
-      typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
       // create the theoretical distribution
-      CoarseIsotopePatternGenerator solver(nr_isotopes);
-      TheoreticalIsotopePattern isotopes;
       //Note: this is a rough estimate of the weight, usually the protons should be deducted first, left for backwards compat.
-      auto d = solver.estimateFromPeptideWeight(product_mz * charge);
+      const IsotopeDistribution& d = AveragineIsotopePatternCache::getInstance().estimateFromPeptideWeight(product_mz * charge, nr_isotopes);
 
       double mass = product_mz;
-      for (IsotopeDistribution::Iterator it = d.begin(); it != d.end(); ++it)
+      for (IsotopeDistribution::ConstIterator it = d.begin(); it != d.end(); ++it)
       {
         isotopes_spec.emplace_back(mass, it->getIntensity());
         mass += mannmass / charge;
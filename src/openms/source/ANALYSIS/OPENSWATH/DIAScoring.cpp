@@ -36,6 +36,7 @@
 
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
@@ -242,9 +243,9 @@ namespace OpenMS
   {
     std::vector<double> exp_isotopes_int;
     getIsotopeIntysFromExpSpec_(precursor_mz, spectrum, exp_isotopes_int, charge_state);
-    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
     // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
-    IsotopeDistribution isotope_dist = solver.estimateFromPeptideWeight(std::fabs(precursor_mz * charge_state));
+    const IsotopeDistribution& isotope_dist = AveragineIsotopePatternCache::getInstance().estimateFromPeptideWeight(
+      std::fabs(precursor_mz * charge_state), dia_nr_isotopes_ + 1);
 
     double max_ratio;
     int nr_occurrences;
@@ -414,12 +415,10 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set to != 0"); // charge can be positive and negative
 
-    IsotopeDistribution isotope_dist;
-
-    // create the theoretical distribution from the peptide weight
-    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
+    // create the theoretical distribution from the peptide weight (the same patterns are needed for many peak groups)
     // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
-    isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
+    const IsotopeDistribution& isotope_dist = AveragineIsotopePatternCache::getInstance().estimateFromPeptideWeight(
+      std::fabs(product_mz * putative_fragment_charge), dia_nr_isotopes_ + 1);
 
     return scoreIsotopePattern_(isotopes_int, isotope_dist);
   } //end of dia_isotope_corr_sub
@@ -45,6 +45,7 @@
 
 // Helpers
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
 #include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
 
 #include <boost/range/adaptor/map.hpp>
@@ -240,6 +241,10 @@ namespace OpenMS
     }
     trgroup_picker.setParameters(trgroup_picker_param);
 
+    const AveragineIsotopePatternCache& isotope_cache = AveragineIsotopePatternCache::getInstance();
+    const Size isotope_requests_before = isotope_cache.getNrRequests();
+    const Size isotope_computed_before = isotope_cache.getNrComputed();
+
     Size progress = 0;
     startProgress(0, transition_group_map.size(), "picking peaks");
     for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
@@ -257,6 +262,13 @@ namespace OpenMS
     }
     endProgress();
 
+    // the cache is shared with concurrently running instances, so these numbers are approximate when running in parallel
+    // clamp, so that a clear() or concurrent requests in between cannot make the differences wrap around
+    const Size isotope_requests = std::max(isotope_cache.getNrRequests(), isotope_requests_before) - isotope_requests_before;
+    const Size isotope_computed = std::min(std::max(isotope_cache.getNrComputed(), isotope_computed_before) - isotope_computed_before, isotope_requests);
+    OPENMS_LOG_DEBUG << "Isotope pattern cache: " << isotope_requests << " averagine patterns used, "
+                     << isotope_computed << " computed, " << isotope_requests - isotope_computed << " computations saved." << std::endl;
+
     //output.sortByPosition(); // if the exact same order is needed
     return;
   }
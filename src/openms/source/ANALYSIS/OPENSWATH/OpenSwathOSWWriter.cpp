@@ -47,7 +47,9 @@ namespace OpenMS
     doWrite_(!output_filename.empty()),
     use_ms1_traces_(ms1_scores),
     sonar_(sonar),
-    enable_uis_scoring_(uis_scores)
+    enable_uis_scoring_(uis_scores),
+    shard_index_(0),
+    nr_shards_(1)
   {}
 
   bool OpenSwathOSWWriter::isActive() const
@@ -55,6 +57,12 @@ namespace OpenMS
     return doWrite_;
   }
 
+  void OpenSwathOSWWriter::setShard(Size shard_index, Size nr_shards)
+  {
+    shard_index_ = shard_index;
+    nr_shards_ = nr_shards;
+  }
+
   void OpenSwathOSWWriter::writeHeader()
   {
     // Open database
@@ -177,6 +185,13 @@ namespace OpenMS
 
     // Execute SQL insert statement
     conn.executeStatement(sql_run.str());
+
+    // Partial output of a sharded analysis, checked when merging
+    if (nr_shards_ > 1)
+    {
+      conn.executeStatement("CREATE TABLE SHARD(SHARD_INDEX INT NOT NULL, SHARD_COUNT INT NOT NULL); "
+                            "INSERT INTO SHARD (SHARD_INDEX, SHARD_COUNT) VALUES (" + String(shard_index_) + ", " + String(nr_shards_) + ");");
+    }
   }
 
   String OpenSwathOSWWriter::getScore(const Feature& feature, std::string score_name) const
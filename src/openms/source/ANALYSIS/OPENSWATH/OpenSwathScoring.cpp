@@ -45,6 +45,7 @@
 
 // auxiliary
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/SpectrumAddition.h>
 
@@ -627,37 +628,47 @@ namespace OpenMS
       closest_idx--;
     }
 
-    if (nr_spectra_to_add == 1)
+    // Retrieve a spectrum filtered by drift time (if requested). If the map
+    // carries an ion mobility index, only the peaks inside the drift time
+    // window are touched instead of scanning the whole spectrum.
+    boost::shared_ptr<SpectrumAccessIonMobilityIndexed> im_indexed_map =
+      boost::dynamic_pointer_cast<SpectrumAccessIonMobilityIndexed>(swath_map);
+    auto getSpectrum = [&](int idx)
     {
-      added_spec = swath_map->getSpectrumById(closest_idx);
-      if (drift_upper > 0) 
+      if (drift_upper > 0 && im_indexed_map)
+      {
+        return im_indexed_map->getSpectrumByIdAndDrift(idx, drift_lower, drift_upper);
+      }
+      OpenSwath::SpectrumPtr s = swath_map->getSpectrumById(idx);
+      if (drift_upper > 0)
       {
-        added_spec = filterByDrift(added_spec, drift_lower, drift_upper);
+        s = filterByDrift(s, drift_lower, drift_upper);
       }
+      return s;
+    };
+
+    if (nr_spectra_to_add == 1)
+    {
+      added_spec = getSpectrum(closest_idx);
     }
     else
     {
+      // all spectra are filtered by drift time before further processing
       std::vector<OpenSwath::SpectrumPtr> all_spectra;
       // always add the spectrum 0, then add those right and left
-      all_spectra.push_back(swath_map->getSpectrumById(closest_idx));
+      all_spectra.push_back(getSpectrum(closest_idx));
       for (int i = 1; i <= nr_spectra_to_add / 2; i++) // cast to int is intended!
       {
         if (closest_idx - i >= 0)
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
+          all_spectra.push_back(getSpectrum(closest_idx - i));
         }
         if (closest_idx + i < (int)swath_map->getNrSpectra())
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
+          all_spectra.push_back(getSpectrum(closest_idx + i));
         }
       }
 
-      // Filter all spectra by drift time before further processing
-      if (drift_upper > 0) 
-      {
-        for (auto& s: all_spectra) s = filterByDrift(s, drift_lower, drift_upper);
-      }
-
       // add up all spectra
       if (spectra_addition_method_ == "simple")
       {
@@ -0,0 +1,416 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathShardMerger.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace OpenMS
+{
+  namespace
+  {
+    namespace Sql = Internal::SqliteHelper;
+
+    /// Peak group tables of an OSW file and the canonical order of their rows
+    const std::vector<std::pair<String, String> > feature_tables =
+    {
+      {"FEATURE", "PRECURSOR_ID, EXP_RT, ID"},
+      {"FEATURE_MS1", "FEATURE_ID"},
+      {"FEATURE_MS2", "FEATURE_ID"},
+      {"FEATURE_PRECURSOR", "FEATURE_ID, ISOTOPE"},
+      {"FEATURE_TRANSITION", "FEATURE_ID, TRANSITION_ID"}
+    };
+
+    /// Read the (single) run of an OSW file (in schema @p db)
+    void readRun(SqliteConnector& conn, const String& db, Int64& run_id, String& filename)
+    {
+      sqlite3_stmt* stmt;
+      conn.prepareStatement(&stmt, "SELECT ID, FILENAME FROM " + db + ".RUN;");
+      Sql::SqlState rc = Sql::nextRow(stmt);
+      if (rc != Sql::SqlState::SQL_ROW)
+      {
+        sqlite3_finalize(stmt);
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "OSW file does not contain a run, is it an OpenSwathWorkflow output file?");
+      }
+      Sql::extractValue<Int64>(&run_id, stmt, 0);
+      Sql::extractValue<String>(&filename, stmt, 1);
+      sqlite3_finalize(stmt);
+    }
+
+    /// Position of a partial result in its analysis (count 0: not written by a sharded analysis)
+    struct ShardInfo
+    {
+      Size index = 0;
+      Size count = 0;
+    };
+
+    /// Read the shard information of an OSW file (SHARD table, written by OpenSwathOSWWriter)
+    ShardInfo readShard(SqliteConnector& conn, const String& filename)
+    {
+      ShardInfo shard;
+      if (!conn.tableExists("SHARD")) return shard;
+      sqlite3_stmt* stmt;
+      conn.prepareStatement(&stmt, "SELECT SHARD_INDEX, SHARD_COUNT FROM SHARD;");
+      int index(-1), count(0);
+      if (Sql::nextRow(stmt) == Sql::SqlState::SQL_ROW)
+      {
+        Sql::extractValue<int>(&index, stmt, 0);
+        Sql::extractValue<int>(&count, stmt, 1);
+      }
+      sqlite3_finalize(stmt);
+      if (index < 0 || count <= index)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "OSW file '" + filename + "' contains invalid shard information.");
+      }
+      shard.index = index;
+      shard.count = count;
+      return shard;
+    }
+
+    /// Read the shard information of a TSV file (line "# shard <index> of <count>", written by OpenSwathTSVWriter)
+    ShardInfo parseShard(const String& line, const String& filename)
+    {
+      std::vector<String> parts;
+      line.split(' ', parts);
+      ShardInfo shard;
+      try
+      {
+        if (parts.size() == 5 && parts[0] == "#" && parts[1] == "shard" && parts[3] == "of")
+        {
+          shard.index = parts[2].toInt();
+          shard.count = parts[4].toInt();
+        }
+      }
+      catch (Exception::ConversionError&)
+      {
+      }
+      if (shard.count == 0 || shard.index >= shard.count)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "TSV file '" + filename + "' contains invalid shard information ('" + line + "').");
+      }
+      return shard;
+    }
+
+    /// Check that the files are exactly the shards 0 to n - 1 of one analysis, each given once
+    void checkShards(const StringList& shard_files, const std::vector<ShardInfo>& shards)
+    {
+      // the output of a single process can be "merged" on its own (which only sorts it)
+      if (shards.size() == 1 && shards[0].count == 0) return;
+
+      std::vector<String> seen(shard_files.size());
+      for (Size i = 0; i < shards.size(); ++i)
+      {
+        if (shards[i].count == 0)
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "File '" + shard_files[i] + "' is not the partial output of a sharded analysis (no shard information), "
+              "only files written with 'shard_count' larger than 1 can be merged.");
+        }
+        if (shards[i].count != shard_files.size())
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "File '" + shard_files[i] + "' is shard " + String(shards[i].index) + " of " + String(shards[i].count) +
+              ", but " + String(shard_files.size()) + " files are given. All shards of an analysis need to be merged at once.");
+        }
+        if (!seen[shards[i].index].empty())
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "Shard " + String(shards[i].index) + " is given twice ('" + seen[shards[i].index] + "' and '" + shard_files[i] + "').");
+        }
+        seen[shards[i].index] = shard_files[i];
+      }
+      // n distinct indices below n: all shards are present
+    }
+
+    /// Combine the (checked) shards into the output file
+    void mergeOSWShards(const StringList& shard_files, const String& output_file)
+    {
+      // the first shard provides the library tables and the run
+      {
+        std::ifstream src(shard_files[0].c_str(), std::ios::binary);
+        if (!src)
+        {
+          throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, shard_files[0]);
+        }
+        std::ofstream dst(output_file.c_str(), std::ios::binary | std::ios::trunc);
+        if (!dst)
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, output_file);
+        }
+        dst << src.rdbuf();
+        dst.close();
+        if (!dst)
+        {
+          throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, output_file);
+        }
+      }
+
+      SqliteConnector conn(output_file, SqliteConnector::SqlOpenMode::READWRITE);
+      Int64 run_id;
+      String run_filename;
+      readRun(conn, "main", run_id, run_filename);
+      // the merged output is complete, it is not a shard anymore
+      if (conn.tableExists("SHARD"))
+      {
+        conn.executeStatement("DROP TABLE SHARD;");
+      }
+
+      std::vector<String> tables;
+      for (const auto& t : feature_tables)
+      {
+        if (conn.tableExists(t.first))
+        {
+          tables.push_back(t.first);
+          conn.executeStatement("CREATE TEMP TABLE MERGED_" + t.first + " AS SELECT * FROM main." + t.first + "; "
+                                "DELETE FROM main." + t.first + ";");
+        }
+      }
+
+      // collect the peak groups of all other shards (attached one at a time,
+      // since SQLite limits the number of attached databases)
+      for (Size i = 1; i < shard_files.size(); ++i)
+      {
+        conn.executeStatement("ATTACH DATABASE '" + String(shard_files[i]).substitute("'", "''") + "' AS SHARD;");
+        for (const auto& t : tables)
+        {
+          conn.executeStatement("INSERT INTO temp.MERGED_" + t + " SELECT * FROM SHARD." + t + ";");
+        }
+        conn.executeStatement("DETACH DATABASE SHARD;");
+      }
+
+      // write all peak groups in canonical order and assign them to the run of the first shard
+      conn.executeStatement("BEGIN TRANSACTION;");
+      for (const auto& t : feature_tables)
+      {
+        if (std::find(tables.begin(), tables.end(), t.first) == tables.end()) continue;
+        conn.executeStatement("INSERT INTO main." + t.first + " SELECT * FROM temp.MERGED_" + t.first +
+                              " ORDER BY " + t.second + "; DROP TABLE temp.MERGED_" + t.first + ";");
+      }
+      if (conn.tableExists("FEATURE"))
+      {
+        conn.executeStatement("UPDATE FEATURE SET RUN_ID = " + String(run_id) + ";");
+      }
+      conn.executeStatement("COMMIT;");
+    }
+
+    /// A row of a TSV file with the values it is sorted by
+    struct TSVRow
+    {
+      String group_id;
+      double rt;
+      String line;
+
+      bool operator<(const TSVRow& other) const
+      {
+        if (group_id != other.group_id) return group_id < other.group_id;
+        if (rt != other.rt) return rt < other.rt;
+        return line < other.line;
+      }
+    };
+  }
+
+  void OpenSwathShardMerger::mergeOSW(const StringList& shard_files, const String& output_file)
+  {
+    if (shard_files.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No OSW files given to merge.");
+    }
+    const String output_path = File::absolutePath(output_file);
+    for (const auto& f : shard_files)
+    {
+      if (!File::exists(f))
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, f);
+      }
+      // the output is created from the first shard and the others are read afterwards
+      if (File::absolutePath(f) == output_path)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "The merged OSW file '" + output_file + "' must not be one of the shards.");
+      }
+    }
+
+    // check the shards and their runs before the output is created, so that
+    // invalid input does not leave a partial output file behind
+    String run_filename;
+    std::vector<ShardInfo> shards;
+    for (Size i = 0; i < shard_files.size(); ++i)
+    {
+      SqliteConnector shard(shard_files[i], SqliteConnector::SqlOpenMode::READONLY);
+      shards.push_back(readShard(shard, shard_files[i]));
+      Int64 shard_run_id;
+      String shard_filename;
+      readRun(shard, "main", shard_run_id, shard_filename);
+      if (i == 0)
+      {
+        run_filename = shard_filename;
+      }
+      else if (shard_filename != run_filename)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "Shard '" + shard_files[i] + "' was generated from '" + shard_filename + "' but shard '" +
+            shard_files[0] + "' from '" + run_filename + "'. Only shards of the same run can be merged.");
+      }
+    }
+    checkShards(shard_files, shards);
+
+    try
+    {
+      mergeOSWShards(shard_files, output_file);
+    }
+    catch (...)
+    {
+      File::remove(output_file);
+      throw;
+    }
+  }
+
+  void OpenSwathShardMerger::mergeTSV(const StringList& shard_files, const String& output_file)
+  {
+    if (shard_files.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No TSV files given to merge.");
+    }
+
+    String header;
+    Size group_col(0), rt_col(0);
+    // all rows need the same entry in the "filename" column (if there is one)
+    SignedSize filename_col(-1);
+    String run_filename;
+    bool first_row(true);
+    std::vector<TSVRow> rows;
+    std::vector<ShardInfo> shards(shard_files.size());
+    for (Size i = 0; i < shard_files.size(); ++i)
+    {
+      std::ifstream ifs(shard_files[i].c_str());
+      if (!ifs)
+      {
+        throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, shard_files[i]);
+      }
+      std::string line;
+      std::getline(ifs, line);
+      // partial output of a sharded analysis: shard information precedes the header
+      if (!line.empty() && line[0] == '#')
+      {
+        shards[i] = parseShard(line, shard_files[i]);
+        std::getline(ifs, line);
+      }
+      if (i == 0)
+      {
+        header = line;
+        std::vector<String> columns;
+        header.split('\t', columns);
+        auto group_it = std::find(columns.begin(), columns.end(), "transition_group_id");
+        auto rt_it = std::find(columns.begin(), columns.end(), "RT");
+        if (group_it == columns.end() || rt_it == columns.end())
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "File '" + shard_files[i] + "' is not an OpenSwathWorkflow TSV file (columns transition_group_id and RT are required).");
+        }
+        group_col = group_it - columns.begin();
+        rt_col = rt_it - columns.begin();
+        auto filename_it = std::find(columns.begin(), columns.end(), "filename");
+        if (filename_it != columns.end())
+        {
+          filename_col = filename_it - columns.begin();
+        }
+      }
+      else if (line != header)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            "File '" + shard_files[i] + "' has a different header than '" + shard_files[0] + "'. Only shards of the same run can be merged.");
+      }
+
+      std::vector<String> fields;
+      while (std::getline(ifs, line))
+      {
+        if (line.empty()) continue;
+        String(line).split('\t', fields);
+        TSVRow row;
+        if (fields.size() > std::max(group_col, rt_col))
+        {
+          row.group_id = fields[group_col];
+          row.rt = std::strtod(fields[rt_col].c_str(), nullptr);
+        }
+        else
+        {
+          row.rt = 0.0;
+        }
+        if (filename_col >= 0 && (SignedSize)fields.size() > filename_col)
+        {
+          if (first_row)
+          {
+            run_filename = fields[filename_col];
+            first_row = false;
+          }
+          else if (fields[filename_col] != run_filename)
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "File '" + shard_files[i] + "' contains results for '" + fields[filename_col] + "', but previous shards for '" +
+                run_filename + "'. Only shards of the same run can be merged.");
+          }
+        }
+        row.line = line;
+        rows.push_back(std::move(row));
+      }
+    }
+
+    checkShards(shard_files, shards);
+
+    std::sort(rows.begin(), rows.end());
+
+    std::ofstream ofs(output_file.c_str());
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, output_file);
+    }
+    ofs << header << "\n";
+    for (const auto& row : rows)
+    {
+      ofs << row.line << "\n";
+    }
+  }
+
+}
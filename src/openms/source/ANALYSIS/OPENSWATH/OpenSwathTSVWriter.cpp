@@ -46,7 +46,9 @@ namespace OpenMS
     input_filename_(input_filename),
     doWrite_(!output_filename.empty()),
     use_ms1_traces_(ms1_scores),
-    sonar_(sonar)
+    sonar_(sonar),
+    shard_index_(0),
+    nr_shards_(1)
     {
     }
 
@@ -55,8 +57,18 @@ namespace OpenMS
       return doWrite_;
     }
 
+    void OpenSwathTSVWriter::setShard(Size shard_index, Size nr_shards)
+    {
+      shard_index_ = shard_index;
+      nr_shards_ = nr_shards;
+    }
+
     void OpenSwathTSVWriter::writeHeader()
     {
+      if (nr_shards_ > 1)
+      {
+        ofs << "# shard " << shard_index_ << " of " << nr_shards_ << "\n";
+      }
       ofs << "transition_group_id" << "\t" 
           << "peptide_group_label" << "\t"
           << "run_id" << "\t"
@@ -34,10 +34,226 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
 
+  namespace
+  {
+    /**
+      @brief Loads upcoming SWATH maps into memory in the background
+
+      Maps are requested with acquire() in (roughly) increasing order. Each
+      request starts loading the next maps that nobody has requested yet,
+      as long as the loaded but not yet requested maps fit into the memory
+      budget. The size of a map is only known once it is loaded, so the
+      largest map seen so far is used as an estimate for maps in flight.
+    */
+    class SwathMapPrefetcher
+    {
+    public:
+      SwathMapPrefetcher(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                         const std::vector<bool> & used, Size memory_budget) :
+        swath_maps_(swath_maps),
+        used_(used),
+        requested_(swath_maps.size(), false),
+        memory_budget_(memory_budget),
+        memory_prefetched_(0),
+        largest_map_(0),
+        next_(0),
+        stopped_(false)
+      {
+      }
+
+      ~SwathMapPrefetcher()
+      {
+        // wait for background tasks of maps that were never requested
+        std::vector< std::future<OpenSwath::SpectrumAccessPtr> > pending;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stopped_ = true;
+          for (auto& p : prefetched_)
+          {
+            pending.push_back(std::move(p.second.future));
+          }
+        }
+        for (auto& f : pending)
+        {
+          f.wait();
+        }
+      }
+
+      /// Returns map @p idx held in memory and starts loading the next maps
+      OpenSwath::SpectrumAccessPtr acquire(Size idx)
+      {
+        std::future<OpenSwath::SpectrumAccessPtr> future;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          requested_[idx] = true;
+          auto it = prefetched_.find(idx);
+          if (it != prefetched_.end())
+          {
+            future = std::move(it->second.future);
+            memory_prefetched_ -= it->second.memory;
+            prefetched_.erase(it);
+          }
+          schedule_();
+        }
+
+        if (future.valid())
+        {
+          return future.get();
+        }
+        OpenSwath::SpectrumAccessPtr map = load_(swath_maps_[idx].sptr);
+        Size memory = estimateMemory_(map);
+        std::lock_guard<std::mutex> lock(mutex_);
+        largest_map_ = std::max(largest_map_, memory);
+        schedule_();
+        return map;
+      }
+
+    private:
+      struct Prefetched
+      {
+        std::future<OpenSwath::SpectrumAccessPtr> future;
+        Size memory;
+      };
+
+      static OpenSwath::SpectrumAccessPtr load_(const OpenSwath::SpectrumAccessPtr& sptr)
+      {
+        // This creates an InMemory object that keeps all data in memory
+        return boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*sptr) );
+      }
+
+      static Size estimateMemory_(const OpenSwath::SpectrumAccessPtr& map)
+      {
+        Size memory = 0;
+        for (Size i = 0; i < map->getNrSpectra(); ++i)
+        {
+          for (const auto& bda : map->getSpectrumById(i)->getDataArrays())
+          {
+            memory += bda->data.size() * sizeof(double);
+          }
+        }
+        return memory;
+      }
+
+      /// Start loading the next maps that fit into the budget (mutex_ must be held)
+      void schedule_()
+      {
+        while (!stopped_)
+        {
+          while (next_ < swath_maps_.size() && (requested_[next_] || !used_[next_]))
+          {
+            ++next_;
+          }
+          // without any known map size, keep at most one map in flight
+          bool fits = (largest_map_ == 0) ? prefetched_.empty() :
+                      memory_prefetched_ + largest_map_ <= memory_budget_;
+          if (next_ >= swath_maps_.size() || !fits)
+          {
+            return;
+          }
+          prefetch_(next_++);
+        }
+      }
+
+      /// Start loading map @p idx in the background (mutex_ must be held)
+      void prefetch_(Size idx)
+      {
+        // a light clone, so that the background task does not share a file stream
+        OpenSwath::SpectrumAccessPtr sptr = swath_maps_[idx].sptr->lightClone();
+        Prefetched& p = prefetched_[idx];
+        p.memory = largest_map_;
+        memory_prefetched_ += p.memory;
+        p.future = std::async(std::launch::async, [this, idx, sptr]()
+        {
+          OpenSwath::SpectrumAccessPtr map = load_(sptr);
+          Size memory = estimateMemory_(map);
+
+          std::lock_guard<std::mutex> lock(mutex_);
+          largest_map_ = std::max(largest_map_, memory);
+          auto it = prefetched_.find(idx);
+          if (it != prefetched_.end())
+          {
+            // replace the estimate by the actual size
+            memory_prefetched_ = memory_prefetched_ - it->second.memory + memory;
+            it->second.memory = memory;
+          }
+          schedule_();
+          return map;
+        });
+      }
+
+      const std::vector< OpenSwath::SwathMap > & swath_maps_;
+      const std::vector<bool> used_;
+      std::vector<bool> requested_;
+      std::map<Size, Prefetched> prefetched_;
+      Size memory_budget_;
+      Size memory_prefetched_;
+      Size largest_map_;
+      Size next_;
+      bool stopped_;
+      std::mutex mutex_;
+    };
+
+    /**
+      @brief Per-thread buffers of the lean output mode (see OpenSwathWorkflow::setLeanOutput)
+
+      Output lines and chromatogram segments of scored transition groups are
+      collected here and written out every few groups. Written chromatograms
+      are cleared and kept for re-use, so their peak storage is recycled
+      instead of being allocated again for each transition group.
+    */
+    struct LeanOutputPool
+    {
+      /// Returns an empty chromatogram (possibly with recycled capacity)
+      MSChromatogram acquire()
+      {
+        if (free_chromatograms.empty()) return MSChromatogram();
+        MSChromatogram chrom = std::move(free_chromatograms.back());
+        free_chromatograms.pop_back();
+        return chrom;
+      }
+
+      /// Clears @p chrom and returns it to the pool
+      void release(MSChromatogram&& chrom)
+      {
+        chrom.clear(true);
+        free_chromatograms.push_back(std::move(chrom));
+      }
+
+      /// Returns all pending chromatograms to the pool and drops all pending lines
+      void recycle()
+      {
+        for (auto& chrom : pending_chromatograms)
+        {
+          release(std::move(chrom));
+        }
+        pending_chromatograms.clear();
+        pending_tsv.clear();
+        pending_osw.clear();
+      }
+
+      std::vector<MSChromatogram> free_chromatograms; ///< cleared chromatograms available for re-use
+      std::vector<MSChromatogram> pending_chromatograms; ///< scored chromatogram segments not yet written
+      std::vector<String> pending_tsv; ///< TSV lines not yet written
+      std::vector<String> pending_osw; ///< OSW lines not yet written
+      Size pending_groups = 0; ///< transition groups scored since the last write
+
+      /// Number of transition groups after which pending output is written
+      static constexpr Size flush_interval = 20;
+    };
+  }
+
   OpenSwath::SpectrumAccessPtr loadMS1Map(const std::vector< OpenSwath::SwathMap > & swath_maps, bool load_into_memory)
   {
     OpenSwath::SpectrumAccessPtr ms1_map;
@@ -438,6 +654,27 @@ namespace OpenMS
 namespace OpenMS
 {
 
+  void OpenSwathWorkflow::setShard(Size shard_index, Size nr_shards)
+  {
+    if (nr_shards == 0 || shard_index >= nr_shards)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Shard index " + String(shard_index) + " is invalid for " + String(nr_shards) + " shards.");
+    }
+    shard_index_ = shard_index;
+    nr_shards_ = nr_shards;
+  }
+
+  void OpenSwathWorkflow::setLeanOutput(bool lean_output)
+  {
+    lean_output_ = lean_output;
+  }
+
+  void OpenSwathWorkflow::setIonMobilityIndexMemory(Size im_index_memory)
+  {
+    im_index_memory_ = im_index_memory;
+  }
+
   void OpenSwathWorkflow::performExtraction(
     const std::vector< OpenSwath::SwathMap > & swath_maps,
     const TransformationDescription trafo,
@@ -454,6 +691,8 @@ namespace OpenMS
     int ms1_isotopes,
     bool load_into_memory)
   {
+    tsv_writer.setShard(shard_index_, nr_shards_);
+    osw_writer.setShard(shard_index_, nr_shards_);
     tsv_writer.writeHeader();
     osw_writer.writeHeader();
 
@@ -465,6 +704,10 @@ namespace OpenMS
 
     std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
     int progress = 0;
+    // the isotope pattern cache is shared by all scoring threads, report how much it saved in this run
+    const AveragineIsotopePatternCache& isotope_cache = AveragineIsotopePatternCache::getInstance();
+    const Size isotope_requests_before = isotope_cache.getNrRequests();
+    const Size isotope_computed_before = isotope_cache.getNrComputed();
     this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
 
     // (i) Obtain precursor chromatograms (MS1) if precursor extraction is enabled
@@ -481,9 +724,13 @@ namespace OpenMS
     }
 
     if (use_ms1_traces_) ms1_map_ = loadMS1Map(swath_maps, load_into_memory);
+    if (use_ms1_traces_ && ms1_map_ != nullptr && cp.im_extraction_window > 0 && im_index_memory_ > 0)
+    {
+      ms1_map_ = boost::shared_ptr<SpectrumAccessIonMobilityIndexed>( new SpectrumAccessIonMobilityIndexed(ms1_map_, 64, im_index_memory_) );
+    }
 
-    // (ii) Precursor extraction only
-    if (ms1_only)
+    // (ii) Precursor extraction only (performed by the first shard)
+    if (ms1_only && shard_index_ == 0)
     {
       std::vector< MSChromatogram > ms1_chromatograms;
       MS1Extraction_(ms1_map_, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
@@ -537,6 +784,48 @@ namespace OpenMS
       }
     }
 
+    // Select the MS2 maps analyzed by this shard (the k-th MS2 map belongs to
+    // shard k % nr_shards_, so all shards together analyze every map once)
+    std::vector<bool> in_shard(swath_maps.size(), false);
+    for (Size i = 0, k = 0; i < swath_maps.size(); ++i)
+    {
+      if (swath_maps[i].ms1) continue;
+      in_shard[i] = (k++ % nr_shards_ == shard_index_);
+    }
+    if (nr_shards_ > 1)
+    {
+      OPENMS_LOG_INFO << "Shard " << shard_index_ + 1 << " of " << nr_shards_ << " will analyze "
+                      << std::count(in_shard.begin(), in_shard.end(), true) << " SWATH maps." << std::endl;
+    }
+
+    // If data is loaded into memory, the next maps can already be loaded in
+    // the background while the current ones are extracted and scored. Only
+    // maps that will actually be used (MS2 maps with matching transitions)
+    // are prefetched.
+    std::unique_ptr<SwathMapPrefetcher> prefetcher;
+    if (load_into_memory && prefetch_memory_ > 0)
+    {
+      std::vector<bool> used_maps(swath_maps.size(), false);
+      for (Size i = 0; i < swath_maps.size(); ++i)
+      {
+        if (!in_shard[i]) continue;
+        for (Size k = 0; k < transition_exp.transitions.size() && !used_maps[i]; k++)
+        {
+          const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
+          if (prm_)
+          {
+            used_maps[i] = (prm_map[k] == (int)i);
+          }
+          else
+          {
+            used_maps[i] = (swath_maps[i].lower < tr.getPrecursorMZ() && tr.getPrecursorMZ() < swath_maps[i].upper &&
+                            std::fabs(swath_maps[i].upper - tr.getPrecursorMZ()) >= cp.min_upper_edge_dist);
+          }
+        }
+      }
+      prefetcher.reset(new SwathMapPrefetcher(swath_maps, used_maps, prefetch_memory_));
+    }
+
     // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
     // We set dynamic scheduling such that the maps are worked on in the order
     // in which they were given to the program / acquired. This gives much
@@ -560,7 +849,7 @@ namespace OpenMS
 #endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
     {
-      if (!swath_maps[i].ms1) // skip MS1
+      if (in_shard[i]) // skip MS1 and maps of other shards
       {
 
         // Step 1: select which transitions to extract (proceed in batches)
@@ -610,11 +899,21 @@ namespace OpenMS
         {
 
           OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
+          if (prefetcher)
+          {
+            current_swath_map = prefetcher->acquire(i);
+          }
+          else if (load_into_memory)
           {
             // This creates an InMemory object that keeps all data in memory
             current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
           }
+          if (cp.im_extraction_window > 0 && im_index_memory_ > 0)
+          {
+            // Scoring repeatedly selects small drift time windows from the
+            // same spectra, index them by ion mobility once
+            current_swath_map = boost::shared_ptr<SpectrumAccessIonMobilityIndexed>( new SpectrumAccessIonMobilityIndexed(current_swath_map, 64, im_index_memory_) );
+          }
 
           int batch_size;
           if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
@@ -703,6 +1002,10 @@ namespace OpenMS
             PeakMap chrom_exp;
             extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
                                           chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+            if (lean_output_)
+            {
+              chrom_list.clear(); // only the converted chromatograms are used from here on
+            }
 
 
             // Step 3: score these extracted transitions
@@ -710,7 +1013,13 @@ namespace OpenMS
             std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
             tmp.back().sptr = current_swath_map_inner;
             scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes,
+                false, lean_output_ ? chromConsumer : nullptr);
+            if (lean_output_)
+            {
+              // the scored chromatogram segments were already written
+              chrom_exp.clear(true);
+            }
 
             // Step 4: write all chromatograms and features out into an output object / file
             // (this needs to be done in a critical section since we only have one
@@ -729,6 +1038,12 @@ namespace OpenMS
 
     }
     this->endProgress();
+
+    // clamp, so that a clear() or concurrent requests in between cannot make the differences wrap around
+    const Size isotope_requests = std::max(isotope_cache.getNrRequests(), isotope_requests_before) - isotope_requests_before;
+    const Size isotope_computed = std::min(std::max(isotope_cache.getNrComputed(), isotope_computed_before) - isotope_computed_before, isotope_requests);
+    OPENMS_LOG_INFO << "Isotope pattern cache: " << isotope_requests << " averagine patterns used, "
+                    << isotope_computed << " computed, " << isotope_requests - isotope_computed << " computations saved." << std::endl;
     
 #ifdef _OPENMP
 #ifdef MT_ENABLE_NESTED_OPENMP
@@ -823,7 +1138,8 @@ namespace OpenMS
     OpenSwathTSVWriter & tsv_writer,
     OpenSwathOSWWriter & osw_writer,
     int nr_ms1_isotopes,
-    bool ms1only) const
+    bool ms1only,
+    Interfaces::IMSDataConsumer * chromConsumer) const
   {
     TransformationDescription trafo_inv = trafo;
     trafo_inv.invert();
@@ -889,7 +1205,50 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
+    // In lean output mode, results are written every few transition groups
+    // from per-thread buffers (leftovers of an aborted call are discarded)
+    static thread_local LeanOutputPool lean_pool;
+    lean_pool.recycle();
+    lean_pool.pending_groups = 0;
+    auto write_lean_output = [&]()
+    {
+      if (tsv_writer.isActive())
+      {
+#ifdef _OPENMP
+#pragma omp critical (osw_write_tsv)
+#endif
+        {
+          tsv_writer.writeLines(lean_pool.pending_tsv);
+        }
+      }
+      if (osw_writer.isActive())
+      {
+#ifdef _OPENMP
+#pragma omp critical (osw_write_tsv)
+#endif
+        {
+          osw_writer.writeLines(lean_pool.pending_osw);
+        }
+      }
+      if (chromConsumer != nullptr)
+      {
+#ifdef _OPENMP
+#pragma omp critical (osw_write_out)
+#endif
+        {
+          for (auto& chrom : lean_pool.pending_chromatograms)
+          {
+            if (!chrom.empty()) chromConsumer->consumeChromatogram(chrom);
+          }
+        }
+      }
+      lean_pool.recycle();
+      lean_pool.pending_groups = 0;
+    };
+
     std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String>& tsv_lines = lean_output_ ? lean_pool.pending_tsv : to_tsv_output;
+    std::vector<String>& osw_lines = lean_output_ ? lean_pool.pending_osw : to_osw_output;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
@@ -923,7 +1282,8 @@ namespace OpenMS
         }
 
         // Convert chromatogram to MSChromatogram and filter
-        auto chromatogram = ms2_chromatograms[ chromatogram_map[transition->getNativeID()] ];
+        MSChromatogram chromatogram = lean_output_ ? lean_pool.acquire() : MSChromatogram();
+        chromatogram = ms2_chromatograms[ chromatogram_map[transition->getNativeID()] ];
         chromatogram.setNativeID(transition->getNativeID());
         if (rt_extraction_window > 0)
         {
@@ -938,7 +1298,7 @@ namespace OpenMS
 
         // Add the transition and the chromatogram to the MRMTransitionGroup
         transition_group.addTransition(*transition, transition->getNativeID());
-        transition_group.addChromatogram(chromatogram, chromatogram.getNativeID());
+        transition_group.addChromatogram(std::move(chromatogram), transition->getNativeID());
       }
 
       // currently .tsv, .osw and .featureXML are mutually exclusive
@@ -952,8 +1312,9 @@ namespace OpenMS
         String prec_id = OpenSwathHelper::computePrecursorId(transition_group.getTransitionGroupID(), iso);
         if (!ms1_chromatograms.empty() && ms1_chromatogram_map.find(prec_id) != ms1_chromatogram_map.end())
         {
-          MSChromatogram chromatogram = ms1_chromatograms[ ms1_chromatogram_map[prec_id] ];
-          transition_group.addPrecursorChromatogram(chromatogram, chromatogram.getNativeID());
+          MSChromatogram chromatogram = lean_output_ ? lean_pool.acquire() : MSChromatogram();
+          chromatogram = ms1_chromatograms[ ms1_chromatogram_map[prec_id] ];
+          transition_group.addPrecursorChromatogram(std::move(chromatogram), prec_id);
         }
       }
 
@@ -972,20 +1333,44 @@ namespace OpenMS
       if (tsv_writer.isActive() && output.size() > 0) // implies that detection_assay_it was set
       {
         const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
-        to_tsv_output.push_back(tsv_writer.prepareLine(pep, detection_assay_it, output, id));
+        tsv_lines.push_back(tsv_writer.prepareLine(pep, detection_assay_it, output, id));
       }
 
       // 6. Add to the output osw if given
       if (osw_writer.isActive() && output.size() > 0) // implies that detection_assay_it was set
       {
         const OpenSwath::LightCompound pep;
-        to_osw_output.push_back(osw_writer.prepareLine(OpenSwath::LightCompound(), // not used currently: transition_exp.getCompounds()[ assay_peptide_map[id] ],
-                                                       nullptr, // not used currently: detection_assay_it,
-                                                       output,
-                                                       id));
+        osw_lines.push_back(osw_writer.prepareLine(OpenSwath::LightCompound(), // not used currently: transition_exp.getCompounds()[ assay_peptide_map[id] ],
+                                                   nullptr, // not used currently: detection_assay_it,
+                                                   output,
+                                                   id));
+      }
+
+      // 7. In lean output mode, keep only the (RT-filtered) chromatograms
+      // that still need to be written and recycle the group's storage
+      if (lean_output_)
+      {
+        for (auto& chrom : transition_group.getChromatograms())
+        {
+          lean_pool.pending_chromatograms.push_back(std::move(chrom));
+        }
+        for (auto& chrom : transition_group.getPrecursorChromatograms())
+        {
+          lean_pool.release(std::move(chrom)); // MS1 chromatograms were written at extraction
+        }
+        if (++lean_pool.pending_groups >= LeanOutputPool::flush_interval)
+        {
+          write_lean_output();
+        }
       }
     }
 
+    if (lean_output_)
+    {
+      write_lean_output();
+      return;
+    }
+
     // Only write at the very end since this is a step that needs a barrier
     if (tsv_writer.isActive())
     {
@@ -57,6 +57,8 @@ namespace OpenMS
 
     defaults_.setValue("sn_win_len", 1000.0, "Signal to noise window length.");
     defaults_.setValue("sn_bin_count", 30, "Signal to noise bin count.");
+    defaults_.setValue("sn_estimator", "histogram", "Noise estimate of the signal to noise window: the median of a histogram of the intensities ('histogram', uses 'sn_bin_count') or the exact median of the intensities ('exact').", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("sn_estimator", ListUtils::create<String>("histogram,exact"));
     defaults_.setValue("write_sn_log_messages", "false", "Write out log messages of the signal-to-noise estimator in case of sparse windows or median in rightmost histogram bin");
     defaults_.setValidStrings("write_sn_log_messages", ListUtils::create<String>("true,false"));
 
@@ -181,9 +183,11 @@ namespace OpenMS
     left_width_.reserve(picked_chrom.size());
     right_width_.reserve(picked_chrom.size());
 
+    SignalToNoiseEstimator<MSChromatogram>& snt = sn_estimator_exact_ ?
+      static_cast<SignalToNoiseEstimator<MSChromatogram>&>(snt_exact_) : snt_;
     if (signal_to_noise_ > 0.0)
     {
-      snt_.init(chromatogram);
+      snt.init(chromatogram);
     }
     Size current_peak = 0;
     for (Size i = 0; i < picked_chrom.size(); i++)
@@ -198,7 +202,7 @@ namespace OpenMS
              //&& std::fabs(chromatogram[min_i-k].getMZ() - peak_raw_data.begin()->first) < spacing_difference*min_spacing
             && (chromatogram[min_i - k].getIntensity() < chromatogram[min_i - k + 1].getIntensity()
                || (peak_width_ > 0.0 && std::fabs(chromatogram[min_i - k].getRT() - central_peak_rt) < peak_width_))
-            && (signal_to_noise_ <= 0.0 || snt_.getSignalToNoise(min_i - k) >= signal_to_noise_))
+            && (signal_to_noise_ <= 0.0 || snt.getSignalToNoise(min_i - k) >= signal_to_noise_))
       {
         ++k;
       }
@@ -210,7 +214,7 @@ namespace OpenMS
              //&& std::fabs(chromatogram[min_i+k].getMZ() - peak_raw_data.rbegin()->first) < spacing_difference*min_spacing
             && (chromatogram[min_i + k].getIntensity() < chromatogram[min_i + k - 1].getIntensity()
                || (peak_width_ > 0.0 && std::fabs(chromatogram[min_i + k].getRT() - central_peak_rt) < peak_width_))
-            && (signal_to_noise_ <= 0.0 || snt_.getSignalToNoise(min_i + k) >= signal_to_noise_) )
+            && (signal_to_noise_ <= 0.0 || snt.getSignalToNoise(min_i + k) >= signal_to_noise_) )
       {
         ++k;
       }
@@ -408,6 +412,7 @@ namespace OpenMS
     signal_to_noise_ = (double)param_.getValue("signal_to_noise");
     sn_win_len_ = (double)param_.getValue("sn_win_len");
     sn_bin_count_ = (UInt)param_.getValue("sn_bin_count");
+    sn_estimator_exact_ = param_.getValue("sn_estimator") == "exact";
     // TODO make list, not boolean
     use_gauss_ = (bool)param_.getValue("use_gauss").toBool();
     remove_overlapping_ = (bool)param_.getValue("remove_overlapping_peaks").toBool();
@@ -435,6 +440,16 @@ namespace OpenMS
     snt_parameters.setValue("write_log_messages", param_.getValue("write_sn_log_messages"));
     snt_.setParameters(snt_parameters);
 
+    Param snt_exact_parameters = snt_exact_.getParameters();
+    snt_exact_parameters.setValue("win_len", sn_win_len_);
+    snt_exact_parameters.setValue("write_log_messages", param_.getValue("write_sn_log_messages"));
+    snt_exact_.setParameters(snt_exact_parameters);
+
+    // the peak picker that finds the initial seeds
+    Param pepi_param = pp_.getParameters();
+    pepi_param.setValue("SignalToNoise:estimator", param_.getValue("sn_estimator"));
+    pp_.setParameters(pepi_param);
+
 #ifndef WITH_CRAWDAD
     if (method_ == "crawdad")
     {
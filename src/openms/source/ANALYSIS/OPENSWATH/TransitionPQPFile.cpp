@@ -117,6 +117,30 @@ namespace OpenMS
     bool adducts_exists = SqliteConnector::columnExists(db, "COMPOUND", "ADDUCTS");
     if (adducts_exists) select_adducts = "COMPOUND.ADDUCTS AS Adducts, ";
 
+    // PQP files do not contain indices on the mapping tables and SQLite may
+    // then choose a join order which scans a whole mapping table for each
+    // peptide (quadratic in the library size). Read the mapping tables and the
+    // aggregated protein / peptidoform lists once into indexed temporary
+    // tables (the input file is not modified) which are used in the joins
+    // below. The result (including its order) is the same.
+    conn.executeStatement(
+      "CREATE TEMP TABLE TMP_TRANSITION_PRECURSOR_MAPPING AS SELECT TRANSITION_ID, PRECURSOR_ID FROM TRANSITION_PRECURSOR_MAPPING; " \
+      "CREATE INDEX temp.IDX_TMP_TRANSITION_PRECURSOR_MAPPING ON TMP_TRANSITION_PRECURSOR_MAPPING(PRECURSOR_ID); " \
+      "CREATE TEMP TABLE TMP_PRECURSOR_PEPTIDE_MAPPING AS SELECT PRECURSOR_ID, PEPTIDE_ID FROM PRECURSOR_PEPTIDE_MAPPING; " \
+      "CREATE INDEX temp.IDX_TMP_PRECURSOR_PEPTIDE_MAPPING ON TMP_PRECURSOR_PEPTIDE_MAPPING(PRECURSOR_ID); " \
+      "CREATE TEMP TABLE TMP_PROTEIN_AGGREGATED(PEPTIDE_ID INTEGER PRIMARY KEY, PROTEIN_ACCESSION TEXT); " \
+      "INSERT INTO TMP_PROTEIN_AGGREGATED " \
+        "SELECT PEPTIDE_ID, GROUP_CONCAT(PROTEIN_ACCESSION,';') AS PROTEIN_ACCESSION " \
+        "FROM PROTEIN " \
+        "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID "\
+        "GROUP BY PEPTIDE_ID; " \
+      "CREATE TEMP TABLE TMP_PEPTIDE_AGGREGATED(TRANSITION_ID INTEGER PRIMARY KEY, PEPTIDOFORMS TEXT); " \
+      "INSERT INTO TMP_PEPTIDE_AGGREGATED " \
+        "SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
+        "FROM TRANSITION_PEPTIDE_MAPPING "\
+        "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
+        "GROUP BY TRANSITION_ID;");
+
     // Get peptides
     select_sql = "SELECT " \
                   "PRECURSOR.PRECURSOR_MZ AS precursor, " \
@@ -152,22 +176,12 @@ namespace OpenMS
                   select_gene + \
                   "FROM PRECURSOR " + \
                   join_gene + \
-                  "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
+                  "INNER JOIN TMP_TRANSITION_PRECURSOR_MAPPING AS TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
-                  "INNER JOIN PRECURSOR_PEPTIDE_MAPPING ON PRECURSOR.ID = PRECURSOR_PEPTIDE_MAPPING.PRECURSOR_ID " \
+                  "INNER JOIN TMP_PRECURSOR_PEPTIDE_MAPPING AS PRECURSOR_PEPTIDE_MAPPING ON PRECURSOR.ID = PRECURSOR_PEPTIDE_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN PEPTIDE ON PRECURSOR_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID " \
-                  "INNER JOIN " \
-                    "(SELECT PEPTIDE_ID, GROUP_CONCAT(PROTEIN_ACCESSION,';') AS PROTEIN_ACCESSION " \
-                    "FROM PROTEIN " \
-                    "INNER JOIN PEPTIDE_PROTEIN_MAPPING ON PROTEIN.ID = PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID "\
-                    "GROUP BY PEPTIDE_ID) " \
-                    "AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " \
-                  "LEFT OUTER JOIN " \
-                    "(SELECT TRANSITION_ID, GROUP_CONCAT(MODIFIED_SEQUENCE,'|') AS PEPTIDOFORMS " \
-                    "FROM TRANSITION_PEPTIDE_MAPPING "\
-                    "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
-                    "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                  "INNER JOIN TMP_PROTEIN_AGGREGATED AS PROTEIN_AGGREGATED ON PEPTIDE.ID = PROTEIN_AGGREGATED.PEPTIDE_ID " \
+                  "LEFT OUTER JOIN TMP_PEPTIDE_AGGREGATED AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -203,7 +217,7 @@ namespace OpenMS
                   select_drift_time +
                   select_gene_null +
                   "FROM PRECURSOR " \
-                  "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
+                  "INNER JOIN TMP_TRANSITION_PRECURSOR_MAPPING AS TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
@@ -215,6 +229,7 @@ namespace OpenMS
     endProgress();
 
     Size progress = 0;
+    transition_list.reserve(transition_list.size() + num_transitions);
     startProgress(0, num_transitions, "reading PQP file");
     // Convert SQLite data to TSVTransition data structure
     while (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
@@ -258,7 +273,7 @@ namespace OpenMS
 
       if (mytransition.GeneName == "NA") mytransition.GeneName = "";
 
-      transition_list.push_back(mytransition);
+      transition_list.push_back(std::move(mytransition));
       sqlite3_step( stmt );
     }
     endProgress();
@@ -40,6 +40,9 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/TextFile.h>
 
+#include <exception>
+#include <unordered_set>
+
 namespace OpenMS
 {
 
@@ -117,6 +120,8 @@ namespace OpenMS
     defaults_.setValidStrings("override_group_label_check", ListUtils::create<String>("true,false"));
     defaults_.setValue("force_invalid_mods", "false", "Force reading even if invalid modifications are encountered (OpenMS may not recognize the modification)", ListUtils::create<String>("advanced"));
     defaults_.setValidStrings("force_invalid_mods", ListUtils::create<String>("true,false"));
+    defaults_.setValue("chunk_size", 100000, "Number of lines of a TSV/CSV file which are read at once and parsed in parallel.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("chunk_size", 1);
 
     // write defaults into Param object param_
     defaultsToParam_();
@@ -132,6 +137,7 @@ namespace OpenMS
     retentionTimeInterpretation_ = param_.getValue("retentionTimeInterpretation");
     override_group_label_check_ = param_.getValue("override_group_label_check").toBool();
     force_invalid_mods_ = param_.getValue("force_invalid_mods").toBool();
+    chunk_size_ = (Size)(int)param_.getValue("chunk_size");
   }
 
   const std::vector<std::string> TransitionTSVFile::header_names_ = 
@@ -219,10 +225,8 @@ namespace OpenMS
   {
     std::ifstream data(filename);
     std::string   line;
-    std::string   tmp;
 
     // read header
-    std::vector<std::string>   tmp_line;
     std::map<std::string, int> header_dict;
     char delimiter = ',';
 
@@ -250,245 +254,307 @@ namespace OpenMS
     {
       TextFile::getLine(data, line);
       getTSVHeader_(line, delimiter, header_dict);
+      if (header_dict.find("PrecursorMz") == header_dict.end())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                         "Expected a header named PrecursorMz but found none");
+      }
     }
 
+    // Read the file in chunks of lines and parse the lines of each chunk in
+    // parallel. The transitions are stored in the order of the file,
+    // independent of the number of threads.
+    std::vector<std::string> lines;
+    lines.reserve(chunk_size_);
     bool spectrast_legacy = false; // we will check below if SpectraST was run in legacy (<5.0) mode or if the RT normalization was forgotten.
     int cnt = 0;
-    while (TextFile::getLine(data, line)) // make sure line endings are handled correctly
+    bool end_of_file = false;
+    while (!end_of_file)
     {
-      line.push_back(delimiter); // avoid losing last column if it is empty
-      std::stringstream lineStream(line);
-
-      while (std::getline(lineStream, tmp, delimiter)) // default getline is fine here, we only want to split the line
+      lines.clear();
+      while (lines.size() < chunk_size_ && TextFile::getLine(data, line)) // make sure line endings are handled correctly
       {
-        tmp_line.push_back(tmp);
+        lines.push_back(std::move(line));
       }
-      cnt++;
-
-#ifdef TRANSITIONTSVREADER_TESTING
-      for (Size i = 0; i < tmp_line.size(); i++)
+      end_of_file = lines.size() < chunk_size_;
+
+      std::vector<TSVTransition> chunk(lines.size());
+      std::vector<char> skip_transition(lines.size(), false);
+      std::exception_ptr error;
+      SignedSize error_line = lines.size();
+      bool chunk_spectrast_legacy = false;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1000) reduction(||: chunk_spectrast_legacy)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)lines.size(); ++i)
       {
-        std::cout << "line " << i << " " << tmp_line[i] << std::endl;
+        try
+        {
+          bool line_spectrast_legacy = false;
+          skip_transition[i] = parseTSVLine_(lines[i], cnt + (int)i + 1, delimiter, filetype, header_dict, chunk[i], line_spectrast_legacy);
+          chunk_spectrast_legacy = chunk_spectrast_legacy || line_spectrast_legacy;
+        }
+        catch (...)
+        {
+          // report the first erroneous line (exceptions cannot leave the parallel region)
+#ifdef _OPENMP
+#pragma omp critical (TransitionTSVFile_readUnstructuredTSVInput)
+#endif
+          if (i < error_line)
+          {
+            error_line = i;
+            error = std::current_exception();
+          }
+        }
       }
-
-      for (const auto& iter : header_dict)
+      if (error)
       {
-        std::cout << "header " << iter.first << " " << iter.second << std::endl;
+        std::rethrow_exception(error);
       }
-#endif
+      spectrast_legacy = spectrast_legacy || chunk_spectrast_legacy;
 
-      if (tmp_line.size() != header_dict.size())
+      for (Size i = 0; i < chunk.size(); ++i)
       {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Error reading the file on line " + String(cnt) + ": length of the header and length of the line" +
-                                         " do not match: " + String(tmp_line.size()) + " != " + String(header_dict.size()));
+        if (!skip_transition[i])
+        {
+          transition_list.push_back(std::move(chunk[i]));
+        }
       }
+      cnt += (int)lines.size();
+    }
+
+    if (spectrast_legacy && retentionTimeInterpretation_ == "iRT")
+    {
+      std::cout << "Warning: SpectraST was not run in RT normalization mode but the converted list was interpreted to have iRT units. Check whether you need to adapt the parameter -algorithm:retentionTimeInterpretation. You can ignore this warning if you used a legacy SpectraST 4.0 file." << std::endl;
 
-      TSVTransition mytransition;
-      bool skip_transition = false; // skip unannotated transitions in SpectraST MRM files
+    }
+  }
 
-      //// Required columns (they are guaranteed to be present, see getTSVHeader_)
-      // PrecursorMz
-      mytransition.precursor = String(tmp_line[header_dict["PrecursorMz"]]).toDouble();
+  bool TransitionTSVFile::parseTSVLine_(const std::string& line, int line_nr, char delimiter, FileTypes::Type filetype,
+                                        const std::map<std::string, int>& header_dict, TSVTransition& mytransition, bool& spectrast_legacy)
+  {
+    // split the line (an empty last column is kept)
+    std::vector<std::string> tmp_line;
+    tmp_line.reserve(header_dict.size());
+    Size field_start = 0;
+    for (Size pos = line.find(delimiter); pos != std::string::npos; pos = line.find(delimiter, field_start))
+    {
+      tmp_line.emplace_back(line, field_start, pos - field_start);
+      field_start = pos + 1;
+    }
+    tmp_line.emplace_back(line, field_start, std::string::npos);
 
-      // ProductMz
-      if (!extractName<double>(mytransition.product, "ProductMz", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.product, "FragmentMz", tmp_line, header_dict)) // Spectronaut
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Expected a header named ProductMz or FragmentMz but found none");
-      }
+#ifdef TRANSITIONTSVREADER_TESTING
+    for (Size i = 0; i < tmp_line.size(); i++)
+    {
+      std::cout << "line " << i << " " << tmp_line[i] << std::endl;
+    }
+
+    for (const auto& iter : header_dict)
+    {
+      std::cout << "header " << iter.first << " " << iter.second << std::endl;
+    }
+#endif
+
+    if (tmp_line.size() != header_dict.size())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "Error reading the file on line " + String(line_nr) + ": length of the header and length of the line" +
+                                       " do not match: " + String(tmp_line.size()) + " != " + String(header_dict.size()));
+    }
+
+    bool skip_transition = false; // skip unannotated transitions in SpectraST MRM files
+
+    //// Required columns (they are guaranteed to be present, see getTSVHeader_)
+    // PrecursorMz
+    mytransition.precursor = String(tmp_line[header_dict.at("PrecursorMz")]).toDouble();
+
+    // ProductMz
+    if (!extractName<double>(mytransition.product, "ProductMz", tmp_line, header_dict) &&
+        !extractName<double>(mytransition.product, "FragmentMz", tmp_line, header_dict)) // Spectronaut
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "Expected a header named ProductMz or FragmentMz but found none");
+    }
+
+    // LibraryIntensity
+    if (!extractName<double>(mytransition.library_intensity, "LibraryIntensity", tmp_line, header_dict) &&
+        !extractName<double>(mytransition.library_intensity, "RelativeIntensity", tmp_line, header_dict) && // Spectronaut
+        !extractName<double>(mytransition.library_intensity, "RelativeFragmentIntensity", tmp_line, header_dict)) // Spectronaut
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "Expected a header named LibraryIntensity or RelativeFragmentIntensity but found none");
+    }
 
-      // LibraryIntensity
-      if (!extractName<double>(mytransition.library_intensity, "LibraryIntensity", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.library_intensity, "RelativeIntensity", tmp_line, header_dict) && // Spectronaut
-          !extractName<double>(mytransition.library_intensity, "RelativeFragmentIntensity", tmp_line, header_dict)) // Spectronaut
+    //// Additional columns for both proteomics and metabolomics
+    // NormalizedRetentionTime
+    if (!extractName<double>(mytransition.rt_calibrated, "RetentionTimeCalculatorScore", tmp_line, header_dict) && // Skyline
+        !extractName<double>(mytransition.rt_calibrated, "iRT", tmp_line, header_dict) && // Spectronaut
+        !extractName<double>(mytransition.rt_calibrated, "NormalizedRetentionTime", tmp_line, header_dict) &&
+        !extractName<double>(mytransition.rt_calibrated, "RetentionTime", tmp_line, header_dict) &&
+        !extractName<double>(mytransition.rt_calibrated, "Tr_recalibrated", tmp_line, header_dict))
+    {
+      if (header_dict.find("SpectraSTRetentionTime") != header_dict.end())
       {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Expected a header named LibraryIntensity or RelativeFragmentIntensity but found none");
+        spectrastRTExtract(tmp_line[header_dict.at("SpectraSTRetentionTime")], mytransition.rt_calibrated, spectrast_legacy);
       }
-
-      //// Additional columns for both proteomics and metabolomics
-      // NormalizedRetentionTime
-      if (!extractName<double>(mytransition.rt_calibrated, "RetentionTimeCalculatorScore", tmp_line, header_dict) && // Skyline
-          !extractName<double>(mytransition.rt_calibrated, "iRT", tmp_line, header_dict) && // Spectronaut
-          !extractName<double>(mytransition.rt_calibrated, "NormalizedRetentionTime", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.rt_calibrated, "RetentionTime", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.rt_calibrated, "Tr_recalibrated", tmp_line, header_dict))
+      else
       {
-        if (header_dict.find("SpectraSTRetentionTime") != header_dict.end())
-        {
-          spectrastRTExtract(tmp_line[header_dict["SpectraSTRetentionTime"]], mytransition.rt_calibrated, spectrast_legacy);
-        }
-        else
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                           "Expected a header named RetentionTime, NormalizedRetentionTime, iRT, RetentionTimeCalculatorScore, Tr_recalibrated or SpectraSTRetentionTime but found none");
-        }
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                         "Expected a header named RetentionTime, NormalizedRetentionTime, iRT, RetentionTimeCalculatorScore, Tr_recalibrated or SpectraSTRetentionTime but found none");
       }
+    }
 
-      // PrecursorCharge
-      void(!extractName(mytransition.precursor_charge, "PrecursorCharge", tmp_line, header_dict) &&
-      !extractName(mytransition.precursor_charge, "Charge", tmp_line, header_dict)); // charge is assumed to be the charge of the precursor
+    // PrecursorCharge
+    void(!extractName(mytransition.precursor_charge, "PrecursorCharge", tmp_line, header_dict) &&
+    !extractName(mytransition.precursor_charge, "Charge", tmp_line, header_dict)); // charge is assumed to be the charge of the precursor
 
-      void(!extractName(mytransition.fragment_type, "FragmentType", tmp_line, header_dict) &&
-      !extractName(mytransition.fragment_type, "FragmentIonType", tmp_line, header_dict)); // Skyline
+    void(!extractName(mytransition.fragment_type, "FragmentType", tmp_line, header_dict) &&
+    !extractName(mytransition.fragment_type, "FragmentIonType", tmp_line, header_dict)); // Skyline
 
-      void(!extractName(mytransition.fragment_charge, "FragmentCharge", tmp_line, header_dict) &&
-      !extractName(mytransition.fragment_charge, "ProductCharge", tmp_line, header_dict));
+    void(!extractName(mytransition.fragment_charge, "FragmentCharge", tmp_line, header_dict) &&
+    !extractName(mytransition.fragment_charge, "ProductCharge", tmp_line, header_dict));
 
-      void(!extractName<int>(mytransition.fragment_nr, "FragmentSeriesNumber", tmp_line, header_dict) &&
-      !extractName<int>(mytransition.fragment_nr, "FragmentNumber", tmp_line, header_dict) &&
-      !extractName<int>(mytransition.fragment_nr, "FragmentIonOrdinal", tmp_line, header_dict));
+    void(!extractName<int>(mytransition.fragment_nr, "FragmentSeriesNumber", tmp_line, header_dict) &&
+    !extractName<int>(mytransition.fragment_nr, "FragmentNumber", tmp_line, header_dict) &&
+    !extractName<int>(mytransition.fragment_nr, "FragmentIonOrdinal", tmp_line, header_dict));
 
-      void(extractName<double>(mytransition.drift_time, "PrecursorIonMobility", tmp_line, header_dict));
-      void(extractName<double>(mytransition.fragment_mzdelta, "FragmentMzDelta", tmp_line, header_dict));
-      void(extractName<int>(mytransition.fragment_modification, "FragmentModification", tmp_line, header_dict));
+    void(extractName<double>(mytransition.drift_time, "PrecursorIonMobility", tmp_line, header_dict));
+    void(extractName<double>(mytransition.fragment_mzdelta, "FragmentMzDelta", tmp_line, header_dict));
+    void(extractName<int>(mytransition.fragment_modification, "FragmentModification", tmp_line, header_dict));
 
-      //// Proteomics
-      extractName(mytransition.GeneName, "GeneName", tmp_line, header_dict);
+    //// Proteomics
+    extractName(mytransition.GeneName, "GeneName", tmp_line, header_dict);
 
-      String proteins;
-      void(!extractName(proteins, "ProteinName", tmp_line, header_dict) &&
-      !extractName(proteins, "ProteinId", tmp_line, header_dict)); // Spectronaut
-      if (proteins != "NA" && proteins != "")
-      {
-        proteins.split(';', mytransition.ProteinName);
-      }
+    String proteins;
+    void(!extractName(proteins, "ProteinName", tmp_line, header_dict) &&
+    !extractName(proteins, "ProteinId", tmp_line, header_dict)); // Spectronaut
+    if (proteins != "NA" && proteins != "")
+    {
+      proteins.split(';', mytransition.ProteinName);
+    }
 
-      void(extractName(mytransition.peptide_group_label, "PeptideGroupLabel", tmp_line, header_dict));
+    void(extractName(mytransition.peptide_group_label, "PeptideGroupLabel", tmp_line, header_dict));
 
-      void(extractName(mytransition.label_type, "LabelType", tmp_line, header_dict));
+    void(extractName(mytransition.label_type, "LabelType", tmp_line, header_dict));
 
-      void(!extractName(mytransition.PeptideSequence, "PeptideSequence", tmp_line, header_dict) &&
-      !extractName(mytransition.PeptideSequence, "Sequence", tmp_line, header_dict) && // Skyline
-      !extractName(mytransition.PeptideSequence, "StrippedSequence", tmp_line, header_dict)); // Spectronaut
+    void(!extractName(mytransition.PeptideSequence, "PeptideSequence", tmp_line, header_dict) &&
+    !extractName(mytransition.PeptideSequence, "Sequence", tmp_line, header_dict) && // Skyline
+    !extractName(mytransition.PeptideSequence, "StrippedSequence", tmp_line, header_dict)); // Spectronaut
 
-      void(!extractName(mytransition.FullPeptideName, "FullUniModPeptideName", tmp_line, header_dict) &&
-      !extractName(mytransition.FullPeptideName, "FullPeptideName", tmp_line, header_dict) &&
-      !extractName(mytransition.FullPeptideName, "ModifiedSequence", tmp_line, header_dict) && // Spectronaut
-      !extractName(mytransition.FullPeptideName, "ModifiedPeptideSequence", tmp_line, header_dict));
+    void(!extractName(mytransition.FullPeptideName, "FullUniModPeptideName", tmp_line, header_dict) &&
+    !extractName(mytransition.FullPeptideName, "FullPeptideName", tmp_line, header_dict) &&
+    !extractName(mytransition.FullPeptideName, "ModifiedSequence", tmp_line, header_dict) && // Spectronaut
+    !extractName(mytransition.FullPeptideName, "ModifiedPeptideSequence", tmp_line, header_dict));
 
-      //// IPF
-      String peptidoforms;
-      void(!extractName<bool>(mytransition.detecting_transition, "detecting_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.detecting_transition, "DetectingTransition", tmp_line, header_dict));
+    //// IPF
+    String peptidoforms;
+    void(!extractName<bool>(mytransition.detecting_transition, "detecting_transition", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.detecting_transition, "DetectingTransition", tmp_line, header_dict));
 
-      void(!extractName<bool>(mytransition.identifying_transition, "identifying_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.identifying_transition, "IdentifyingTransition", tmp_line, header_dict));
+    void(!extractName<bool>(mytransition.identifying_transition, "identifying_transition", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.identifying_transition, "IdentifyingTransition", tmp_line, header_dict));
 
-      void(!extractName<bool>(mytransition.quantifying_transition, "quantifying_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.quantifying_transition, "QuantifyingTransition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.quantifying_transition, "Quantitative", tmp_line, header_dict)); // Skyline
+    void(!extractName<bool>(mytransition.quantifying_transition, "quantifying_transition", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.quantifying_transition, "QuantifyingTransition", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.quantifying_transition, "Quantitative", tmp_line, header_dict)); // Skyline
 
-      void(extractName(peptidoforms, "Peptidoforms", tmp_line, header_dict));
-      peptidoforms.split('|', mytransition.peptidoforms);
+    void(extractName(peptidoforms, "Peptidoforms", tmp_line, header_dict));
+    peptidoforms.split('|', mytransition.peptidoforms);
 
-      //// Targeted Metabolomics
-      void(extractName(mytransition.CompoundName, "CompoundName", tmp_line, header_dict));
-      void(extractName(mytransition.SumFormula, "SumFormula", tmp_line, header_dict));
-      void(extractName(mytransition.SMILES, "SMILES", tmp_line, header_dict));
-      void(extractName(mytransition.Adducts, "Adducts", tmp_line, header_dict));
+    //// Targeted Metabolomics
+    void(extractName(mytransition.CompoundName, "CompoundName", tmp_line, header_dict));
+    void(extractName(mytransition.SumFormula, "SumFormula", tmp_line, header_dict));
+    void(extractName(mytransition.SMILES, "SMILES", tmp_line, header_dict));
+    void(extractName(mytransition.Adducts, "Adducts", tmp_line, header_dict));
 
-      //// Meta
-      void(extractName(mytransition.Annotation, "Annotation", tmp_line, header_dict));
-      
-      // UniprotId
-      String uniprot_ids;
-      void(!extractName(uniprot_ids, "UniprotId", tmp_line, header_dict) &&
-      !extractName(uniprot_ids, "UniprotID", tmp_line, header_dict));
-      if (uniprot_ids != "NA" && uniprot_ids != "")
-      {
-        uniprot_ids.split(';', mytransition.uniprot_id);
-      }
+    //// Meta
+    void(extractName(mytransition.Annotation, "Annotation", tmp_line, header_dict));
+    
+    // UniprotId
+    String uniprot_ids;
+    void(!extractName(uniprot_ids, "UniprotId", tmp_line, header_dict) &&
+    !extractName(uniprot_ids, "UniprotID", tmp_line, header_dict));
+    if (uniprot_ids != "NA" && uniprot_ids != "")
+    {
+      uniprot_ids.split(';', mytransition.uniprot_id);
+    }
 
-      void(!extractName<double>(mytransition.CE, "CE", tmp_line, header_dict) &&
-      !extractName<double>(mytransition.CE, "CollisionEnergy", tmp_line, header_dict));
+    void(!extractName<double>(mytransition.CE, "CE", tmp_line, header_dict) &&
+    !extractName<double>(mytransition.CE, "CollisionEnergy", tmp_line, header_dict));
 
-      // Decoy
-      void(!extractName<bool>(mytransition.decoy, "decoy", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.decoy, "Decoy", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.decoy, "IsDecoy", tmp_line, header_dict));
+    // Decoy
+    void(!extractName<bool>(mytransition.decoy, "decoy", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.decoy, "Decoy", tmp_line, header_dict) &&
+    !extractName<bool>(mytransition.decoy, "IsDecoy", tmp_line, header_dict));
 
-      if (header_dict.find("SpectraSTAnnotation") != header_dict.end())
-      {
-        skip_transition = spectrastAnnotationExtract(tmp_line[header_dict["SpectraSTAnnotation"]], mytransition);
-      }
+    if (header_dict.find("SpectraSTAnnotation") != header_dict.end())
+    {
+      skip_transition = spectrastAnnotationExtract(tmp_line[header_dict.at("SpectraSTAnnotation")], mytransition);
+    }
 
-      //// Generate Group IDs
-      // SpectraST
-      if (filetype == FileTypes::MRM)
-      {
-        std::vector<String> substrings;
-        String(tmp_line[header_dict["SpectraSTFullPeptideName"]]).split("/", substrings);
-        AASequence peptide = AASequence::fromString(substrings[0]);
+    //// Generate Group IDs
+    // SpectraST
+    if (filetype == FileTypes::MRM)
+    {
+      std::vector<String> substrings;
+      String(tmp_line[header_dict.at("SpectraSTFullPeptideName")]).split("/", substrings);
+      AASequence peptide = AASequence::fromString(substrings[0]);
 
-        mytransition.FullPeptideName = peptide.toString();
-        mytransition.PeptideSequence = peptide.toUnmodifiedString();
-        mytransition.precursor_charge = substrings[1];
+      mytransition.FullPeptideName = peptide.toString();
+      mytransition.PeptideSequence = peptide.toUnmodifiedString();
+      mytransition.precursor_charge = substrings[1];
 
-        mytransition.transition_name = String(cnt);
+      mytransition.transition_name = String(line_nr);
 
-        mytransition.group_id = mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
-      }
-      // Generate transition_group_id and transition_name if not defined
-      else
+      mytransition.group_id = mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
+    }
+    // Generate transition_group_id and transition_name if not defined
+    else
+    {
+      // Use TransitionId if available, else generate from attributes
+      if (!extractName(mytransition.transition_name, "transition_name", tmp_line, header_dict) &&
+          !extractName(mytransition.transition_name, "TransitionName", tmp_line, header_dict) &&
+          !extractName(mytransition.transition_name, "TransitionId", tmp_line, header_dict))
       {
-        // Use TransitionId if available, else generate from attributes
-        if (!extractName(mytransition.transition_name, "transition_name", tmp_line, header_dict) &&
-            !extractName(mytransition.transition_name, "TransitionName", tmp_line, header_dict) &&
-            !extractName(mytransition.transition_name, "TransitionId", tmp_line, header_dict))
-        {
-          mytransition.transition_name = String(cnt);
-        }
-
-        // Use TransitionGroupId if available, else generate from attributes
-        if (!extractName(mytransition.group_id, "transition_group_id", tmp_line, header_dict) &&
-            !extractName(mytransition.group_id, "TransitionGroupId", tmp_line, header_dict) &&
-            !extractName(mytransition.group_id, "TransitionGroupName", tmp_line, header_dict))
-        {
-          mytransition.group_id = AASequence::fromString(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
-        }
+        mytransition.transition_name = String(line_nr);
       }
 
-      cleanupTransitions_(mytransition);
-
-      if (!skip_transition)
+      // Use TransitionGroupId if available, else generate from attributes
+      if (!extractName(mytransition.group_id, "transition_group_id", tmp_line, header_dict) &&
+          !extractName(mytransition.group_id, "TransitionGroupId", tmp_line, header_dict) &&
+          !extractName(mytransition.group_id, "TransitionGroupName", tmp_line, header_dict))
       {
-        transition_list.push_back(mytransition);
+        mytransition.group_id = AASequence::fromString(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
       }
+    }
+
+    cleanupTransitions_(mytransition);
 
 #ifdef TRANSITIONTSVREADER_TESTING
-      std::cout << mytransition.precursor << std::endl;
-      std::cout << mytransition.product << std::endl;
-      std::cout << mytransition.rt_calibrated << std::endl;
-      std::cout << mytransition.transition_name << std::endl;
-      std::cout << mytransition.CE << std::endl;
-      std::cout << mytransition.library_intensity << std::endl;
-      std::cout << mytransition.group_id << std::endl;
-      std::cout << mytransition.decoy << std::endl;
-      std::cout << mytransition.PeptideSequence << std::endl;
-      std::cout << mytransition.ProteinName << std::endl;
-      std::cout << mytransition.Annotation << std::endl;
-      std::cout << mytransition.FullPeptideName << std::endl;
-      std::cout << mytransition.precursor_charge << std::endl;
-      std::cout << mytransition.peptide_group_label << std::endl;
-      std::cout << mytransition.fragment_charge << std::endl;
-      std::cout << mytransition.fragment_nr << std::endl;
-      std::cout << mytransition.fragment_mzdelta << std::endl;
-      std::cout << mytransition.fragment_modification << std::endl;
-      std::cout << mytransition.fragment_type << std::endl;
-      std::cout << mytransition.uniprot_id << std::endl;
+    std::cout << mytransition.precursor << std::endl;
+    std::cout << mytransition.product << std::endl;
+    std::cout << mytransition.rt_calibrated << std::endl;
+    std::cout << mytransition.transition_name << std::endl;
+    std::cout << mytransition.CE << std::endl;
+    std::cout << mytransition.library_intensity << std::endl;
+    std::cout << mytransition.group_id << std::endl;
+    std::cout << mytransition.decoy << std::endl;
+    std::cout << mytransition.PeptideSequence << std::endl;
+    std::cout << mytransition.ProteinName << std::endl;
+    std::cout << mytransition.Annotation << std::endl;
+    std::cout << mytransition.FullPeptideName << std::endl;
+    std::cout << mytransition.precursor_charge << std::endl;
+    std::cout << mytransition.peptide_group_label << std::endl;
+    std::cout << mytransition.fragment_charge << std::endl;
+    std::cout << mytransition.fragment_nr << std::endl;
+    std::cout << mytransition.fragment_mzdelta << std::endl;
+    std::cout << mytransition.fragment_modification << std::endl;
+    std::cout << mytransition.fragment_type << std::endl;
+    std::cout << mytransition.uniprot_id << std::endl;
 #endif
 
-      tmp_line.clear();
-    }
-
-    if (spectrast_legacy && retentionTimeInterpretation_ == "iRT")
-    {
-      std::cout << "Warning: SpectraST was not run in RT normalization mode but the converted list was interpreted to have iRT units. Check whether you need to adapt the parameter -algorithm:retentionTimeInterpretation. You can ignore this warning if you used a legacy SpectraST 4.0 file." << std::endl;
-
-    }
+    return skip_transition;
   }
 
   void TransitionTSVFile::spectrastRTExtract(const String str_inp, double & value, bool & spectrast_legacy)
@@ -674,10 +740,11 @@ namespace OpenMS
 
   void TransitionTSVFile::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
+    std::unordered_set<String> compound_ids;
+    std::unordered_set<String> protein_ids;
 
     resolveMixedSequenceGroups_(transition_list);
+    exp.transitions.reserve(exp.transitions.size() + transition_list.size());
 
     Size progress = 0;
     startProgress(0, transition_list.size(), "conversion to internal data representation");
@@ -700,10 +767,10 @@ namespace OpenMS
       transition.identifying_transition = tr_it->identifying_transition;
       transition.quantifying_transition = tr_it->quantifying_transition;
 
-      exp.transitions.push_back(transition);
+      exp.transitions.push_back(std::move(transition));
 
       // check whether we need a new compound
-      if (compound_map.find(tr_it->group_id) == compound_map.end())
+      if (compound_ids.find(tr_it->group_id) == compound_ids.end())
       {
         OpenSwath::LightCompound compound;
         if (tr_it->isPeptide())
@@ -718,20 +785,19 @@ namespace OpenMS
           createCompound_(tr_it, tramlcompound);
           OpenSwathDataAccessHelper::convertTargetedCompound(tramlcompound, compound);
         }
-        exp.compounds.push_back(compound);
-        compound_map[compound.id] = 0;
+        compound_ids.insert(compound.id);
+        exp.compounds.push_back(std::move(compound));
       }
 
       // check whether we need new proteins
       for (Size i = 0; i < tr_it->ProteinName.size(); ++i)
       {
-        if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName[i]) == protein_map.end())
+        if (tr_it->isPeptide() && protein_ids.insert(tr_it->ProteinName[i]).second)
         {
           OpenSwath::LightProtein protein;
           protein.id = tr_it->ProteinName[i];
           protein.sequence = "";
           exp.proteins.push_back(protein);
-          protein_map[tr_it->ProteinName[i]] = 0;
         }
       }
 
@@ -25,6 +25,7 @@ set(sources_list
   OpenSwathHelper.cpp
   OpenSwathScores.cpp
   OpenSwathScoring.cpp
+  OpenSwathShardMerger.cpp
   OpenSwathTSVWriter.cpp
   OpenSwathOSWWriter.cpp
   OpenSwathWorkflow.cpp
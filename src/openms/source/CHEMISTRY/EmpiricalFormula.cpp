@@ -255,91 +255,83 @@ namespace OpenMS
   EmpiricalFormula EmpiricalFormula::operator*(const SignedSize& times) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula_) ef.formula_[it.first] *= times;
+    for (auto& it : ef.formula_) it.second *= times;
     ef.charge_ *= times;
     ef.removeZeroedElements_();
     return ef;
   }
 
-  EmpiricalFormula EmpiricalFormula::operator+(const EmpiricalFormula& formula) const
+  void EmpiricalFormula::mergeFormulas_(const MapType_& lhs, const MapType_& rhs, SignedSize factor, MapType_& result)
   {
-    EmpiricalFormula ef;
-    ef.formula_ = formula.formula_;
-    for (const auto& it : formula_)
+    // both inputs are sorted by element, so a single linear merge suffices and
+    // every element can be appended at the end of the (pre-reserved) result
+    result.clear();
+    result.reserve(lhs.size() + rhs.size());
+    auto l_it = lhs.begin();
+    auto r_it = rhs.begin();
+    while (l_it != lhs.end() || r_it != rhs.end())
     {
-      auto ef_it  = ef.formula_.find(it.first);
-      if (ef_it != ef.formula_.end())
+      // zeroed elements (e.g. from estimateFromWeightAndComp) are dropped like in removeZeroedElements_()
+      if (r_it == rhs.end() || (l_it != lhs.end() && l_it->first < r_it->first))
       {
-        ef_it->second += it.second;
+        if (l_it->second != 0)
+        {
+          result.emplace_hint(result.end(), *l_it);
+        }
+        ++l_it;
+      }
+      else if (l_it == lhs.end() || r_it->first < l_it->first)
+      {
+        if (r_it->second != 0)
+        {
+          result.emplace_hint(result.end(), r_it->first, factor * r_it->second);
+        }
+        ++r_it;
       }
       else
       {
-        ef.formula_.insert(it);
+        SignedSize count = l_it->second + factor * r_it->second;
+        if (count != 0)
+        {
+          result.emplace_hint(result.end(), l_it->first, count);
+        }
+        ++l_it;
+        ++r_it;
       }
     }
+  }
+
+  EmpiricalFormula EmpiricalFormula::operator+(const EmpiricalFormula& formula) const
+  {
+    EmpiricalFormula ef;
+    mergeFormulas_(formula_, formula.formula_, 1, ef.formula_);
     ef.charge_ = charge_ + formula.charge_;
-    ef.removeZeroedElements_();
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator+=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
-    {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second += it.second;
-      }
-      else
-      {
-        formula_.insert(it);
-      }
-    }
+    MapType_ merged;
+    mergeFormulas_(formula_, formula.formula_, 1, merged);
+    formula_.swap(merged);
     charge_ += formula.charge_;
-    removeZeroedElements_();
     return *this;
   }
 
   EmpiricalFormula EmpiricalFormula::operator-(const EmpiricalFormula& formula) const
   {
-    EmpiricalFormula ef(*this);
-    for (const auto& it : formula.formula_)
-    {
-      const Element* e = it.first;
-      SignedSize num = it.second;
-      auto ef_it  = ef.formula_.find(e);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second -= num;
-      }
-      else
-      {
-        ef.formula_[e] = -num;
-      }
-    }
-
+    EmpiricalFormula ef;
+    mergeFormulas_(formula_, formula.formula_, -1, ef.formula_);
     ef.charge_ = charge_ - formula.charge_;
-    ef.removeZeroedElements_();
     return ef;
   }
 
   EmpiricalFormula& EmpiricalFormula::operator-=(const EmpiricalFormula& formula)
   {
-    for (const auto& it : formula.formula_)
-    {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second -= it.second;
-      }
-      else
-      {
-        formula_[it.first] = -it.second;
-      }
-    }
+    MapType_ merged;
+    mergeFormulas_(formula_, formula.formula_, -1, merged);
+    formula_.swap(merged);
     charge_ -= formula.charge_;
-    removeZeroedElements_();
     return *this;
   }
 
@@ -423,7 +415,7 @@ namespace OpenMS
     return os;
   }
 
-  Int EmpiricalFormula::parseFormula_(std::map<const Element*, SignedSize>& ef, const String& input_formula) const
+  Int EmpiricalFormula::parseFormula_(MapType_& ef, const String& input_formula) const
   {
     Int charge = 0;
     String formula(input_formula);
@@ -587,16 +579,7 @@ namespace OpenMS
       {
         if (num != 0)
         {
-          const Element* e = db->getElement(symbol);
-          std::map<const Element*, SignedSize>::iterator it = ef.find(e);
-          if (it != ef.end())
-          {
-            it->second += num;
-          }
-          else
-          {
-            ef.insert(std::make_pair(e, num));
-          }
+          ef[db->getElement(symbol)] += num;
         }
       }
       else
@@ -606,12 +589,12 @@ namespace OpenMS
     }
 
     // remove elements with 0 counts
-    std::map<const Element*, SignedSize>::iterator it = ef.begin();
+    MapType_::iterator it = ef.begin();
     while (it != ef.end())
     {
       if (it->second == 0)
       {
-        ef.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
+        it = ef.erase(it);
       }
       else
       {
@@ -629,7 +612,7 @@ namespace OpenMS
     {
       if (it->second == 0)
       {
-        formula_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
+        it = formula_.erase(it);
       }
       else
       {
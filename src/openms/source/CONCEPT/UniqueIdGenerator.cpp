@@ -36,17 +36,98 @@
 
 #include <boost/date_time/posix_time/posix_time_types.hpp> //no i/o just types
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   UInt64 UniqueIdGenerator::seed_ = 0;
   UniqueIdGenerator* UniqueIdGenerator::instance_ = nullptr;
   boost::mt19937_64* UniqueIdGenerator::rng_ = nullptr;
   boost::uniform_int<UInt64>* UniqueIdGenerator::dist_ = nullptr;
+  bool UniqueIdGenerator::reproducible_parallel_ids_ = false;
+
+  namespace
+  {
+    /// A random generator used by a single thread inside of parallel regions
+    struct ThreadGenerator
+    {
+      UInt64 generation = 0; ///< seed generation this generator was seeded for (0: never)
+      boost::mt19937_64 rng;
+      boost::uniform_int<UInt64> dist{0, std::numeric_limits<UInt64>::max()};
+    };
+
+    /// incremented on every (re-)seeding, so thread-local generators know when to re-seed
+    std::atomic<UInt64> seed_generation{1};
+
+#ifdef _OPENMP
+    /// teams with more threads fall back to the global generator in reproducible mode
+    const Size MAX_TEAM_GENERATORS = 256;
+
+    /// generators indexed by OpenMP thread number (reproducible mode only), allocated on first use
+    std::vector<std::unique_ptr<ThreadGenerator> > team_generators(MAX_TEAM_GENERATORS);
+
+    /// number of thread-local generators seeded so far
+    std::atomic<UInt64> thread_streams{0};
+
+    thread_local ThreadGenerator local_generator;
+#endif
+  }
+
+  UInt64 UniqueIdGenerator::deriveSeed(UInt64 seed, UInt64 stream)
+  {
+    // SplitMix64 finalizer
+    UInt64 z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
 
   UInt64 UniqueIdGenerator::getUniqueId()
   {
-    UniqueIdGenerator& instance = getInstance_();
 #ifdef _OPENMP
+    if (omp_in_parallel())
+    {
+      UInt64 generation = seed_generation.load(std::memory_order_acquire);
+      if (reproducible_parallel_ids_)
+      {
+        // only safe if this is the single (active) enclosing region, otherwise
+        // several threads could share the same thread number
+        Size thread_num = omp_get_thread_num();
+        if (omp_get_level() == 1 && thread_num < MAX_TEAM_GENERATORS)
+        {
+          std::unique_ptr<ThreadGenerator>& gen = team_generators[thread_num];
+          if (!gen) gen.reset(new ThreadGenerator());
+          if (gen->generation != generation)
+          {
+            // streams with even numbers are reserved for generators tied to OpenMP thread numbers
+            gen->rng.seed(deriveSeed(seed_, 2 * thread_num));
+            gen->dist.reset();
+            gen->generation = generation;
+          }
+          return gen->dist(gen->rng);
+        }
+      }
+      else
+      {
+        ThreadGenerator& gen = local_generator;
+        if (gen.generation != generation)
+        {
+          // streams with odd numbers are reserved for thread-local generators
+          gen.rng.seed(deriveSeed(getInstance_().seed_, 2 * thread_streams++ + 1));
+          gen.dist.reset();
+          gen.generation = generation;
+        }
+        return gen.dist(gen.rng);
+      }
+    }
+
+    UniqueIdGenerator& instance = getInstance_();
     UInt64 val;
 #pragma omp critical (OPENMS_UniqueIdGenerator_getUniqueId)
     {
@@ -55,6 +136,7 @@ namespace OpenMS
     // note: OpenMP can only work on a structured block, return needs to be outside that block
     return val; 
 #else
+    UniqueIdGenerator& instance = getInstance_();
     return (*instance.dist_)(*instance.rng_);
 #endif
   }
@@ -75,9 +157,34 @@ namespace OpenMS
       instance.seed_ = seed;
       instance.rng_->seed( instance.seed_ );
       instance.dist_->reset();
+      seedThreadGenerators_();
     }
   }
 
+  void UniqueIdGenerator::setReproducibleParallelIds(bool reproducible)
+  {
+#ifdef _OPENMP
+#pragma omp critical (OPENMS_UniqueIdGenerator_setSeed)
+#endif
+    {
+      getInstance_();
+      reproducible_parallel_ids_ = reproducible;
+      // restart the per-thread sequences
+      seedThreadGenerators_();
+    }
+  }
+
+  bool UniqueIdGenerator::getReproducibleParallelIds()
+  {
+    return reproducible_parallel_ids_;
+  }
+
+  void UniqueIdGenerator::seedThreadGenerators_()
+  {
+    // per-thread generators re-seed from the global seed on their next use
+    ++seed_generation;
+  }
+
   UniqueIdGenerator::UniqueIdGenerator()
   {
   }
@@ -116,6 +223,7 @@ namespace OpenMS
       seed_ = t.time_of_day().ticks();  // independent of implementation; as opposed to nanoseconds(), which need not be available on every platform
       rng_ = new boost::mt19937_64 (seed_);
       dist_ = new boost::uniform_int<UInt64> (0, std::numeric_limits<UInt64>::max());
+      seedThreadGenerators_();
     }
   }
 
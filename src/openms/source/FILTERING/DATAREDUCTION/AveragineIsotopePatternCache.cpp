@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+namespace OpenMS
+{
+
+  AveragineIsotopePatternCache::AveragineIsotopePatternCache() :
+    nr_requests_(0),
+    nr_computed_(0)
+  {
+  }
+
+  AveragineIsotopePatternCache& AveragineIsotopePatternCache::getInstance()
+  {
+    static AveragineIsotopePatternCache instance;
+    return instance;
+  }
+
+  const IsotopeDistribution& AveragineIsotopePatternCache::estimateFromPeptideWeight(double average_weight, Size max_isotope)
+  {
+    // Element counts are from Senko's Averagine model (same as CoarseIsotopePatternGenerator::estimateFromPeptideWeight)
+    EmpiricalFormula ef;
+    ef.estimateFromWeightAndComp(average_weight, 4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0);
+    KeyType key(max_isotope, ef);
+
+    nr_requests_.fetch_add(1, std::memory_order_relaxed);
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      std::map<KeyType, IsotopeDistribution>::const_iterator it = patterns_.find(key);
+      if (it != patterns_.end())
+      {
+        return it->second;
+      }
+    }
+
+    // compute outside the lock, other threads may look up (or compute) other patterns meanwhile
+    IsotopeDistribution dist = ef.getIsotopeDistribution(CoarseIsotopePatternGenerator(max_isotope));
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // if another thread stored the same pattern meanwhile, the existing one is kept (and counted there)
+    std::pair<std::map<KeyType, IsotopeDistribution>::iterator, bool> result = patterns_.emplace(std::move(key), std::move(dist));
+    if (result.second)
+    {
+      nr_computed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result.first->second;
+  }
+
+  Size AveragineIsotopePatternCache::getNrRequests() const
+  {
+    return nr_requests_.load(std::memory_order_relaxed);
+  }
+
+  Size AveragineIsotopePatternCache::getNrComputed() const
+  {
+    return nr_computed_.load(std::memory_order_relaxed);
+  }
+
+  Size AveragineIsotopePatternCache::size() const
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return patterns_.size();
+  }
+
+  void AveragineIsotopePatternCache::clear()
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    patterns_.clear();
+    nr_requests_ = 0;
+    nr_computed_ = 0;
+  }
+
+}
@@ -35,15 +35,112 @@
 
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/Deisotoper.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace OpenMS
 {
 
-// static
-void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
+namespace
+{
+/// Isotope spacings and decreasing-model flags that only depend on the settings, not on the spectrum
+struct IsotopeTables
+{
+  IsotopeTables(int min_charge, int max_charge, unsigned int max_isopeaks,
+                bool use_decreasing_model, unsigned int start_intensity_check) :
+    min_charge(min_charge),
+    max_isopeaks(max_isopeaks),
+    spacing(std::max(0, max_charge - min_charge + 1) * max_isopeaks, 0.0),
+    check_intensity(max_isopeaks, false)
+  {
+    for (int q = min_charge; q <= max_charge; ++q)
+    {
+      double* row = &spacing[(q - min_charge) * max_isopeaks];
+      for (unsigned int i = 1; i < max_isopeaks; ++i)
+      {
+        // same expression as the former on-the-fly computation, so expected m/z values are bit-identical
+        row[i] = static_cast<double>(i) * Constants::C13C12_MASSDIFF_U / static_cast<double>(q);
+      }
+    }
+    for (unsigned int i = 1; i < max_isopeaks; ++i)
+    {
+      check_intensity[i] = use_decreasing_model && (i >= start_intensity_check);
+    }
+  }
+
+  /// m/z offsets of the isotopic peaks 0..max_isopeaks-1 for charge @p q
+  const double* row(int q) const
+  {
+    return &spacing[(q - min_charge) * max_isopeaks];
+  }
+
+  int min_charge;
+  unsigned int max_isopeaks;
+  std::vector<double> spacing;
+  std::vector<bool> check_intensity;
+};
+
+/**
+  @brief Same result as MSSpectrum::findNearest(mz, tolerance), but searching forward from @p cursor
+
+  All peaks before @p cursor must have m/z < @p mz. On return, @p cursor points to the first peak with m/z >= @p mz,
+  so that increasing queries only ever move forward. An exponential search keeps the cost logarithmic in the
+  distance travelled, which matters for dense spectra.
+*/
+int findNearestForward(const std::vector<double>& mzs, double mz, double tolerance, Size& cursor)
+{
+  const Size n = mzs.size();
+  Size lo = cursor;
+  Size step = 1;
+  while (lo + step < n && mzs[lo + step] < mz)
+  {
+    lo += step;
+    step *= 2;
+  }
+  const Size hi = std::min(n, lo + step + 1);
+  cursor = std::lower_bound(mzs.begin() + lo, mzs.begin() + hi, mz) - mzs.begin();
+
+  Size nearest;
+  if (cursor == 0)
+  {
+    nearest = 0;
+  }
+  else if (cursor == n)
+  {
+    nearest = n - 1;
+  }
+  else
+  {
+    // on ties the left peak wins (as in MSSpectrum::findNearest)
+    nearest = (std::fabs(mzs[cursor] - mz) < std::fabs(mzs[cursor - 1] - mz)) ? cursor : cursor - 1;
+  }
+  const double found_mz = mzs[nearest];
+  if (found_mz >= mz - tolerance && found_mz <= mz + tolerance)
+  {
+    return static_cast<int>(nearest);
+  }
+  return -1;
+}
+
+void checkIsopeakRange(unsigned int min_isopeaks, unsigned int max_isopeaks)
+{
+  if (min_isopeaks < 2 || max_isopeaks < 2 || min_isopeaks > max_isopeaks)
+  {
+    throw Exception::IllegalArgument(__FILE__,
+        __LINE__,
+        OPENMS_PRETTY_FUNCTION,
+        "Minimum/maximum number of isotopic peaks must be at least 2 (and min_isopeaks <= max_isopeaks).");
+  }
+}
+
+void deisotopeSpectrum(MSSpectrum& spec,
+                      const IsotopeTables& tables,
                       double fragment_tolerance,
                       bool fragment_unit_ppm,
                       int min_charge,
@@ -54,20 +151,10 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
                       bool make_single_charged,
                       bool annotate_charge,
                       bool annotate_iso_peak_count,
-                      bool use_decreasing_model,
-                      unsigned int start_intensity_check,
                       bool add_up_intensity)
 {
   OPENMS_PRECONDITION(spec.isSorted(), "Spectrum must be sorted.");
 
-  if (min_isopeaks < 2 || max_isopeaks < 2 || min_isopeaks > max_isopeaks)
-  {
-    throw Exception::IllegalArgument(__FILE__,
-		    __LINE__,
-		    OPENMS_PRETTY_FUNCTION,
-		    "Minimum/maximum number of isotopic peaks must be at least 2 (and min_isopeaks <= max_isopeaks).");
-  }
-
   if (spec.empty()) { return; }
 
   Size charge_index(0);
@@ -110,12 +197,21 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
     precursor_mass = (old_spectrum.getPrecursors()[0].getMZ() * precursor_charge) - (Constants::PROTON_MASS * precursor_charge);
   }
 
+  // contiguous copies of m/z and intensity for the candidate search
+  std::vector<double> mzs(old_spectrum.size());
+  std::vector<double> intensities(old_spectrum.size());
+  for (Size i = 0; i != old_spectrum.size(); ++i)
+  {
+    mzs[i] = old_spectrum[i].getMZ();
+    intensities[i] = old_spectrum[i].getIntensity();
+  }
+
   for (size_t current_peak = 0; current_peak != old_spectrum.size(); ++current_peak)
   {
-    const double current_mz = old_spectrum[current_peak].getMZ();
+    const double current_mz = mzs[current_peak];
     if (add_up_intensity)
     {
-      mono_iso_peak_intensity[current_peak] = old_spectrum[current_peak].getIntensity();
+      mono_iso_peak_intensity[current_peak] = intensities[current_peak];
     }
 
     for (int q = max_charge; q >= min_charge; --q) // important: test charge hypothesis from high to low
@@ -141,10 +237,12 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
 
         extensions.clear();
         extensions.push_back(current_peak);
+        const double* spacing = tables.row(q);
+        Size cursor = current_peak + 1; // all expected isotopic peaks lie right of the current one
         for (unsigned int i = 1; i < max_isopeaks; ++i)
         {
-          const double expected_mz = current_mz + static_cast<double>(i) * Constants::C13C12_MASSDIFF_U / static_cast<double>(q);
-          const int p = old_spectrum.findNearest(expected_mz, tolerance_dalton);
+          const double expected_mz = current_mz + spacing[i];
+          const int p = findNearestForward(mzs, expected_mz, tolerance_dalton, cursor);
           if (p == -1) // test for missing peak
           {
             has_min_isopeaks = (i >= min_isopeaks);
@@ -157,7 +255,7 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
             // if start_intensity_check = 0 or 1, start checking by comparing monoisotopic and second isotopic peak
             // if start_intensity_check = 2, start checking by comparing second isotopic peak with the third, etc.
             // Note: this is a common approach used in several other search engines
-            if (use_decreasing_model && (i >= start_intensity_check) && (old_spectrum[p].getIntensity() > old_spectrum[extensions.back()].getIntensity()))
+            if (tables.check_intensity[i] && (intensities[p] > intensities[extensions.back()]))
             {
               has_min_isopeaks = (i >= min_isopeaks);
               break;
@@ -181,7 +279,7 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
             // monoisotopic peak intensity is already set above, add up the other intensities here
             if (add_up_intensity && (i != 0))
             {
-              mono_iso_peak_intensity[current_peak] += old_spectrum[extensions[i]].getIntensity();
+              mono_iso_peak_intensity[current_peak] += intensities[extensions[i]];
             }
           }
           ++feature_number;
@@ -233,4 +331,68 @@ void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
   spec.sortByPosition();
   return;
 }
+} // anonymous namespace
+
+// static
+void Deisotoper::deisotopeAndSingleCharge(MSSpectrum& spec,
+                      double fragment_tolerance,
+                      bool fragment_unit_ppm,
+                      int min_charge,
+                      int max_charge,
+                      bool keep_only_deisotoped,
+                      unsigned int min_isopeaks,
+                      unsigned int max_isopeaks,
+                      bool make_single_charged,
+                      bool annotate_charge,
+                      bool annotate_iso_peak_count,
+                      bool use_decreasing_model,
+                      unsigned int start_intensity_check,
+                      bool add_up_intensity)
+{
+  checkIsopeakRange(min_isopeaks, max_isopeaks);
+  if (spec.empty()) { return; }
+
+  const IsotopeTables tables(min_charge, max_charge, max_isopeaks, use_decreasing_model, start_intensity_check);
+  deisotopeSpectrum(spec, tables, fragment_tolerance, fragment_unit_ppm, min_charge, max_charge,
+                    keep_only_deisotoped, min_isopeaks, max_isopeaks, make_single_charged,
+                    annotate_charge, annotate_iso_peak_count, add_up_intensity);
+}
+
+// static
+void Deisotoper::deisotopeAndSingleCharge(PeakMap& exp,
+                      double fragment_tolerance,
+                      bool fragment_unit_ppm,
+                      int min_charge,
+                      int max_charge,
+                      bool keep_only_deisotoped,
+                      unsigned int min_isopeaks,
+                      unsigned int max_isopeaks,
+                      bool make_single_charged,
+                      bool annotate_charge,
+                      bool annotate_iso_peak_count,
+                      bool use_decreasing_model,
+                      unsigned int start_intensity_check,
+                      bool add_up_intensity)
+{
+  checkIsopeakRange(min_isopeaks, max_isopeaks);
+
+  // the tables only depend on the settings: compute them once for all spectra
+  const IsotopeTables tables(min_charge, max_charge, max_isopeaks, use_decreasing_model, start_intensity_check);
+
+  ParallelExceptionCollector errors;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
+  {
+    errors.run([&]()
+    {
+      deisotopeSpectrum(exp[i], tables, fragment_tolerance, fragment_unit_ppm, min_charge, max_charge,
+                        keep_only_deisotoped, min_isopeaks, max_isopeaks, make_single_charged,
+                        annotate_charge, annotate_iso_peak_count, add_up_intensity);
+    });
+  }
+  errors.rethrow();
+}
 } // namespace
@@ -34,10 +34,17 @@
 
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
 
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
     MassTraceDetection::MassTraceDetection() :
@@ -265,301 +272,469 @@ namespace OpenMS
       return;
     } // end of MassTraceDetection::run
 
-    void MassTraceDetection::run_(const std::vector<Apex>& chrom_apices,
-                                  const Size total_peak_count,
-                                  const PeakMap& work_exp,
-                                  const std::vector<Size>& spec_offsets,
-                                  std::vector<MassTrace>& found_masstraces,
-                                  const Size max_traces)
+    template <typename IsUsed>
+    void MassTraceDetection::extendTrace_(const Apex& apex,
+                                          const PeakMap& work_exp,
+                                          const int fwhm_meta_idx,
+                                          IsUsed&& is_used,
+                                          TraceCandidate_& candidate)
     {
-      boost::dynamic_bitset<> peak_visited(total_peak_count);
-      Size trace_number(1);
+      Size apex_scan_idx(apex.scan_idx);
+      Size apex_peak_idx(apex.peak_idx);
 
-      // check presence of FWHM meta data
-      int fwhm_meta_idx(-1);
-      Size fwhm_meta_count(0);
-      for (Size i = 0; i < work_exp.size(); ++i)
-      {
-        if (work_exp[i].getFloatDataArrays().size() > 0 &&
-            work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
-        {
-          if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size())
-          { // float data should always have the same size as the corresponding array
-            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
-          }
-          fwhm_meta_idx = 0;
-          ++fwhm_meta_count;
-        }
-      }
-      if (fwhm_meta_count > 0 && fwhm_meta_count != work_exp.size())
+      candidate.accepted = false;
+      if (is_used(apex_scan_idx, apex_peak_idx))
       {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
+        return;
       }
 
+      Peak2D apex_peak;
+      apex_peak.setRT(work_exp[apex_scan_idx].getRT());
+      apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
+      apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
 
-      this->startProgress(0, total_peak_count, "mass trace detection");
-      Size peaks_detected(0);
-
-      for (auto m_it = chrom_apices.crbegin(); m_it != chrom_apices.crend(); ++m_it)
-      {
-        Size apex_scan_idx(m_it->scan_idx);
-        Size apex_peak_idx(m_it->peak_idx);
-
-        if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
-        {
-          continue;
-        }
-
-        Peak2D apex_peak;
-        apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-        apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-        apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
-
-        Size trace_up_idx(apex_scan_idx);
-        Size trace_down_idx(apex_scan_idx);
+      Size trace_up_idx(apex_scan_idx);
+      Size trace_down_idx(apex_scan_idx);
 
-        std::list<PeakType> current_trace;
-        current_trace.push_back(apex_peak);
-        std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+      std::list<PeakType> current_trace;
+      current_trace.push_back(apex_peak);
+      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
 
-        // Initialization for the iterative version of weighted m/z mean calculation
-        double centroid_mz(apex_peak.getMZ());
-        double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-        double prev_denom(apex_peak.getIntensity());
+      // Initialization for the iterative version of weighted m/z mean calculation
+      double centroid_mz(apex_peak.getMZ());
+      double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
+      double prev_denom(apex_peak.getIntensity());
 
-        updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+      updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
 
-        std::vector<std::pair<Size, Size> > gathered_idx;
-        gathered_idx.emplace_back(apex_scan_idx, apex_peak_idx);
-        if (fwhm_meta_idx != -1)
-        {
-          fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
-        }
+      std::vector<std::pair<Size, Size> > gathered_idx;
+      gathered_idx.emplace_back(apex_scan_idx, apex_peak_idx);
+      if (fwhm_meta_idx != -1)
+      {
+        fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+      }
 
-        Size up_hitting_peak(0), down_hitting_peak(0);
-        Size up_scan_counter(0), down_scan_counter(0);
+      Size up_hitting_peak(0), down_hitting_peak(0);
+      Size up_scan_counter(0), down_scan_counter(0);
 
-        bool toggle_up = true, toggle_down = true;
+      bool toggle_up = true, toggle_down = true;
 
-        Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-        Size max_consecutive_missing(trace_termination_outliers_);
+      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+      Size max_consecutive_missing(trace_termination_outliers_);
 
-        double current_sample_rate(1.0);
-        // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-        Size min_scans_to_consider(5);
+      double current_sample_rate(1.0);
+      // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
+      Size min_scans_to_consider(5);
 
-        // double outlier_ratio(0.3);
+      // double outlier_ratio(0.3);
 
-        // double ftl_mean(centroid_mz);
-        double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-        double intensity_so_far(apex_peak.getIntensity());
+      // double ftl_mean(centroid_mz);
+      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+      double intensity_so_far(apex_peak.getIntensity());
 
-        while (((trace_down_idx > 0) && toggle_down) ||
-               ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-                )
+      while (((trace_down_idx > 0) && toggle_down) ||
+             ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+              )
+      {
+        // *********************************************************** //
+        // Step 2.1 MOVE DOWN in RT dim
+        // *********************************************************** //
+        if ((trace_down_idx > 0) && toggle_down)
         {
-          // *********************************************************** //
-          // Step 2.1 MOVE DOWN in RT dim
-          // *********************************************************** //
-          if ((trace_down_idx > 0) && toggle_down)
+          const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
+          if (!spec_trace_down.empty())
           {
-            const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
-            if (!spec_trace_down.empty())
-            {
-              Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-              double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-              double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
+            Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
+            double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
+            double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-              if ((next_down_peak_mz <= right_bound) &&
-                  (next_down_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
-                      )
+            if ((next_down_peak_mz <= right_bound) &&
+                (next_down_peak_mz >= left_bound) &&
+                !is_used(trace_down_idx - 1, next_down_peak_idx)
+                    )
+            {
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_down.getRT());
+              next_peak.setMZ(next_down_peak_mz);
+              next_peak.setIntensity(next_down_peak_int);
+
+              current_trace.push_front(next_peak);
+              // FWHM average
+              if (fwhm_meta_idx != -1)
               {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_down.getRT());
-                next_peak.setMZ(next_down_peak_mz);
-                next_peak.setIntensity(next_down_peak_int);
-
-                current_trace.push_front(next_peak);
-                // FWHM average
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_down_idx - 1, next_down_peak_idx);
+                fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.emplace_back(trace_down_idx - 1, next_down_peak_idx);
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              {
+                // if (ftl_t > min_fwhm_scans)
                 {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
                 }
-
-                ++down_hitting_peak;
-                conseq_missed_peak_down = 0;
-              }
-              else
-              {
-                ++conseq_missed_peak_down;
               }
 
+              ++down_hitting_peak;
+              conseq_missed_peak_down = 0;
+            }
+            else
+            {
+              ++conseq_missed_peak_down;
             }
-            --trace_down_idx;
-            ++down_scan_counter;
 
-            // trace termination criterion: max allowed number of
-            // consecutive outliers reached OR cancel extension if
-            // sampling_rate falls below min_sample_rate_
-            if (trace_termination_criterion_ == "outlier")
+          }
+          --trace_down_idx;
+          ++down_scan_counter;
+
+          // trace termination criterion: max allowed number of
+          // consecutive outliers reached OR cancel extension if
+          // sampling_rate falls below min_sample_rate_
+          if (trace_termination_criterion_ == "outlier")
+          {
+            if (conseq_missed_peak_down > max_consecutive_missing)
             {
-              if (conseq_missed_peak_down > max_consecutive_missing)
-              {
-                toggle_down = false;
-              }
+              toggle_down = false;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+          }
+          else if (trace_termination_criterion_ == "sample_rate")
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                  (double)(down_scan_counter + up_scan_counter + 1);
+            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                    (double)(down_scan_counter + up_scan_counter + 1);
-              if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping down..." << std::endl;
-                toggle_down = false;
-              }
+              // std::cout << "stopping down..." << std::endl;
+              toggle_down = false;
             }
           }
+        }
 
-          // *********************************************************** //
-          // Step 2.2 MOVE UP in RT dim
-          // *********************************************************** //
-          if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+        // *********************************************************** //
+        // Step 2.2 MOVE UP in RT dim
+        // *********************************************************** //
+        if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+        {
+          const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
+          if (!spec_trace_up.empty())
           {
-            const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
-            if (!spec_trace_up.empty())
-            {
-              Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-              double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-              double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
+            Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
+            double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
+            double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-              if ((next_up_peak_mz <= right_bound) &&
-                  (next_up_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_up.getRT());
-                next_peak.setMZ(next_up_peak_mz);
-                next_peak.setIntensity(next_up_peak_int);
+            if ((next_up_peak_mz <= right_bound) &&
+                (next_up_peak_mz >= left_bound) &&
+                !is_used(trace_up_idx + 1, next_up_peak_idx))
+            {
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_up.getRT());
+              next_peak.setMZ(next_up_peak_mz);
+              next_peak.setIntensity(next_up_peak_int);
 
-                current_trace.push_back(next_peak);
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_up_idx + 1, next_up_peak_idx);
+              current_trace.push_back(next_peak);
+              if (fwhm_meta_idx != -1)
+              {
+                fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.emplace_back(trace_up_idx + 1, next_up_peak_idx);
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
+              {
+                // if (ftl_t > min_fwhm_scans)
                 {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
                 }
-
-                ++up_hitting_peak;
-                conseq_missed_peak_up = 0;
-
-              }
-              else
-              {
-                ++conseq_missed_peak_up;
               }
 
+              ++up_hitting_peak;
+              conseq_missed_peak_up = 0;
+
+            }
+            else
+            {
+              ++conseq_missed_peak_up;
             }
 
-            ++trace_up_idx;
-            ++up_scan_counter;
+          }
+
+          ++trace_up_idx;
+          ++up_scan_counter;
 
-            if (trace_termination_criterion_ == "outlier")
+          if (trace_termination_criterion_ == "outlier")
+          {
+            if (conseq_missed_peak_up > max_consecutive_missing)
             {
-              if (conseq_missed_peak_up > max_consecutive_missing)
-              {
-                toggle_up = false;
-              }
+              toggle_up = false;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
-            {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
+          }
+          else if (trace_termination_criterion_ == "sample_rate")
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
 
-              if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping up" << std::endl;
-                toggle_up = false;
-              }
+            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+            {
+              // std::cout << "stopping up" << std::endl;
+              toggle_up = false;
             }
-
-
           }
 
+
         }
 
-        // std::cout << "current sr: " << current_sample_rate << std::endl;
-        double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
+      }
 
-        double mt_quality((double)current_trace.size() / (double)num_scans);
-        // std::cout << "mt quality: " << mt_quality << std::endl;
-        double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
+      // std::cout << "current sr: " << current_sample_rate << std::endl;
+      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
 
-        // *********************************************************** //
-        // Step 2.3 check if minimum length and quality of mass trace criteria are met
-        // *********************************************************** //
-        bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-        if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
-        {
-          // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
+      double mt_quality((double)current_trace.size() / (double)num_scans);
+      // std::cout << "mt quality: " << mt_quality << std::endl;
+      double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
 
-          // mark all peaks as visited
-          for (Size i = 0; i < gathered_idx.size(); ++i)
-          {
-            peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
+      // *********************************************************** //
+      // Step 2.3 check if minimum length and quality of mass trace criteria are met
+      // *********************************************************** //
+      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+      if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
+      {
+        candidate.gathered_idx.swap(gathered_idx);
+
+        // create new MassTrace object and store collected peaks from list current_trace
+        MassTrace& new_trace = candidate.trace;
+        new_trace = MassTrace(current_trace);
+        new_trace.updateWeightedMeanRT();
+        new_trace.updateWeightedMeanMZ();
+        if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
+        new_trace.setQuantMethod(quant_method_);
+        //new_trace.setCentroidSD(ftl_sd);
+        new_trace.updateWeightedMZsd();
+        candidate.accepted = true;
+      }
+    }
+
+    void MassTraceDetection::run_(const std::vector<Apex>& chrom_apices,
+                                  const Size total_peak_count,
+                                  const PeakMap& work_exp,
+                                  const std::vector<Size>& spec_offsets,
+                                  std::vector<MassTrace>& found_masstraces,
+                                  const Size max_traces)
+    {
+      // peaks which already belong to a mass trace
+      boost::dynamic_bitset<> peak_used(total_peak_count);
+      Size trace_number(1);
+
+      // check presence of FWHM meta data
+      int fwhm_meta_idx(-1);
+      Size fwhm_meta_count(0);
+      for (Size i = 0; i < work_exp.size(); ++i)
+      {
+        if (work_exp[i].getFloatDataArrays().size() > 0 &&
+            work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
+        {
+          if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size())
+          { // float data should always have the same size as the corresponding array
+            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
           }
+          fwhm_meta_idx = 0;
+          ++fwhm_meta_count;
+        }
+      }
+      if (fwhm_meta_count > 0 && fwhm_meta_count != work_exp.size())
+      {
+        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
+      }
+
+
+      // speculatively extend the traces in parallel (validated below); not worth it
+      // if only the few most intense traces are requested
+      std::vector<TraceCandidate_> candidates;
+#ifdef _OPENMP
+      if (max_traces == 0 && omp_get_max_threads() > 1)
+      {
+        extendTracesParallel_(chrom_apices, work_exp, spec_offsets, fwhm_meta_idx, candidates);
+      }
+#endif
+      auto is_used = [&peak_used, &spec_offsets](Size scan_idx, Size peak_idx)
+      {
+        return bool(peak_used[spec_offsets[scan_idx] + peak_idx]);
+      };
 
-          // create new MassTrace object and store collected peaks from list current_trace
-          MassTrace new_trace(current_trace);
-          new_trace.updateWeightedMeanRT();
-          new_trace.updateWeightedMeanMZ();
-          if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
-          new_trace.setQuantMethod(quant_method_);
-          //new_trace.setCentroidSD(ftl_sd);
-          new_trace.updateWeightedMZsd();
-          new_trace.setLabel("T" + String(trace_number));
-          ++trace_number;
+      this->startProgress(0, total_peak_count, "mass trace detection");
+      Size peaks_detected(0);
 
-          found_masstraces.push_back(new_trace);
+      for (Size i = 0; i < chrom_apices.size(); ++i)
+      {
+        // go through the apices in order of decreasing intensity
+        const Apex& apex = chrom_apices[chrom_apices.size() - 1 - i];
+
+        // a speculative trace is valid if all used flags it depends on are the same now
+        TraceCandidate_ recomputed;
+        const TraceCandidate_* candidate = &recomputed;
+        if (!candidates.empty() &&
+            std::all_of(candidates[i].reads.begin(), candidates[i].reads.end(),
+                        [&peak_used](const std::pair<Size, bool>& r) { return peak_used[r.first] == r.second; }))
+        {
+          candidate = &candidates[i];
+        }
+        else
+        {
+          extendTrace_(apex, work_exp, fwhm_meta_idx, is_used, recomputed);
+        }
 
-          peaks_detected += new_trace.getSize();
-          this->setProgress(peaks_detected);
+        if (!candidate->accepted)
+        {
+          if (candidate != &recomputed) candidates[i] = TraceCandidate_();
+          continue;
+        }
 
-          // check if we already reached the (optional) maximum number of traces
-          if (max_traces > 0 && found_masstraces.size() == max_traces) break;
+        // mark all peaks as used
+        for (Size j = 0; j < candidate->gathered_idx.size(); ++j)
+        {
+          peak_used[spec_offsets[candidate->gathered_idx[j].first] + candidate->gathered_idx[j].second] = true;
         }
+
+        found_masstraces.push_back(candidate->trace);
+        found_masstraces.back().setLabel("T" + String(trace_number));
+        ++trace_number;
+
+        peaks_detected += candidate->trace.getSize();
+        this->setProgress(peaks_detected);
+
+        // free the memory of the speculative trace
+        if (candidate != &recomputed) candidates[i] = TraceCandidate_();
+
+        // check if we already reached the (optional) maximum number of traces
+        if (max_traces > 0 && found_masstraces.size() == max_traces) break;
       }
 
       this->endProgress();
+    }
+
+    void MassTraceDetection::extendTracesParallel_(const std::vector<Apex>& chrom_apices,
+                                                   const PeakMap& work_exp,
+                                                   const std::vector<Size>& spec_offsets,
+                                                   const int fwhm_meta_idx,
+                                                   std::vector<TraceCandidate_>& candidates)
+    {
+#ifdef _OPENMP
+      const Size n_apices = chrom_apices.size();
+      // a few stripes per thread for load balancing, but not too small ones
+      const Size n_stripes = std::min(Size(4 * omp_get_max_threads()), n_apices / 1000);
+      if (n_stripes < 2)
+      {
+        return;
+      }
+
+      // rank r is the r-th most intense apex
+      auto apex_mz = [&chrom_apices, &work_exp, n_apices](Size rank)
+      {
+        const Apex& apex = chrom_apices[n_apices - 1 - rank];
+        return work_exp[apex.scan_idx][apex.peak_idx].getMZ();
+      };
+      std::vector<Size> by_mz(n_apices);
+      for (Size rank = 0; rank < n_apices; ++rank)
+      {
+        by_mz[rank] = rank;
+      }
+      std::sort(by_mz.begin(), by_mz.end(), [&apex_mz](Size a, Size b)
+      {
+        return (apex_mz(a) < apex_mz(b)) || ((apex_mz(a) == apex_mz(b)) && (a < b));
+      });
+
+      candidates.clear();
+      candidates.resize(n_apices);
+
+      ParallelExceptionCollector errors;
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize stripe = 0; stripe < (SignedSize)n_stripes; ++stripe)
+      {
+        errors.run([&]()
+        {
+          // the stripe's own apices are by_mz[core_first, core_last)
+          const Size core_first = stripe * n_apices / n_stripes;
+          const Size core_last = (stripe + 1) * n_apices / n_stripes;
+          const double core_lo = apex_mz(by_mz[core_first]);
+          const double core_hi = apex_mz(by_mz[core_last - 1]);
+
+          // overlap with the neighbouring stripes: apices that are close enough to
+          // take peaks from our traces are extended as well (but not reported), and
+          // used flags are kept for peaks close to the stripe
+          const double apex_margin = 6 * core_hi * mass_error_ppm_ * 1e-6;
+          const double peak_margin = 2 * apex_margin;
+          const Size ext_first = std::partition_point(by_mz.begin(), by_mz.end(),
+            [&](Size rank) { return apex_mz(rank) < core_lo - apex_margin; }) - by_mz.begin();
+          const Size ext_last = std::partition_point(by_mz.begin(), by_mz.end(),
+            [&](Size rank) { return apex_mz(rank) <= core_hi + apex_margin; }) - by_mz.begin();
+          std::vector<std::pair<Size, bool> > stripe_apices; // (rank, is own apex)
+          stripe_apices.reserve(ext_last - ext_first);
+          for (Size k = ext_first; k < ext_last; ++k)
+          {
+            stripe_apices.emplace_back(by_mz[k], (k >= core_first) && (k < core_last));
+          }
+          std::sort(stripe_apices.begin(), stripe_apices.end());
+
+          // per-spectrum peak ranges of the stripe and their used flags
+          std::vector<std::pair<Size, Size> > peak_range(work_exp.size());
+          std::vector<Size> local_offsets(work_exp.size() + 1, 0);
+          for (Size s = 0; s < work_exp.size(); ++s)
+          {
+            peak_range[s].first = work_exp[s].MZBegin(core_lo - peak_margin) - work_exp[s].begin();
+            peak_range[s].second = work_exp[s].MZEnd(core_hi + peak_margin) - work_exp[s].begin();
+            local_offsets[s + 1] = local_offsets[s] + (peak_range[s].second - peak_range[s].first);
+          }
+          boost::dynamic_bitset<> local_used(local_offsets.back());
 
+          // peaks outside of the stripe are assumed to be unused (this is checked in run_)
+          TraceCandidate_* current = nullptr;
+          auto is_used = [&](Size scan_idx, Size peak_idx)
+          {
+            bool used = (peak_idx >= peak_range[scan_idx].first) && (peak_idx < peak_range[scan_idx].second) &&
+                        local_used[local_offsets[scan_idx] + peak_idx - peak_range[scan_idx].first];
+            if (current != nullptr)
+            {
+              current->reads.emplace_back(spec_offsets[scan_idx] + peak_idx, used);
+            }
+            return used;
+          };
+
+          TraceCandidate_ overlap_candidate;
+          for (const auto& stripe_apex : stripe_apices)
+          {
+            const Size rank = stripe_apex.first;
+            current = stripe_apex.second ? &candidates[rank] : nullptr;
+            TraceCandidate_& candidate = stripe_apex.second ? candidates[rank] : overlap_candidate;
+            extendTrace_(chrom_apices[n_apices - 1 - rank], work_exp, fwhm_meta_idx, is_used, candidate);
+            if (!candidate.accepted) continue;
+
+            for (const auto& idx : candidate.gathered_idx)
+            {
+              if ((idx.second >= peak_range[idx.first].first) && (idx.second < peak_range[idx.first].second))
+              {
+                local_used[local_offsets[idx.first] + idx.second - peak_range[idx.first].first] = true;
+              }
+            }
+          }
+        });
+      }
+      errors.rethrow();
+#else
+      // without OpenMP, run_ extends the traces one by one
+      (void)chrom_apices;
+      (void)work_exp;
+      (void)spec_offsets;
+      (void)fwhm_meta_idx;
+      candidates.clear();
+#endif
     }
 
     void MassTraceDetection::updateMembers_()
@@ -3,6 +3,7 @@ set(directory source/FILTERING/DATAREDUCTION)
 
 ### list all filenames of the directory here
 set(sources_list
+AveragineIsotopePatternCache.cpp
 DataFilters.cpp
 Deisotoper.cpp
 ElutionPeakDetection.cpp
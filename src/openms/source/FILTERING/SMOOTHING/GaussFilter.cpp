@@ -34,13 +34,16 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
+
 namespace OpenMS
 {
 
   GaussFilter::GaussFilter() :
     ProgressLogger(),
     DefaultParamHandler("GaussFilter"),
-    spacing_(0.01)
+    spacing_(0.01),
+    use_ppm_tolerance_(false)
   {
     //Parameter settings
     defaults_.setValue("gaussian_width", 0.2, "Use a gaussian filter width which has approximately the same width as your mass peaks (FWHM in m/z).");
@@ -54,10 +57,151 @@ namespace OpenMS
   {
   }
 
+  GaussFilter::Workspace_& GaussFilter::threadWorkspace_()
+  {
+    // buffers are reused between calls (one set per thread)
+    static thread_local Workspace_ ws;
+    return ws;
+  }
+
+  void GaussFilter::filter(MSSpectrum & spectrum)
+  {
+    // make sure the right data type is set
+    spectrum.setType(SpectrumSettings::PROFILE);
+    bool found_signal = false;
+    const Size data_size = spectrum.size();
+
+    Workspace_& ws = threadWorkspace_();
+    ws.resize(data_size);
+
+    // copy spectrum to container
+    for (Size p = 0; p < data_size; ++p)
+    {
+      ws.pos_in[p] = spectrum[p].getMZ();
+      ws.int_in[p] = static_cast<double>(spectrum[p].getIntensity());
+    }
+
+    // apply filter
+    found_signal = filterData_(ws);
+
+    // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
+    // This is the case if the Gaussian filter is smaller than the spacing of raw data
+    if (!found_signal && spectrum.size() >= 3)
+    {
+      String error_message = "Found no signal. The Gaussian width is probably smaller than the spacing in your profile data. Try to use a bigger width.";
+      if (spectrum.getRT() > 0.0)
+      {
+        error_message += String(" The error occurred in the spectrum with retention time ") + spectrum.getRT() + ".";
+      }
+      OPENMS_LOG_ERROR << error_message << std::endl;
+    }
+    else
+    {
+      // copy the new data into the spectrum
+      for (Size p = 0; p < data_size; ++p)
+      {
+        spectrum[p].setIntensity(ws.int_out[p]);
+        spectrum[p].setMZ(ws.pos_out[p]);
+      }
+    }
+  }
+
+  void GaussFilter::filter(MSChromatogram & chromatogram)
+  {
+    if (use_ppm_tolerance_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "GaussFilter: Cannot use ppm tolerance on chromatograms");
+    }
+
+    bool found_signal = false;
+    const Size data_size = chromatogram.size();
+
+    Workspace_& ws = threadWorkspace_();
+    ws.resize(data_size);
+
+    // copy spectrum to container
+    for (Size p = 0; p < data_size; ++p)
+    {
+      ws.pos_in[p] = chromatogram[p].getRT();
+      ws.int_in[p] = chromatogram[p].getIntensity();
+    }
+
+    // apply filter
+    found_signal = filterData_(ws);
+
+    // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
+    // This is the case if the Gaussian filter is smaller than the spacing of raw data
+    if (!found_signal && chromatogram.size() >= 3)
+    {
+      String error_message = "Found no signal. The Gaussian width is probably smaller than the spacing in your chromatogram data. Try to use a bigger width.";
+      if (chromatogram.getMZ() > 0.0)
+      {
+        error_message += String(" The error occurred in the chromatogram with m/z time ") + chromatogram.getMZ() + ".";
+      }
+      OPENMS_LOG_ERROR << error_message << std::endl;
+    }
+    else
+    {
+      // copy the new data into the spectrum
+      for (Size p = 0; p < data_size; ++p)
+      {
+        chromatogram[p].setIntensity(ws.int_out[p]);
+        chromatogram[p].setMZ(ws.pos_out[p]);
+      }
+    }
+  }
+
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    if (use_ppm_tolerance_ && !map.getChromatograms().empty())
+    {
+      // fail before any data is changed (see filter(MSChromatogram&))
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "GaussFilter: Cannot use ppm tolerance on chromatograms");
+    }
+
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+    ParallelExceptionCollector errors;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      errors.run([&]() { filter(map[i]); });
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_progress)
+#endif
+      {
+        setProgress(++progress);
+      }
+    }
+    errors.rethrow();
+
+    std::vector<MSChromatogram>& chromatograms = map.getChromatograms();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+    {
+      filter(chromatograms[i]); // doesn't throw (ppm tolerance was checked above)
+#ifdef _OPENMP
+#pragma omp critical (GaussFilter_progress)
+#endif
+      {
+        setProgress(++progress);
+      }
+    }
+    endProgress();
+  }
+
   void GaussFilter::updateMembers_()
   {
+    use_ppm_tolerance_ = param_.getValue("use_ppm_tolerance").toBool();
     gauss_algo_.initialize((double)param_.getValue("gaussian_width"), spacing_,
-            (double)param_.getValue("ppm_tolerance"), param_.getValue("use_ppm_tolerance").toBool());
+            (double)param_.getValue("ppm_tolerance"), use_ppm_tolerance_);
   }
 
 }
@@ -38,6 +38,8 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#include <algorithm>
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -55,6 +57,106 @@ namespace OpenMS
   {
   }
 
+  SavitzkyGolayFilter::Workspace_& SavitzkyGolayFilter::threadWorkspace_()
+  {
+    // buffers are reused between calls (one set per thread)
+    static thread_local Workspace_ ws;
+    return ws;
+  }
+
+  void SavitzkyGolayFilter::smooth_(const std::vector<double>& data, std::vector<double>& result) const
+  {
+    const Size n = data.size();
+    const Size mid = frame_size_ / 2;
+    result.assign(n, 0.0);
+
+    // transient on (first 'mid + 1' data points)
+    for (Size i = 0; i <= mid; ++i)
+    {
+      const double* row = &coeffs_[(i + 1) * frame_size_ - 1];
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += data[j] * *(row - j);
+      }
+      result[i] = help;
+    }
+
+    // steady state: all data points use the same coefficients, so the loop
+    // runs over a block of output values for each coefficient (the block is
+    // kept small enough to stay in the L1 cache)
+    const double* row = &coeffs_[mid * frame_size_];
+    const Size block_size = 256;
+    for (Size block_start = mid + 1; block_start < n - mid; block_start += block_size)
+    {
+      const Size block_end = std::min(block_start + block_size, n - mid);
+      double* out = result.data();
+      const double* in = data.data();
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        const double c = row[j];
+        for (Size k = block_start; k < block_end; ++k)
+        {
+          out[k] += in[k - mid + j] * c;
+        }
+      }
+    }
+
+    // transient off (last 'mid' data points)
+    for (Size i = 0; i < mid; ++i)
+    {
+      const Size out_idx = n - mid + i; // same as "first" of the iterator version
+      const Size in_start = out_idx - (frame_size_ - (mid - 1 - i) - 1);
+      const double* row = &coeffs_[(mid - 1 - i) * frame_size_];
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += data[in_start + j] * row[j];
+      }
+      result[out_idx] = help;
+    }
+
+    for (double& value : result)
+    {
+      value = std::max(0.0, value);
+    }
+  }
+
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map)
+  {
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      filter(map[i]);
+#ifdef _OPENMP
+#pragma omp critical (SavitzkyGolayFilter_progress)
+#endif
+      {
+        setProgress(++progress);
+      }
+    }
+
+    std::vector<MSChromatogram>& chromatograms = map.getChromatograms();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+    {
+      filter(chromatograms[i]);
+#ifdef _OPENMP
+#pragma omp critical (SavitzkyGolayFilter_progress)
+#endif
+      {
+        setProgress(++progress);
+      }
+    }
+    endProgress();
+  }
+
   void SavitzkyGolayFilter::updateMembers_()
   {
     frame_size_ = (UInt)param_.getValue("frame_length");
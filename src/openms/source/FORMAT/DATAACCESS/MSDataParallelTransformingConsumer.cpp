@@ -0,0 +1,151 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// Applies @p func to all elements of @p batch in parallel (rethrows the first exception)
+    template <typename DataT>
+    void processBatch(std::vector<DataT>& batch, const std::function<void (DataT&)>& func)
+    {
+      if (!func) return;
+      ParallelExceptionCollector errors;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)batch.size(); ++i)
+      {
+        errors.run([&]() { func(batch[i]); });
+      }
+      if (errors.failed())
+      {
+        batch.clear();
+        errors.rethrow();
+      }
+    }
+  }
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    MSDataTransformingConsumer(),
+    next_consumer_(next_consumer),
+    batch_size_(batch_size)
+  {
+    if (batch_size_ == 0)
+    {
+      batch_size_ = 16;
+#ifdef _OPENMP
+      batch_size_ *= omp_get_max_threads();
+#endif
+    }
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "Error while processing the remaining data: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const ExperimentalSettings& es)
+  {
+    MSDataTransformingConsumer::setExperimentalSettings(es);
+    next_consumer_->setExperimentalSettings(es);
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the order of spectra and chromatograms
+    processChromatograms_();
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) processSpectra_();
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the order of spectra and chromatograms
+    processSpectra_();
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) processChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    // only one of the two can contain data
+    processSpectra_();
+    processChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::processSpectra_()
+  {
+    if (spectra_.empty()) return;
+    processBatch(spectra_, lambda_spec_);
+    for (SpectrumType& s : spectra_)
+    {
+      next_consumer_->consumeSpectrum(s);
+    }
+    spectra_.clear();
+  }
+
+  void MSDataParallelTransformingConsumer::processChromatograms_()
+  {
+    if (chromatograms_.empty()) return;
+    processBatch(chromatograms_, lambda_chrom_);
+    for (ChromatogramType& c : chromatograms_)
+    {
+      next_consumer_->consumeChromatogram(c);
+    }
+    chromatograms_.clear();
+  }
+
+} // namespace OpenMS
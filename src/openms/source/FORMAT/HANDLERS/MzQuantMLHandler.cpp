@@ -1049,7 +1049,7 @@ namespace OpenMS
           {
             std::vector<UInt64> idvec;
             idvec.push_back(UniqueIdGenerator::getUniqueId());
-            for (std::set<FeatureHandle, FeatureHandle::IndexLess>::const_iterator fit = feature_handles.begin(); fit != feature_handles.end(); ++fit)
+            for (ConsensusFeature::HandleSetType::const_iterator fit = feature_handles.begin(); fit != feature_handles.end(); ++fit)
             {
               fid.push_back(UniqueIdGenerator::getUniqueId());
               idvec.push_back(fid.back());
@@ -1073,7 +1073,7 @@ namespace OpenMS
             feature_xml += "\t\t<Feature id=\"f_" + String(fid.back()) + "\" rt=\"" + String(cit->getRT()) + "\" mz=\"" + String(cit->getMZ()) + "\" charge=\"" + String(cit->getCharge()) + "\"/>\n";
             //~ std::vector<UInt64> cidvec;
             //~ cidvec.push_back(fid.back());
-            for (std::set<FeatureHandle, FeatureHandle::IndexLess>::const_iterator fit = feature_handles.begin(); fit != feature_handles.end(); ++fit)
+            for (ConsensusFeature::HandleSetType::const_iterator fit = feature_handles.begin(); fit != feature_handles.end(); ++fit)
             {
               fi.push_back(fit->getIntensity());
             }
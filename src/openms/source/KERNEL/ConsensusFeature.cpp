@@ -85,10 +85,19 @@ namespace OpenMS
 
   void ConsensusFeature::insert(const HandleSetType& handle_set)
   {
-    for (ConsensusFeature::HandleSetType::const_iterator it = handle_set.begin(); it != handle_set.end(); ++it)
+    // both sets are sorted: check for duplicates in a single pass, then merge
+    FeatureHandle::IndexLess less;
+    HandleSetType::const_iterator own_it = handles_.begin();
+    for (HandleSetType::const_iterator it = handle_set.begin(); it != handle_set.end(); ++it)
     {
-      insert(*it);
+      while (own_it != handles_.end() && less(*own_it, *it)) ++own_it;
+      if (own_it != handles_.end() && !less(*it, *own_it))
+      {
+        String key = String("map") + it->getMapIndex() + "/feature" + it->getUniqueId();
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The set already contained an element with this key.", key);
+      }
     }
+    handles_.insert(boost::container::ordered_unique_range, handle_set.begin(), handle_set.end());
   }
 
   void ConsensusFeature::insert(UInt64 map_index, const Peak2D& element, UInt64 element_index)
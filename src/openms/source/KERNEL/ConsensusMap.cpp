@@ -266,17 +266,12 @@ namespace OpenMS
         }
       }
 
-      // update map indices
-      ConsensusFeature::HandleSetType new_handles;
-      // std::set only provides const iterators, so we copy
-      for (auto handle : cf) // OMS_CODING_TEST_EXCLUDE
+      // update map indices in place:
+      // since we only add a constant to the map_index, the set order will not change.
+      for (auto& handle : cf)
       {
-        //since we only add a constant to the map_index, the set order will not change.
         handle.setMapIndex(lhs_map_size + handle.getMapIndex());
-        new_handles.insert(handle);
       }
-      cf.setFeatures(std::move(new_handles));
-      new_handles.clear();
 
       emplace_back(cf);
     }
@@ -38,75 +38,78 @@
 
 namespace OpenMS
 {
-  MSSpectrum &MSSpectrum::select(const std::vector<Size> &indices)
+  namespace
   {
-    Size snew = indices.size();
-    ContainerType tmp;
-    tmp.reserve(indices.size());
-
-    const Size peaks_old = size();
+    /**
+      @brief Selects the values at @p indices from all non-empty data arrays in @p source (of @p peaks_old values each)
 
-    for (Size i = 0; i < snew; ++i)
+      @p target is either @p source itself (the values are moved) or empty (the values and the meta data of the arrays are copied).
+    */
+    template <typename SourceArrays, typename DataArrays>
+    void selectDataArrays(SourceArrays& source, DataArrays& target, const std::vector<Size>& indices, Size peaks_old, const String& name)
     {
-      tmp.push_back(std::move(ContainerType::operator[](indices[i])));
-    }
-    ContainerType::swap(tmp);
-
-    std::vector<float> mda_tmp_float;
-    for (Size i = 0; i < float_data_arrays_.size(); ++i)
-    {
-      if (float_data_arrays_[i].empty()) continue;
-      if (float_data_arrays_[i].size() != peaks_old)
+      const bool in_place = (static_cast<const void*>(&source) == static_cast<const void*>(&target));
+      if (!in_place)
       {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "FloatDataArray[" + String(i) + "] size (" +
-                                                                                  String(float_data_arrays_[i].size()) + ") does not match spectrum size (" + String(peaks_old) + ")");
+        target.resize(source.size());
       }
 
-      mda_tmp_float.clear();
-      mda_tmp_float.reserve(float_data_arrays_[i].size());
-      for (Size j = 0; j < snew; ++j)
+      std::vector<typename DataArrays::value_type::value_type> tmp;
+      for (Size i = 0; i < source.size(); ++i)
       {
-        mda_tmp_float.push_back(std::move(float_data_arrays_[i][indices[j]]));
+        if (!in_place)
+        {
+          static_cast<MetaInfoDescription&>(target[i]) = source[i];
+        }
+        if (source[i].empty()) continue;
+        if (source[i].size() != peaks_old)
+        {
+          throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, name + "[" + String(i) + "] size (" +
+                                                                                    String(source[i].size()) + ") does not match spectrum size (" + String(peaks_old) + ")");
+        }
+
+        tmp.clear();
+        tmp.reserve(indices.size());
+        for (Size j = 0; j < indices.size(); ++j)
+        {
+          // copies if the source is const:
+          tmp.push_back(std::move(source[i][indices[j]]));
+        }
+        tmp.swap(target[i]);
       }
-      std::swap(float_data_arrays_[i], mda_tmp_float);
     }
+  }
 
-    std::vector<String> mda_tmp_str;
-    for (Size i = 0; i < string_data_arrays_.size(); ++i)
-    {
-      if (string_data_arrays_[i].empty()) continue;
-      if (string_data_arrays_[i].size() != peaks_old)
-      {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "StringDataArray[" + String(i) + "] size (" +
-                                                                                  String(string_data_arrays_[i].size()) + ") does not match spectrum size (" + String(peaks_old) + ")");
-      }
+  MSSpectrum &MSSpectrum::select(const std::vector<Size> &indices)
+  {
+    Size snew = indices.size();
+    ContainerType tmp;
+    tmp.reserve(indices.size());
 
-      mda_tmp_str.clear();
-      mda_tmp_str.reserve(string_data_arrays_[i].size());
-      for (Size j = 0; j < snew; ++j)
-      {
-        mda_tmp_str.push_back(std::move(string_data_arrays_[i][indices[j]]));
-      }
-      std::swap(string_data_arrays_[i], mda_tmp_str);
-    }
+    const ContainerType& peaks = peakContainer_();
+    const Size peaks_old = peaks.size();
 
-    std::vector<Int> mda_tmp_int;
-    for (Size i = 0; i < integer_data_arrays_.size(); ++i)
+    for (Size i = 0; i < snew; ++i)
     {
-      if (integer_data_arrays_[i].empty()) continue;
-      if (integer_data_arrays_[i].size() != peaks_old)
-      {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IntegerDataArray[" + String(i) + "] size (" +
-                                                                                  String(integer_data_arrays_[i].size()) + ") does not match spectrum size (" + String(peaks_old) + ")");
-      }
+      tmp.push_back(peaks[indices[i]]);
+    }
+    // shared peaks are not copied before being replaced:
+    setPeakContainer_(std::move(tmp));
 
-      mda_tmp_int.clear();
-      mda_tmp_int.reserve(integer_data_arrays_[i].size());
-      for (Size j = 0; j < snew; ++j)
-      {
-        mda_tmp_int.push_back(std::move(integer_data_arrays_[i][indices[j]]));
-      }
-      std::swap(integer_data_arrays_[i], mda_tmp_int);
+    if (shared_data_arrays_ && (shared_data_arrays_.use_count() > 1))
+    {
+      // shared data arrays are read, not copied before being replaced:
+      std::shared_ptr<const SharedDataArrays_> shared = shared_data_arrays_;
+      detachDataArrays_(false, false, false);
+      selectDataArrays(shared->float_data_arrays, shared_data_arrays_->float_data_arrays, indices, peaks_old, "FloatDataArray");
+      selectDataArrays(shared->string_data_arrays, shared_data_arrays_->string_data_arrays, indices, peaks_old, "StringDataArray");
+      selectDataArrays(shared->integer_data_arrays, shared_data_arrays_->integer_data_arrays, indices, peaks_old, "IntegerDataArray");
+    }
+    else
+    {
+      selectDataArrays(getFloatDataArrays(), getFloatDataArrays(), indices, peaks_old, "FloatDataArray");
+      selectDataArrays(getStringDataArrays(), getStringDataArrays(), indices, peaks_old, "StringDataArray");
+      selectDataArrays(getIntegerDataArrays(), getIntegerDataArrays(), indices, peaks_old, "IntegerDataArray");
     }
 
     return *this;
@@ -153,8 +156,9 @@ namespace OpenMS
 
   MSSpectrum::Iterator MSSpectrum::getBasePeak()
   {
-    ConstIterator largest = const_cast<const MSSpectrum&>(*this).getBasePeak();
-    return begin() + std::distance(cbegin(), largest);
+    // compute the offset first, as "begin()" may copy shared peaks:
+    Size offset = std::distance(cbegin(), const_cast<const MSSpectrum&>(*this).getBasePeak());
+    return begin() + offset;
   }
 
   MSSpectrum::PeakType::IntensityType MSSpectrum::getTIC() const
@@ -170,11 +174,19 @@ namespace OpenMS
 
   void MSSpectrum::clear(bool clear_meta_data)
   {
-    ContainerType::clear();
+    if (shared_peaks_ && (shared_peaks_.use_count() > 1))
+    {
+      // no need to copy shared peaks just to clear them:
+      shared_peaks_ = std::make_shared<ContainerType>();
+    }
+    else
+    {
+      mutablePeakContainer_().clear();
+    }
 
     if (clear_meta_data)
     {
-      ContainerType::shrink_to_fit();
+      mutablePeakContainer_().shrink_to_fit();
 
       clearRanges();
       this->SpectrumSettings::operator=(SpectrumSettings()); // no "clear" method
@@ -190,6 +202,10 @@ namespace OpenMS
       string_data_arrays_.shrink_to_fit();
       integer_data_arrays_.clear();
       integer_data_arrays_.shrink_to_fit();
+      if (shared_data_arrays_)
+      {
+        shared_data_arrays_ = std::make_shared<SharedDataArrays_>();
+      }
     }
   }
 
@@ -205,7 +221,7 @@ namespace OpenMS
   {
     PeakType p;
     p.setPosition(mz);
-    return upper_bound(ContainerType::begin(), ContainerType::end(), p, PeakType::PositionLess());
+    return upper_bound(peakContainer_().begin(), peakContainer_().end(), p, PeakType::PositionLess());
   }
 
   MSSpectrum::ConstIterator MSSpectrum::MZBegin(MSSpectrum::ConstIterator begin, MSSpectrum::CoordinateType mz,
@@ -219,7 +235,7 @@ namespace OpenMS
   Int MSSpectrum::findNearest(MSSpectrum::CoordinateType mz, MSSpectrum::CoordinateType tolerance_left,
                               MSSpectrum::CoordinateType tolerance_right) const
   {
-    if (ContainerType::empty()) return -1;
+    if (peakContainer_().empty()) return -1;
 
     // do a binary search for nearest peak first
     Size i = findNearest(mz);
@@ -263,7 +279,7 @@ namespace OpenMS
 
   Int MSSpectrum::findNearest(MSSpectrum::CoordinateType mz, MSSpectrum::CoordinateType tolerance) const
   {
-    if (ContainerType::empty()) return -1;
+    if (peakContainer_().empty()) return -1;
     Size i = findNearest(mz);
     const double found_mz = this->operator[](i).getMZ();
     if (found_mz >= mz - tolerance && found_mz <= mz + tolerance)
@@ -279,32 +295,32 @@ namespace OpenMS
   Size MSSpectrum::findNearest(MSSpectrum::CoordinateType mz) const
   {
     // no peak => no search
-    if (ContainerType::size() == 0) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
+    if (peakContainer_().size() == 0) throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "There must be at least one peak to determine the nearest peak!");
 
     // search for position for inserting
     ConstIterator it = MZBegin(mz);
     // border cases
-    if (it == ContainerType::begin()) return 0;
+    if (it == peakContainer_().begin()) return 0;
 
-    if (it == ContainerType::end()) return ContainerType::size() - 1;
+    if (it == peakContainer_().end()) return peakContainer_().size() - 1;
 
     // the peak before or the current peak are closest
     ConstIterator it2 = it;
     --it2;
     if (std::fabs(it->getMZ() - mz) < std::fabs(it2->getMZ() - mz))
     {
-      return Size(it - ContainerType::begin());
+      return Size(it - peakContainer_().begin());
     }
     else
     {
-      return Size(it2 - ContainerType::begin());
+      return Size(it2 - peakContainer_().begin());
     }
   }
 
   Int MSSpectrum::findHighestInWindow(MSSpectrum::CoordinateType mz, MSSpectrum::CoordinateType tolerance_left,
                               MSSpectrum::CoordinateType tolerance_right) const
   {
-    if (ContainerType::empty()) return -1;
+    if (peakContainer_().empty()) return -1;
 
     // get left/right iterator
     auto left = this->MZBegin(mz - tolerance_left);
@@ -327,16 +343,17 @@ namespace OpenMS
   {
     if (chunks.size() == 1 && chunks[0].is_sorted) return;
 
-    if (float_data_arrays_.empty() && string_data_arrays_.empty() && integer_data_arrays_.empty())
+    if (!hasDataArrays_())
     {
-      std::stable_sort(ContainerType::begin(), ContainerType::end(), PeakType::PositionLess());
+      std::stable_sort(begin(), end(), PeakType::PositionLess());
     }
     else
     {
       std::vector<Size> select_indices(this->size());
       std::iota(select_indices.begin(), select_indices.end(), 0);
 
-      auto comparePos = [this] (Size a, Size b) { return this->ContainerType::operator[](a).getPos() < this->ContainerType::operator[](b).getPos(); };
+      const ContainerType& peaks = peakContainer_();
+      auto comparePos = [&peaks] (Size a, Size b) { return peaks[a].getPos() < peaks[b].getPos(); };
 
       // sort all chunks, that haven't been sorted yet
       for (Size i = 0; i < chunks.size(); ++i)
@@ -369,18 +386,19 @@ namespace OpenMS
   {
     if (isSorted()) return;
 
-    if (float_data_arrays_.empty() && string_data_arrays_.empty() && integer_data_arrays_.empty())
+    if (!hasDataArrays_())
     {
-      std::stable_sort(ContainerType::begin(), ContainerType::end(), PeakType::PositionLess());
+      std::stable_sort(begin(), end(), PeakType::PositionLess());
     }
     else
     {
       //sort index list
       std::vector<std::pair<PeakType::PositionType, Size> > sorted_indices;
-      sorted_indices.reserve(ContainerType::size());
-      for (Size i = 0; i < ContainerType::size(); ++i)
+      const ContainerType& peaks = peakContainer_();
+      sorted_indices.reserve(peaks.size());
+      for (Size i = 0; i < peaks.size(); ++i)
       {
-        sorted_indices.push_back(std::make_pair(ContainerType::operator[](i).getPosition(), i));
+        sorted_indices.push_back(std::make_pair(peaks[i].getPosition(), i));
       }
       std::stable_sort(sorted_indices.begin(), sorted_indices.end(), PairComparatorFirstElement<std::pair<PeakType::PositionType, Size> >());
 
@@ -397,28 +415,29 @@ namespace OpenMS
 
   void MSSpectrum::sortByIntensity(bool reverse)
   {
-    if (reverse && std::is_sorted(ContainerType::begin(), ContainerType::end(), reverseComparator(PeakType::IntensityLess()))) return;
-    else if (!reverse && std::is_sorted(ContainerType::begin(), ContainerType::end(), PeakType::IntensityLess())) return;
+    const ContainerType& peaks = peakContainer_();
+    if (reverse && std::is_sorted(peaks.begin(), peaks.end(), reverseComparator(PeakType::IntensityLess()))) return;
+    else if (!reverse && std::is_sorted(peaks.begin(), peaks.end(), PeakType::IntensityLess())) return;
 
-    if (float_data_arrays_.empty() && string_data_arrays_.empty() && integer_data_arrays_.empty())
+    if (!hasDataArrays_())
     {
       if (reverse)
       {
-        std::stable_sort(ContainerType::begin(), ContainerType::end(), reverseComparator(PeakType::IntensityLess()));
+        std::stable_sort(begin(), end(), reverseComparator(PeakType::IntensityLess()));
       }
       else
       {
-        std::stable_sort(ContainerType::begin(), ContainerType::end(), PeakType::IntensityLess());
+        std::stable_sort(begin(), end(), PeakType::IntensityLess());
       }
     }
     else
     {
       // sort index list
       std::vector<std::pair<PeakType::IntensityType, Size> > sorted_indices;
-      sorted_indices.reserve(ContainerType::size());
-      for (Size i = 0; i < ContainerType::size(); ++i)
+      sorted_indices.reserve(peaks.size());
+      for (Size i = 0; i < peaks.size(); ++i)
       {
-        sorted_indices.push_back(std::make_pair(ContainerType::operator[](i).getIntensity(), i));
+        sorted_indices.push_back(std::make_pair(peaks[i].getIntensity(), i));
       }
 
       if (reverse)
@@ -443,7 +462,7 @@ namespace OpenMS
 
   bool MSSpectrum::isSorted() const
   {
-    return std::is_sorted(ContainerType::begin(), ContainerType::end(), PeakType::PositionLess());
+    return std::is_sorted(peakContainer_().begin(), peakContainer_().end(), PeakType::PositionLess());
   }
 
   bool MSSpectrum::operator==(const MSSpectrum &rhs) const
@@ -451,16 +470,16 @@ namespace OpenMS
     //name_ can differ => it is not checked
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfloat-equal"
-    return std::operator==(*this, rhs) &&
+    return peakContainer_() == rhs.peakContainer_() &&
            RangeManager<1>::operator==(rhs) &&
            SpectrumSettings::operator==(rhs) &&
            retention_time_ == rhs.retention_time_ &&
            drift_time_ == rhs.drift_time_ &&
            drift_time_unit_ == rhs.drift_time_unit_ &&
            ms_level_ == rhs.ms_level_ &&
-           float_data_arrays_ == rhs.float_data_arrays_ &&
-           string_data_arrays_ == rhs.string_data_arrays_ &&
-           integer_data_arrays_ == rhs.integer_data_arrays_;
+           getFloatDataArrays() == rhs.getFloatDataArrays() &&
+           getStringDataArrays() == rhs.getStringDataArrays() &&
+           getIntegerDataArrays() == rhs.getIntegerDataArrays();
 
 #pragma clang diagnostic pop
   }
@@ -481,6 +500,8 @@ namespace OpenMS
     float_data_arrays_ = source.float_data_arrays_;
     string_data_arrays_ = source.string_data_arrays_;
     integer_data_arrays_ = source.integer_data_arrays_;
+    shared_peaks_ = source.shared_peaks_;
+    shared_data_arrays_ = source.shared_data_arrays_;
 
     return *this;
   }
@@ -496,7 +517,9 @@ namespace OpenMS
     name_(),
     float_data_arrays_(),
     string_data_arrays_(),
-    integer_data_arrays_()
+    integer_data_arrays_(),
+    shared_peaks_(),
+    shared_data_arrays_()
   {}
 
   MSSpectrum::MSSpectrum(const MSSpectrum &source) :
@@ -510,7 +533,9 @@ namespace OpenMS
     name_(source.name_),
     float_data_arrays_(source.float_data_arrays_),
     string_data_arrays_(source.string_data_arrays_),
-    integer_data_arrays_(source.integer_data_arrays_)
+    integer_data_arrays_(source.integer_data_arrays_),
+    shared_peaks_(source.shared_peaks_),
+    shared_data_arrays_(source.shared_data_arrays_)
   {}
 
   MSSpectrum &MSSpectrum::operator=(const SpectrumSettings &source)
@@ -522,7 +547,7 @@ namespace OpenMS
   void MSSpectrum::updateRanges()
   {
     this->clearRanges();
-    updateRanges_(ContainerType::begin(), ContainerType::end());
+    updateRanges_(peakContainer_().begin(), peakContainer_().end());
   }
 
   double MSSpectrum::getRT() const
@@ -577,49 +602,134 @@ namespace OpenMS
 
   const MSSpectrum::FloatDataArrays &MSSpectrum::getFloatDataArrays() const
   {
-    return float_data_arrays_;
+    return shared_data_arrays_ ? shared_data_arrays_->float_data_arrays : float_data_arrays_;
+  }
+
+  MSSpectrum::FloatDataArrays &MSSpectrum::getFloatDataArrays()
+  {
+    detachDataArrays_();
+    return shared_data_arrays_ ? shared_data_arrays_->float_data_arrays : float_data_arrays_;
   }
 
   void MSSpectrum::setFloatDataArrays(const MSSpectrum::FloatDataArrays &fda)
   {
-    float_data_arrays_ = fda;
+    // the replaced data arrays are not copied first:
+    detachDataArrays_(false, true, true);
+    getFloatDataArrays() = fda;
   }
 
   const MSSpectrum::StringDataArrays &MSSpectrum::getStringDataArrays() const
   {
-    return string_data_arrays_;
+    return shared_data_arrays_ ? shared_data_arrays_->string_data_arrays : string_data_arrays_;
   }
 
   void MSSpectrum::setStringDataArrays(const MSSpectrum::StringDataArrays &sda)
   {
-    string_data_arrays_ = sda;
+    // the replaced data arrays are not copied first:
+    detachDataArrays_(true, false, true);
+    getStringDataArrays() = sda;
   }
 
   MSSpectrum::StringDataArrays &MSSpectrum::getStringDataArrays()
   {
-    return string_data_arrays_;
+    detachDataArrays_();
+    return shared_data_arrays_ ? shared_data_arrays_->string_data_arrays : string_data_arrays_;
   }
 
   const MSSpectrum::IntegerDataArrays &MSSpectrum::getIntegerDataArrays() const
   {
-    return integer_data_arrays_;
+    return shared_data_arrays_ ? shared_data_arrays_->integer_data_arrays : integer_data_arrays_;
   }
 
   MSSpectrum::IntegerDataArrays &MSSpectrum::getIntegerDataArrays()
   {
-    return integer_data_arrays_;
+    detachDataArrays_();
+    return shared_data_arrays_ ? shared_data_arrays_->integer_data_arrays : integer_data_arrays_;
   }
 
   void MSSpectrum::setIntegerDataArrays(const MSSpectrum::IntegerDataArrays &ida)
   {
-    integer_data_arrays_ = ida;
+    // the replaced data arrays are not copied first:
+    detachDataArrays_(true, true, false);
+    getIntegerDataArrays() = ida;
+  }
+
+  void MSSpectrum::setCopyOnWrite(bool cow)
+  {
+    if (cow == isCopyOnWrite()) return;
+
+    if (cow)
+    {
+      shared_peaks_ = std::make_shared<ContainerType>();
+      shared_peaks_->swap(*this);
+      shared_data_arrays_ = std::make_shared<SharedDataArrays_>();
+      shared_data_arrays_->float_data_arrays.swap(float_data_arrays_);
+      shared_data_arrays_->string_data_arrays.swap(string_data_arrays_);
+      shared_data_arrays_->integer_data_arrays.swap(integer_data_arrays_);
+    }
+    else
+    {
+      // take over the data if no other spectrum shares it, otherwise copy it:
+      ContainerType::operator=(std::move(mutablePeakContainer_()));
+      detachDataArrays_();
+      float_data_arrays_.swap(shared_data_arrays_->float_data_arrays);
+      string_data_arrays_.swap(shared_data_arrays_->string_data_arrays);
+      integer_data_arrays_.swap(shared_data_arrays_->integer_data_arrays);
+      shared_peaks_.reset();
+      shared_data_arrays_.reset();
+    }
+  }
+
+  bool MSSpectrum::isCopyOnWrite() const
+  {
+    return bool(shared_peaks_);
+  }
+
+  bool MSSpectrum::isShared() const
+  {
+    return (shared_peaks_ && (shared_peaks_.use_count() > 1)) ||
+      (shared_data_arrays_ && (shared_data_arrays_.use_count() > 1));
+  }
+
+  void MSSpectrum::setPeakContainer_(ContainerType&& peaks)
+  {
+    if (!shared_peaks_)
+    {
+      ContainerType::swap(peaks);
+    }
+    else if (shared_peaks_.use_count() > 1)
+    {
+      shared_peaks_ = std::make_shared<ContainerType>(std::move(peaks));
+    }
+    else
+    {
+      shared_peaks_->swap(peaks);
+    }
+  }
+
+  void MSSpectrum::detachDataArrays_(bool copy_float, bool copy_string, bool copy_integer)
+  {
+    if (shared_data_arrays_ && (shared_data_arrays_.use_count() > 1))
+    {
+      auto arrays = std::make_shared<SharedDataArrays_>();
+      if (copy_float) arrays->float_data_arrays = shared_data_arrays_->float_data_arrays;
+      if (copy_string) arrays->string_data_arrays = shared_data_arrays_->string_data_arrays;
+      if (copy_integer) arrays->integer_data_arrays = shared_data_arrays_->integer_data_arrays;
+      shared_data_arrays_ = std::move(arrays);
+    }
+  }
+
+  bool MSSpectrum::hasDataArrays_() const
+  {
+    return !(getFloatDataArrays().empty() && getStringDataArrays().empty() &&
+             getIntegerDataArrays().empty());
   }
 
   MSSpectrum::Iterator MSSpectrum::MZBegin(MSSpectrum::CoordinateType mz)
   {
     PeakType p;
     p.setPosition(mz);
-    return lower_bound(ContainerType::begin(), ContainerType::end(), p, PeakType::PositionLess());
+    return lower_bound(begin(), end(), p, PeakType::PositionLess());
   }
 
   MSSpectrum::Iterator
@@ -634,7 +744,7 @@ namespace OpenMS
   {
     PeakType p;
     p.setPosition(mz);
-    return upper_bound(ContainerType::begin(), ContainerType::end(), p, PeakType::PositionLess());
+    return upper_bound(begin(), end(), p, PeakType::PositionLess());
   }
 
   MSSpectrum::Iterator
@@ -649,7 +759,7 @@ namespace OpenMS
   {
     PeakType p;
     p.setPosition(mz);
-    return lower_bound(ContainerType::begin(), ContainerType::end(), p, PeakType::PositionLess());
+    return lower_bound(peakContainer_().begin(), peakContainer_().end(), p, PeakType::PositionLess());
   }
 
   MSSpectrum::Iterator MSSpectrum::PosBegin(MSSpectrum::CoordinateType mz)
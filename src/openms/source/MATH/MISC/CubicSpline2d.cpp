@@ -43,7 +43,16 @@ using namespace std;
 
 namespace OpenMS
 {
+  CubicSpline2d::CubicSpline2d()
+  {
+  }
+
   CubicSpline2d::CubicSpline2d(const std::vector<double>& x, const std::vector<double>& y)
+  {
+    init(x, y);
+  }
+
+  void CubicSpline2d::init(const std::vector<double>& x, const std::vector<double>& y)
   {
     if (x.size() != y.size())
     {
@@ -143,39 +152,31 @@ namespace OpenMS
   {
     const size_t n = x.size() - 1;
 
-    std::vector<double> h;
-    h.reserve(n);
-    a_.reserve(n);
-    x_.reserve(n + 1);
-    // do the 0'th element manually, since the loop below only starts at 1
-    h.push_back(x[1] - x[0]);
-    x_.push_back(x[0]);
-    a_.push_back(y[0]);
-
-    std::vector<double> mu(n, 0.0);
-    std::vector<double> z(n, 0.0);
+    // No temporary vectors are allocated (and the member vectors keep their
+    // capacity if the spline is re-initialized via "init"): during the
+    // forward pass, 'b_' holds the intermediate values "z" and 'd_' holds
+    // "mu"; the interval widths are recomputed instead of being stored.
+    x_.assign(x.begin(), x.end()); // 'x_' needs to be full length (all other member vectors (except c_) are one element shorter)
+    a_.assign(y.begin(), y.end() - 1);
+    b_.assign(n, 0.0);
+    d_.assign(n, 0.0);
+    c_.resize(n + 1);
     for (unsigned i = 1; i < n; ++i)
     {
-      h.push_back(x[i + 1] - x[i]);
-      const double l = 2 * (x[i + 1] - x[i - 1]) - h[i - 1] * mu[i - 1];
-      mu[i] = h[i] / l;
-      z[i] = (3 * (y[i + 1] * h[i - 1] - y[i] * (x[i + 1] - x[i - 1]) + y[i - 1] * h[i]) / (h[i - 1] * h[i]) - h[i - 1] * z[i - 1]) / l;
-      // store x,y -- required for evaluation later on
-      x_.push_back(x[i]);
-      a_.push_back(y[i]);
+      const double h_left = x[i] - x[i - 1];
+      const double h = x[i + 1] - x[i];
+      const double l = 2 * (x[i + 1] - x[i - 1]) - h_left * d_[i - 1];
+      d_[i] = h / l;
+      b_[i] = (3 * (y[i + 1] * h_left - y[i] * (x[i + 1] - x[i - 1]) + y[i - 1] * h) / (h_left * h) - h_left * b_[i - 1]) / l;
     }
-    // 'x_' needs to be full length (all other member vectors (except c_) are one element shorter)
-    x_.push_back(x[n]);
 
-    b_.resize(n); 
-    d_.resize(n);
-    c_.resize(n+1);
     c_.back() = 0;
     for (int j = static_cast<int>(n) - 1; j >= 0; --j)
     {
-      c_[j] = z[j] - mu[j] * c_[j + 1];
-      b_[j] = (y[j + 1] - y[j]) / h[j] - h[j] * (c_[j + 1] + 2 * c_[j]) / 3;
-      d_[j] = (c_[j + 1] - c_[j]) / (3 * h[j]);
+      const double h = x[j + 1] - x[j];
+      c_[j] = b_[j] - d_[j] * c_[j + 1];
+      b_[j] = (y[j + 1] - y[j]) / h - h * (c_[j + 1] + 2 * c_[j]) / 3;
+      d_[j] = (c_[j + 1] - c_[j]) / (3 * h);
     }
 
   }
@@ -381,6 +381,31 @@ namespace OpenMS
   }
 
 
+  void IdentificationData::reserve(Size queries, Size parents, Size molecules,
+                                   Size matches, MoleculeType molecule_type)
+  {
+    data_query_lookup_.reserve(queries);
+    parent_molecule_lookup_.reserve(parents);
+    switch (molecule_type)
+    {
+    case MoleculeType::PROTEIN:
+      identified_peptide_lookup_.reserve(molecules);
+      break;
+    case MoleculeType::COMPOUND:
+      identified_compound_lookup_.reserve(molecules);
+      break;
+    case MoleculeType::RNA:
+      identified_oligo_lookup_.reserve(molecules);
+      break;
+    default:
+      String msg = "invalid molecule type";
+      throw Exception::IllegalArgument(__FILE__, __LINE__,
+                                       OPENMS_PRETTY_FUNCTION, msg);
+    }
+    query_match_lookup_.reserve(matches);
+  }
+
+
   void IdentificationData::addScore(QueryMatchRef match_ref,
                                     ScoreTypeRef score_ref, double value)
   {
@@ -38,6 +38,8 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/FileHandler.h>
 
+#include <unordered_set>
+
 using namespace std;
 
 using ID = OpenMS::IdentificationData;
@@ -52,6 +54,32 @@ namespace OpenMS
     ProgressLogger progresslogger;
     progresslogger.setLogType(ProgressLogger::CMD);
 
+    // reserve look-up capacity: proteins are referenced by many evidences, so
+    // count distinct accessions; distinct peptide sequences are not counted
+    // (that would cost as much as the rehashing it saves), so leave them out
+    unordered_set<String> accessions;
+    for (const ProteinIdentification& prot : proteins)
+    {
+      for (const ProteinHit& hit : prot.getHits())
+      {
+        accessions.insert(hit.getAccession());
+      }
+    }
+    Size n_hits = 0;
+    for (const PeptideIdentification& pep : peptides)
+    {
+      n_hits += pep.getHits().size();
+      for (const PeptideHit& hit : pep.getHits())
+      {
+        for (const PeptideEvidence& evidence : hit.getPeptideEvidences())
+        {
+          accessions.insert(evidence.getProteinAccession());
+        }
+      }
+    }
+    id_data.reserve(peptides.size(), accessions.size(), 0, n_hits);
+    accessions.clear();
+
     // ProteinIdentification:
     progresslogger.startProgress(0, proteins.size(),
                                  "converting protein identification runs");
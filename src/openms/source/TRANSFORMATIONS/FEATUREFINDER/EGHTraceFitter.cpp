@@ -418,6 +418,10 @@ namespace OpenMS
     OPENMS_LOG_DEBUG << "tau: " << tau_ << std::endl;
     sigma_ = sqrt(-0.5 / log_alpha * B * A);
     OPENMS_LOG_DEBUG << "sigma: " << sigma_ << std::endl;
+
+    // bounds of the initial model, in case the optimization fails (otherwise
+    // the bounds from a previous fit would be reported):
+    sigma_5_bound_ = getAlphaBoundaries_(0.043937);
   }
 
   void EGHTraceFitter::updateMembers_()
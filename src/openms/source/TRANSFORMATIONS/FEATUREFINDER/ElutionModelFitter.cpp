@@ -35,10 +35,17 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/ElutionModelFitter.h>
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationModelLinear.h>
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/EGHTraceFitter.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/GaussTraceFitter.h>
 
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -196,6 +203,104 @@ void ElutionModelFitter::fitAndValidateModel_(
 }
 
 
+void ElutionModelFitter::fitFeature_(TraceFitter* fitter, Feature& feature,
+                                     vector<Peak1D>& peaks, double add_zeros,
+                                     bool each_trace, bool asymmetric,
+                                     double area_limit, double check_boundaries)
+{
+  // OPENMS_LOG_DEBUG << String(feature.getMetaValue("PeptideRef")) << endl;
+  double region_start = double(feature.getMetaValue("leftWidth"));
+  double region_end = double(feature.getMetaValue("rightWidth"));
+
+  if (feature.getSubordinates().empty())
+  {
+    throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No subordinate features for mass traces available.");
+  }
+  const Feature& sub = feature.getSubordinates()[0];
+  if (sub.getConvexHulls().empty())
+  {
+    throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No hull points for mass trace in subordinate feature available.");
+  }
+
+  // reserve space once, to avoid copying and invalidating pointers:
+  peaks.clear();
+  Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
+  peaks.reserve(feature.getSubordinates().size() * points_per_hull +
+                (add_zeros > 0.0)); // don't forget additional zero point
+  MassTraces traces;
+  traces.max_trace = 0;
+  // need a mass trace for every transition, plus maybe one for add. zeros:
+  traces.reserve(feature.getSubordinates().size() + (add_zeros > 0.0));
+  for (vector<Feature>::iterator sub_it = feature.getSubordinates().begin();
+       sub_it != feature.getSubordinates().end(); ++sub_it)
+  {
+    MassTrace trace;
+    trace.peaks.reserve(points_per_hull);
+    const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
+    for (ConvexHull2D::PointArrayTypeConstIterator point_it =
+           hull.getHullPoints().begin(); point_it !=
+           hull.getHullPoints().end(); ++point_it)
+    {
+      double intensity = point_it->getY();
+      if (intensity > 0.0) // only use non-zero intensities for fitting
+      {
+        Peak1D peak;
+        peak.setMZ(sub_it->getMZ());
+        peak.setIntensity(intensity);
+        peaks.push_back(peak);
+        trace.peaks.emplace_back(point_it->getX(), &peaks.back());
+      }
+    }
+    trace.updateMaximum();
+    if (trace.peaks.empty()) continue;
+    if (each_trace)
+    {
+      MassTraces temp;
+      trace.theoretical_int = 1.0;
+      temp.push_back(trace);
+      temp.max_trace = 0;
+      fitAndValidateModel_(fitter, temp, *sub_it, region_start, region_end,
+                           asymmetric, area_limit, check_boundaries);
+    }
+    trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
+    traces.push_back(trace);
+  }
+
+  // find the trace with maximal intensity:
+  Size max_trace = 0;
+  double max_intensity = 0;
+  for (Size i = 0; i < traces.size(); ++i)
+  {
+    if (traces[i].max_peak->getIntensity() > max_intensity)
+    {
+      max_trace = i;
+      max_intensity = traces[i].max_peak->getIntensity();
+    }
+  }
+  traces.max_trace = max_trace;
+  traces.baseline = 0.0;
+
+  if (add_zeros > 0.0)
+  {
+    MassTrace trace;
+    trace.peaks.reserve(2);
+    trace.theoretical_int = add_zeros;
+    Peak1D peak;
+    peak.setMZ(feature.getSubordinates()[0].getMZ());
+    peak.setIntensity(0.0);
+    peaks.push_back(peak);
+    double offset = 0.2 * (region_start - region_end);
+    trace.peaks.emplace_back(region_start - offset, &peaks.back());
+    trace.peaks.emplace_back(region_end + offset, &peaks.back());
+    traces.push_back(trace);
+  }
+
+  // fit the model:
+  fitAndValidateModel_(fitter, traces, feature, region_start, region_end,
+                       asymmetric, area_limit, check_boundaries);
+}
+
+
 void ElutionModelFitter::fitElutionModels(FeatureMap& features)
 {
   bool asymmetric = param_.getValue("asymmetric").toBool();
@@ -209,118 +314,54 @@ void ElutionModelFitter::fitElutionModels(FeatureMap& features)
   double asym_limit = (asymmetric ?
                        double(param_.getValue("check:asymmetry")) : 0.0);
 
-  TraceFitter* fitter;
-  if (asymmetric)
-  {
-    fitter = new EGHTraceFitter();
-  }
-  else fitter = new GaussTraceFitter();
-  if (weighted)
+  // each thread needs its own fitter (the fitters store the model parameters):
+  auto createFitter = [asymmetric, weighted]() -> TraceFitter*
   {
-    Param params = fitter->getDefaults();
-    params.setValue("weighted", "true");
-    fitter->setParameters(params);
-  }
+    TraceFitter* fitter;
+    if (asymmetric)
+    {
+      fitter = new EGHTraceFitter();
+    }
+    else fitter = new GaussTraceFitter();
+    if (weighted)
+    {
+      Param params = fitter->getDefaults();
+      params.setValue("weighted", "true");
+      fitter->setParameters(params);
+    }
+    return fitter;
+  };
 
   // collect peaks that constitute mass traces:
   //TODO make progress logger?
   OPENMS_LOG_DEBUG << "Fitting elution models to features:" << endl;
   Size index = 0;
-  for (FeatureMap::Iterator feat_it = features.begin();
-       feat_it != features.end(); ++feat_it, ++index)
-  {
-    // OPENMS_LOG_DEBUG << String(feat_it->getMetaValue("PeptideRef")) << endl;
-    double region_start = double(feat_it->getMetaValue("leftWidth"));
-    double region_end = double(feat_it->getMetaValue("rightWidth"));
 
-    if (feat_it->getSubordinates().empty())
-    {
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No subordinate features for mass traces available.");
-    }
-    const Feature& sub = feat_it->getSubordinates()[0];
-    if (sub.getConvexHulls().empty())
-    {
-      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No hull points for mass trace in subordinate feature available.");
-    }
+  // features are fitted independently of each other, so the result does not
+  // depend on the number of threads:
+  ParallelExceptionCollector errors;
 
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::unique_ptr<TraceFitter> fitter(createFitter());
+    // peak storage is reused for all features processed by this thread:
     vector<Peak1D> peaks;
-    // reserve space once, to avoid copying and invalidating pointers:
-    Size points_per_hull = sub.getConvexHulls()[0].getHullPoints().size();
-    peaks.reserve(feat_it->getSubordinates().size() * points_per_hull +
-                  (add_zeros > 0.0)); // don't forget additional zero point
-    MassTraces traces;
-    traces.max_trace = 0;
-    // need a mass trace for every transition, plus maybe one for add. zeros:
-    traces.reserve(feat_it->getSubordinates().size() + (add_zeros > 0.0));
-    for (vector<Feature>::iterator sub_it = feat_it->getSubordinates().begin();
-         sub_it != feat_it->getSubordinates().end(); ++sub_it)
-    {
-      MassTrace trace;
-      trace.peaks.reserve(points_per_hull);
-      const ConvexHull2D& hull = sub_it->getConvexHulls()[0];
-      for (ConvexHull2D::PointArrayTypeConstIterator point_it =
-             hull.getHullPoints().begin(); point_it !=
-             hull.getHullPoints().end(); ++point_it)
-      {
-        double intensity = point_it->getY();
-        if (intensity > 0.0) // only use non-zero intensities for fitting
-        {
-          Peak1D peak;
-          peak.setMZ(sub_it->getMZ());
-          peak.setIntensity(intensity);
-          peaks.push_back(peak);
-          trace.peaks.emplace_back(point_it->getX(), &peaks.back());
-        }
-      }
-      trace.updateMaximum();
-      if (trace.peaks.empty()) continue;
-      if (each_trace)
-      {
-        MassTraces temp;
-        trace.theoretical_int = 1.0;
-        temp.push_back(trace);
-        temp.max_trace = 0;
-        fitAndValidateModel_(fitter, temp, *sub_it, region_start, region_end,
-                             asymmetric, area_limit, check_boundaries);
-      }
-      trace.theoretical_int = sub_it->getMetaValue("isotope_probability");
-      traces.push_back(trace);
-    }
 
-    // find the trace with maximal intensity:
-    Size max_trace = 0;
-    double max_intensity = 0;
-    for (Size i = 0; i < traces.size(); ++i)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (SignedSize feat_index = 0; feat_index < (SignedSize)features.size(); ++feat_index)
     {
-      if (traces[i].max_peak->getIntensity() > max_intensity)
+      errors.run([&]()
       {
-        max_trace = i;
-        max_intensity = traces[i].max_peak->getIntensity();
-      }
+        fitFeature_(fitter.get(), features[feat_index], peaks, add_zeros,
+                    each_trace, asymmetric, area_limit, check_boundaries);
+      });
     }
-    traces.max_trace = max_trace;
-    traces.baseline = 0.0;
-
-    if (add_zeros > 0.0)
-    {
-      MassTrace trace;
-      trace.peaks.reserve(2);
-      trace.theoretical_int = add_zeros;
-      Peak1D peak;
-      peak.setMZ(feat_it->getSubordinates()[0].getMZ());
-      peak.setIntensity(0.0);
-      peaks.push_back(peak);
-      double offset = 0.2 * (region_start - region_end);
-      trace.peaks.emplace_back(region_start - offset, &peaks.back());
-      trace.peaks.emplace_back(region_end + offset, &peaks.back());
-      traces.push_back(trace);
-    }
-
-    // fit the model:
-    fitAndValidateModel_(fitter, traces, *feat_it, region_start, region_end,
-                         asymmetric, area_limit, check_boundaries);
   }
-  delete fitter;
+  errors.rethrow();
 
   // find outliers in model parameters:
   if (width_limit > 0)
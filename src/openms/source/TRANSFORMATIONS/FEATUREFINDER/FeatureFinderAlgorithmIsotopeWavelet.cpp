@@ -34,8 +34,13 @@
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmIsotopeWavelet.h>
 
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/IsotopeWaveletTransform.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   FeatureFinderAlgorithmIsotopeWavelet::FeatureFinderAlgorithmIsotopeWavelet()
@@ -110,9 +115,8 @@ namespace OpenMS
     {
       if (++pos >= c_sorted_spec.size())
       {
-        std::cout << "Detected empty scan or a scan that cannot be interpolated with zeros in HR mode. " << std::endl;
-        std::cout << "Please check scan # " << i << " of your data set." << std::endl;
-        exit(-1);
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Detected empty scan or a scan that cannot be interpolated with zeros in HR mode. Please check scan # " + String(i) + " of your data set.");
       }
     }
     double bound = -1 * c_sorted_spec[pos].getMZ();
@@ -177,102 +181,101 @@ namespace OpenMS
     progress_counter_ = 0;
     this->ff_->startProgress(0, 2 * this->map_->size() * max_charge_, "analyzing spectra");
 
+    //The lookup tables of the wavelet depend on the m/z range and the charges of this map.
+    //Compute them once for this run, before any thread draws values from them.
+    IsotopeWavelet::destroy();
+    IsotopeWavelet::init(max_mz, max_charge_);
+
     IsotopeWaveletTransform<PeakType>* iwt = new IsotopeWaveletTransform<PeakType>(min_mz, max_mz, max_charge_, max_size, hr_data_, intensity_type_);
-    for (UInt i = 0; i < this->map_->size(); ++i)
-    {
-      const MSSpectrum& c_ref((*this->map_)[i]);
 
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-      std::cout << ::std::fixed << ::std::setprecision(6) << "Spectrum " << i + 1 << " (" << (*this->map_)[i].getRT() << ") of " << this->map_->size() << " ... ";
-      std::cout.flush();
+    //The transforms of a block of scans are computed in parallel, each thread with its own transform
+    //object. Afterwards, the seeds are identified and merged into boxes scan by scan (sweep line),
+    //exactly as in the sequential case. Thus, the result does not depend on the number of threads.
+#ifdef _OPENMP
+    const Size block_size = 16 * omp_get_max_threads();
+#else
+    const Size block_size = 1;
 #endif
+    std::vector<TransformedScan_> block;
+
+    for (Size block_start = 0; block_start < this->map_->size(); block_start += block_size)
+    {
+      const Size block_end = std::min(block_start + block_size, this->map_->size());
+      block.clear();
+      block.resize(block_end - block_start);
+
+      ParallelExceptionCollector errors;
 
-      if (c_ref.size() <= 1)                 //unable to do transform anything
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
       {
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-        std::cout << "scan empty or consisting of a single data point. Skipping." << std::endl;
+        IsotopeWaveletTransform<PeakType> worker(min_mz, max_mz, max_charge_, max_size, hr_data_, intensity_type_);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
 #endif
-        this->ff_->setProgress(progress_counter_ += 2);
-        continue;
+        for (SignedSize k = 0; k < (SignedSize)block.size(); ++k)
+        {
+          errors.run([&]() { transformScan_(block_start + k, worker, block[k]); });
+        }
       }
-
-      if (!hr_data_)                   //LowRes data
+      if (errors.failed())
       {
-        iwt->initializeScan((*this->map_)[i]);
-        for (UInt c = 0; c < max_charge_; ++c)
-        {
-          MSSpectrum c_trans(c_ref);
-
-          iwt->getTransform(c_trans, c_ref, c);
+        delete (iwt);
+        errors.rethrow();
+      }
 
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::stringstream stream;
-          stream << "cpu_lowres_" << c_ref.getRT() << "_" << c + 1 << ".trans\0";
-          std::ofstream ofile(stream.str().c_str());
-          for (UInt k = 0; k < c_ref.size(); ++k)
-          {
-            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << c_ref[k].getIntensity() << std::endl;
-          }
-          ofile.close();
-#endif
+      for (Size i = block_start; i < block_end; ++i)
+      {
+        TransformedScan_& scan = block[i - block_start];
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::cout << "transform O.K. ... "; std::cout.flush();
+        std::cout << ::std::fixed << ::std::setprecision(6) << "Spectrum " << i + 1 << " (" << (*this->map_)[i].getRT() << ") of " << this->map_->size() << " ... ";
+        std::cout.flush();
 #endif
-          this->ff_->setProgress(++progress_counter_);
-
-          iwt->identifyCharge(c_trans, c_ref, i, c, intensity_threshold_, check_PPMs_);
 
+        if (scan.trans.empty())                 //unable to do transform anything
+        {
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::cout << "charge recognition O.K. ... "; std::cout.flush();
+          std::cout << "scan empty or consisting of a single data point. Skipping." << std::endl;
 #endif
-          this->ff_->setProgress(++progress_counter_);
+          this->ff_->setProgress(progress_counter_ += 2);
+          continue;
         }
-      }
-      else                   //HighRes data
-      {
+
+        const MSSpectrum& c_ref = hr_data_ ? *scan.hr_ref : (*this->map_)[i];
         for (UInt c = 0; c < max_charge_; ++c)
         {
-          MSSpectrum* new_spec = createHRData(i);
-          iwt->initializeScan(*new_spec, c);
-          MSSpectrum c_trans(*new_spec);
-
-          iwt->getTransformHighRes(c_trans, *new_spec, c);
+          const MSSpectrum& c_trans = scan.trans[c];
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
           std::stringstream stream;
-          stream << "cpu_highres_" << new_spec->getRT() << "_" << c + 1 << ".trans\0";
+          stream << (hr_data_ ? "cpu_highres_" : "cpu_lowres_") << c_ref.getRT() << "_" << c + 1 << ".trans\0";
           std::ofstream ofile(stream.str().c_str());
-          for (UInt k = 0; k < new_spec->size(); ++k)
+          for (UInt k = 0; k < c_ref.size(); ++k)
           {
-            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << (*new_spec)[k].getIntensity() << std::endl;
+            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << c_ref[k].getIntensity() << std::endl;
           }
           ofile.close();
-#endif
-
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
           std::cout << "transform O.K. ... "; std::cout.flush();
 #endif
           this->ff_->setProgress(++progress_counter_);
 
-          iwt->identifyCharge(c_trans, *new_spec, i, c, intensity_threshold_, check_PPMs_);
+          iwt->identifyCharge(c_trans, c_ref, i, c, intensity_threshold_, check_PPMs_);
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
           std::cout << "charge recognition O.K. ... "; std::cout.flush();
 #endif
           this->ff_->setProgress(++progress_counter_);
-
-          delete (new_spec); new_spec = nullptr;
         }
-      }
-
 
-      iwt->updateBoxStates(*this->map_, i, RT_interleave_, real_RT_votes_cutoff_);
+        iwt->updateBoxStates(*this->map_, i, RT_interleave_, real_RT_votes_cutoff_);
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-      std::cout << "updated box states." << std::endl;
+        std::cout << "updated box states." << std::endl;
 #endif
 
-      std::cout.flush();
+        std::cout.flush();
+      }
     }
 
     this->ff_->endProgress();
@@ -288,6 +291,37 @@ namespace OpenMS
     delete (iwt);
   }
 
+  void FeatureFinderAlgorithmIsotopeWavelet::transformScan_(const Size i, IsotopeWaveletTransform<PeakType>& iwt, TransformedScan_& scan)
+  {
+    const MSSpectrum& c_ref((*this->map_)[i]);
+    if (c_ref.size() <= 1) //unable to do transform anything
+    {
+      return;
+    }
+
+    scan.trans.resize(max_charge_);
+    if (!hr_data_) //LowRes data
+    {
+      iwt.initializeScan(c_ref);
+      for (UInt c = 0; c < max_charge_; ++c)
+      {
+        scan.trans[c] = c_ref;
+        iwt.getTransform(scan.trans[c], c_ref, c);
+      }
+    }
+    else //HighRes data
+    {
+      //the interpolated scan does not depend on the charge, so it is created only once
+      scan.hr_ref.reset(createHRData((UInt)i));
+      for (UInt c = 0; c < max_charge_; ++c)
+      {
+        iwt.initializeScan(*scan.hr_ref, c);
+        scan.trans[c] = *scan.hr_ref;
+        iwt.getTransformHighRes(scan.trans[c], *scan.hr_ref, c);
+      }
+    }
+  }
+
   const String FeatureFinderAlgorithmIsotopeWavelet::getProductName()
   {
     return "isotope_wavelet";
@@ -231,6 +231,13 @@ namespace OpenMS
     feat_finder_.setParameters(params);
     feat_finder_.setLogType(ProgressLogger::NONE);
     feat_finder_.setStrictFlag(false);
+    // the MS data is copied (here, for the chromatogram extraction and in
+    // "MRMFeatureFinderScoring::pickExperiment" for every batch), but only
+    // read - let the copies share the peaks:
+    for (MSSpectrum& spec : ms_data_)
+    {
+      spec.setCopyOnWrite(true);
+    }
     // to use MS1 Swath scores:
     feat_finder_.setMS1Map(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(boost::make_shared<MSExperiment>(ms_data_)));
 
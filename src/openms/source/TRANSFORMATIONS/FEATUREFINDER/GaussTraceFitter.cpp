@@ -195,8 +195,8 @@ namespace OpenMS
     double height = x(0);
     double x0 = x(1);
     double sig = x(2);
-    double sig_sq = pow(sig, 2);
-    double sig_3 = pow(sig, 3);
+    double sig_sq = sig * sig;
+    double sig_3 = sig_sq * sig;
     double c_fac = -0.5 / sig_sq;
 
     Size count = 0;
@@ -206,11 +206,13 @@ namespace OpenMS
       double weight = m_data->weighted ? trace.theoretical_int : 1.0;
       for (Size i = 0; i < trace.peaks.size(); ++i)
       {
-        double rt = trace.peaks[i].first;
-        double e = exp(c_fac * pow(rt - x0, 2));
-        J(count, 0) = trace.theoretical_int * e * weight;
-        J(count, 1) = trace.theoretical_int * height * e * (rt - x0) / sig_sq * weight;
-        J(count, 2) = 0.125* trace.theoretical_int* height* e* pow(rt - x0, 2) / sig_3 * weight;
+        double diff = trace.peaks[i].first - x0;
+        double diff_sq = diff * diff;
+        // d/dH, d/dx0 and d/dsigma of H * exp(-(t - x0)^2 / (2 * sigma^2)):
+        double d_height = trace.theoretical_int * exp(c_fac * diff_sq) * weight;
+        J(count, 0) = d_height;
+        J(count, 1) = d_height * height * diff / sig_sq;
+        J(count, 2) = d_height * height * diff_sq / sig_3;
         ++count;
       }
     }
@@ -0,0 +1,80 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformFFT.h>
+
+#include <Evergreen/evergreen.hpp>
+
+namespace OpenMS
+{
+  void ContinuousWaveletTransformFFT::init(double scale, double spacing)
+  {
+    // will set members for scale_ and spacing_
+    ContinuousWaveletTransform::init(scale, spacing);
+    int number_of_points = (int)(ceil(5 * scale_ / spacing_)) + 1;
+    wavelet_.clear();
+    wavelet_.reserve(number_of_points);
+    wavelet_.push_back(1.);
+
+    const double spacing_scale = spacing_ / scale_;
+    for (int i = 1; i < number_of_points; ++i)
+    {
+      wavelet_.push_back(marr_(i * spacing_scale));
+    }
+  }
+
+  void ContinuousWaveletTransformFFT::convolve_()
+  {
+    // the wavelet is symmetric, so the convolution equals the correlation with the wavelet
+    const unsigned long half_width = (unsigned long)ceil(5 * scale_ / grid_spacing_);
+    evergreen::Tensor<double> kernel({2 * half_width + 1});
+    for (unsigned long k = 0; k < 2 * half_width + 1; ++k)
+    {
+      kernel.flat()[k] = marr_(((double)k - (double)half_width) * grid_spacing_ / scale_);
+    }
+    evergreen::Tensor<double> data({(unsigned long)grid_.size()});
+    std::copy(grid_.begin(), grid_.end(), &data.flat()[0]);
+
+    const evergreen::Tensor<double> convolved = evergreen::fft_convolve(data, kernel);
+
+    // multiply by the grid spacing (integration) and normalize like ContinuousWaveletTransformNumIntegration
+    const double factor = grid_spacing_ / sqrt(scale_);
+    for (Size i = 0; i < grid_.size(); ++i)
+    {
+      grid_[i] = convolved.flat()[i + half_width] * factor;
+    }
+  }
+
+}
@@ -58,7 +58,8 @@ namespace OpenMS
     scale_(0.0),
     peak_corr_bound_(0.0),
     noise_level_(0.0),
-    optimization_(false)
+    optimization_(false),
+    fft_transform_(false)
   {
     defaults_.setValue("signal_to_noise", 1.0, "Minimal signal to noise ratio for a peak to be picked.");
     defaults_.setMinFloat("signal_to_noise", 0.0);
@@ -92,6 +93,8 @@ namespace OpenMS
 
     defaults_.setValue("wavelet_transform:spacing", 0.001, "Spacing of the CWT. Note that the accuracy of the picked peak's centroid position depends in the Raw data spacing, i.e., 50% of raw peak distance at most.", ListUtils::create<String>("advanced"));
     defaults_.setMinFloat("wavelet_transform:spacing", 0.0);
+    defaults_.setValue("wavelet_transform:algorithm", "integration", "Method used to compute the CWT. 'integration' integrates the wavelet numerically around every data point, 'fft' convolves the (resampled) spectrum with the wavelet via FFT, which is much faster for wide profile spectra but gives slightly different transform values.", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("wavelet_transform:algorithm", ListUtils::create<String>("integration,fft"));
     defaults_.setValue("thresholds:noise_level", 0.1, "noise level for the search of the peak endpoints.", ListUtils::create<String>("advanced"));
     defaults_.setMinFloat("thresholds:noise_level", 0.0);
     defaults_.setValue("thresholds:search_radius", 3, "search radius for the search of the maximum in the signal after a maximum in the cwt was found", ListUtils::create<String>("advanced"));
@@ -208,6 +211,7 @@ namespace OpenMS
     signal_to_noise_ = (float)param_.getValue("signal_to_noise");
 
     deconvolution_ = param_.getValue("deconvolution:deconvolution").toBool();
+    fft_transform_ = (param_.getValue("wavelet_transform:algorithm").toString() == "fft");
   }
 
   bool PeakPickerCWT::getMaxPosition_(
@@ -304,7 +308,7 @@ namespace OpenMS
                                         PeakArea_ & area,
                                         Int distance_from_scan_border,
                                         Int & peak_left_index,
-                                        Int & peak_right_index, ContinuousWaveletTransformNumIntegration & wt) const
+                                        Int & peak_right_index, ContinuousWaveletTransform & wt) const
   {
     // the Maximum may neither be the first or last point in the signal
     if ((area.max <= first) || (area.max >= last - 1))
@@ -561,7 +565,22 @@ namespace OpenMS
 
   }
 
-  void PeakPickerCWT::initializeWT_(ContinuousWaveletTransformNumIntegration& wt, const double peak_bound_in, double& peak_bound_ms_cwt) const
+  void PeakPickerCWT::transformWT_(ContinuousWaveletTransformNumIntegration& wt_integration, ContinuousWaveletTransformFFT& wt_fft,
+                                   ConstPeakIterator first, ConstPeakIterator last) const
+  {
+    // compute the continuous wavelet transform with resolution 1
+    const float resolution = 1.;
+    if (fft_transform_)
+    {
+      wt_fft.transform(first, last, resolution);
+    }
+    else
+    {
+      wt_integration.transform(first, last, resolution);
+    }
+  }
+
+  void PeakPickerCWT::initializeWT_(ContinuousWaveletTransform& wt, const double peak_bound_in, double& peak_bound_ms_cwt) const
   {
 #ifdef DEBUG_PEAK_PICKING
     std::cout << "PeakPickerCWT<D>::initialize_ peak_bound_" << peak_bound_ <<  std::endl;
@@ -587,9 +606,10 @@ namespace OpenMS
     MSSpectrum lorentz_peak;
     lorentz_peak.reserve(n);
 
-    // TODO: switch the type of the transform
-
-    ContinuousWaveletTransformNumIntegration lorentz_cwt;
+    // use the same type of transform as for the spectra
+    ContinuousWaveletTransformNumIntegration lorentz_cwt_integration;
+    ContinuousWaveletTransformFFT lorentz_cwt_fft;
+    ContinuousWaveletTransform& lorentz_cwt = fft_transform_ ? static_cast<ContinuousWaveletTransform&>(lorentz_cwt_fft) : lorentz_cwt_integration;
 
     lorentz_cwt.init(scale_, spacing);
     double start = -2 * scale_;
@@ -600,8 +620,7 @@ namespace OpenMS
       lorentz_peak.push_back(peak);
     }
 
-    const float resolution = 1.;
-    lorentz_cwt.transform(lorentz_peak.begin(), lorentz_peak.end(), resolution);
+    transformWT_(lorentz_cwt_integration, lorentz_cwt_fft, lorentz_peak.begin(), lorentz_peak.end());
 
     peak_bound_ms_cwt = 0;
     for (Int i = 0; i < lorentz_cwt.getSignalLength(); ++i)
@@ -1112,7 +1131,9 @@ namespace OpenMS
     output.getFloatDataArrays()[6].setName("SignalToNoise");
 
     /// The continuous wavelet "transformer"
-    ContinuousWaveletTransformNumIntegration wt;
+    ContinuousWaveletTransformNumIntegration wt_integration;
+    ContinuousWaveletTransformFFT wt_fft;
+    ContinuousWaveletTransform& wt = fft_transform_ ? static_cast<ContinuousWaveletTransform&>(wt_fft) : wt_integration;
     /// The minimal height which defines a peak in the CWT
     double peak_bound_ms_cwt = 0.0;
     double bound = (input.getMSLevel() <= 1 ? peak_bound_ : peak_bound_ms2_level_);
@@ -1160,8 +1181,7 @@ namespace OpenMS
       Int peak_left_index, peak_right_index;
 
       // compute the continuous wavelet transform with resolution 1
-      const double resolution = 1;
-      wt.transform(it_pick_begin, it_pick_end, resolution);
+      transformWT_(wt_integration, wt_fft, it_pick_begin, it_pick_end);
       PeakArea_ area;
 
       // search for maximum positions in the cwt and extract potential peaks
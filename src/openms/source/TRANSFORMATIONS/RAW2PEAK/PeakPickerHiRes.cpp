@@ -35,17 +35,183 @@
 
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
 #include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedian.h>
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianExact.h>
 #include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <tuple>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /**
+      @brief Raw data points of a peak, collected for spline interpolation
+
+      Behaves like a std::map from position to intensity (a later point replaces an earlier one at the same position),
+      but keeps its memory between peaks. Points are added from the apex outwards: first the apex, then its left and
+      right neighbors, then the extension to the left and then the extension to the right. For sorted input, both
+      sides are therefore already sorted and only need to be joined.
+    */
+    struct PeakRawData
+    {
+      std::vector<std::pair<double, double> > left; ///< (position, intensity) left of the apex, in order of insertion
+      std::vector<std::pair<double, double> > right; ///< (position, intensity) of the apex and right of it, in order of insertion
+      std::pair<double, double> lowest; ///< point with the lowest position
+      std::pair<double, double> highest; ///< point with the highest position
+      std::vector<double> x; ///< sorted, unique positions (filled by "finalize")
+      std::vector<double> y; ///< intensities corresponding to "x" (filled by "finalize")
+      std::vector<std::tuple<double, Size, double> > unsorted; ///< (position, insertion rank, intensity) for unsorted input
+      CubicSpline2d spline; ///< interpolation of the peak; re-initialized (without allocating) for every peak
+
+      /// Removes all points and starts a new peak at the apex
+      void clear(double pos, double intensity)
+      {
+        left.clear();
+        right.clear();
+        right.emplace_back(pos, intensity);
+        lowest = right.back();
+        highest = right.back();
+      }
+
+      void addLeft(double pos, double intensity)
+      {
+        track_(pos, intensity);
+        left.emplace_back(pos, intensity);
+      }
+
+      void addRight(double pos, double intensity)
+      {
+        track_(pos, intensity);
+        right.emplace_back(pos, intensity);
+      }
+
+      /// Fills @p x and @p y; returns the number of unique positions
+      Size finalize()
+      {
+        x.clear();
+        y.clear();
+        for (auto it = left.rbegin(); it != left.rend(); ++it)
+        {
+          x.push_back(it->first);
+          y.push_back(it->second);
+        }
+        for (const auto& point : right)
+        {
+          x.push_back(point.first);
+          y.push_back(point.second);
+        }
+        if (std::adjacent_find(x.begin(), x.end(), std::greater_equal<double>()) == x.end())
+        {
+          return x.size(); // strictly ascending (the usual case)
+        }
+
+        // unsorted input or repeated positions - sort by position and order of insertion:
+        unsorted.clear();
+        for (Size i = 0; i < left.size(); ++i)
+        {
+          unsorted.emplace_back(left[i].first, insertionRank_(true, i), left[i].second);
+        }
+        for (Size i = 0; i < right.size(); ++i)
+        {
+          unsorted.emplace_back(right[i].first, insertionRank_(false, i), right[i].second);
+        }
+        std::sort(unsorted.begin(), unsorted.end());
+        x.clear();
+        y.clear();
+        for (const auto& point : unsorted)
+        {
+          if (!x.empty() && (std::get<0>(point) == x.back()))
+          {
+            y.back() = std::get<2>(point); // same position: later point wins
+          }
+          else
+          {
+            x.push_back(std::get<0>(point));
+            y.push_back(std::get<2>(point));
+          }
+        }
+        return x.size();
+      }
+
+    private:
+      void track_(double pos, double intensity)
+      {
+        if (pos < lowest.first) lowest = std::make_pair(pos, intensity);
+        else if (pos == lowest.first) lowest.second = intensity;
+        if (pos > highest.first) highest = std::make_pair(pos, intensity);
+        else if (pos == highest.first) highest.second = intensity;
+      }
+
+      /// Position of a point in the order of insertion (apex, left neighbor, right neighbor, left extension, right extension)
+      Size insertionRank_(bool left_side, Size index) const
+      {
+        if (left_side) return (index == 0) ? 1 : index + 2;
+        if (index < 2) return 2 * index;
+        return left.size() + index;
+      }
+    };
+  }
+
+  struct PeakPickerHiRes::Workspace_
+  {
+    explicit Workspace_(const PeakPickerHiRes& picker) :
+      picker_(picker)
+    {
+    }
+
+    /// Returns the noise estimator for spectra (created on first use)
+    SignalToNoiseEstimator<MSSpectrum>& estimator(const MSSpectrum&)
+    {
+      return getEstimator_(spectrum_snt_);
+    }
+
+    /// Returns the noise estimator for chromatograms (created on first use)
+    SignalToNoiseEstimator<MSChromatogram>& estimator(const MSChromatogram&)
+    {
+      return getEstimator_(chromatogram_snt_);
+    }
+
+    PeakRawData peak_raw_data;
+
+  private:
+    template <typename ContainerType>
+    SignalToNoiseEstimator<ContainerType>& getEstimator_(std::unique_ptr<SignalToNoiseEstimator<ContainerType> >& snt)
+    {
+      if (!snt)
+      {
+        if (picker_.sn_estimator_exact_)
+        {
+          snt.reset(new SignalToNoiseEstimatorMedianExact<ContainerType>());
+        }
+        else
+        {
+          snt.reset(new SignalToNoiseEstimatorMedian<ContainerType>());
+        }
+        // pass only the parameters known to the chosen estimator
+        snt->setParameters(picker_.param_.copy("SignalToNoise:", true).copySubset(snt->getDefaults()));
+      }
+      return *snt;
+    }
+
+    const PeakPickerHiRes& picker_;
+    std::unique_ptr<SignalToNoiseEstimator<MSSpectrum> > spectrum_snt_;
+    std::unique_ptr<SignalToNoiseEstimator<MSChromatogram> > chromatogram_snt_;
+  };
+
   PeakPickerHiRes::PeakPickerHiRes() :
     DefaultParamHandler("PeakPickerHiRes"),
     ProgressLogger()
@@ -73,6 +239,8 @@ namespace OpenMS
 
     // parameters for STN estimator
     defaults_.insert("SignalToNoise:", SignalToNoiseEstimatorMedian< MSSpectrum >().getDefaults());
+    defaults_.setValue("SignalToNoise:estimator", "histogram", "Noise estimate of the sliding window: the median of a histogram of the intensities ('histogram', uses 'bin_count' and the 'max_intensity'/'auto_*' settings) or the exact median of the intensities ('exact').", ListUtils::create<String>("advanced"));
+    defaults_.setValidStrings("SignalToNoise:estimator", ListUtils::create<String>("histogram,exact"));
 
     // write defaults into Param object param_
     defaultsToParam_();
@@ -96,6 +264,18 @@ namespace OpenMS
   }
 
   void PeakPickerHiRes::pick(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    Workspace_ ws(*this);
+    pick_(input, output, boundaries, check_spacings, ws);
+  }
+
+  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    Workspace_ ws(*this);
+    pick_(input, output, boundaries, check_spacings, ws);
+  }
+
+  void PeakPickerHiRes::pick_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const
   {
     // copy meta data of the input spectrum
     output.clear(true);
@@ -105,10 +285,10 @@ namespace OpenMS
     output.setMSLevel(input.getMSLevel());
     output.setName(input.getName());
     output.setType(SpectrumSettings::CENTROID);
-    pick_(input, output, boundaries, check_spacings);
+    pickPeaks_(input, output, boundaries, check_spacings, ws);
   }
 
-  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  void PeakPickerHiRes::pick_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const
   {
     // copy meta data of the input chromatogram
     output.clear(true);
@@ -116,11 +296,11 @@ namespace OpenMS
     output.MetaInfoInterface::operator=(input);
     output.setName(input.getName());
 
-    pick_(input, output, boundaries, check_spacings);
+    pickPeaks_(input, output, boundaries, check_spacings, ws);
   }
 
   template <typename ContainerType>
-  void PeakPickerHiRes::pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  void PeakPickerHiRes::pickPeaks_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_& ws) const
   {
     if (report_FWHM_)
     {
@@ -138,9 +318,8 @@ namespace OpenMS
       check_spacings = false;
     }
 
-    // signal-to-noise estimation
-    SignalToNoiseEstimatorMedian< ContainerType > snt;
-    snt.setParameters(param_.copy("SignalToNoise:", true));
+    // signal-to-noise estimation (the estimator keeps its buffers between calls)
+    SignalToNoiseEstimator< ContainerType >& snt = ws.estimator(input);
 
     if (signal_to_noise_ > 0.0)
     {
@@ -212,11 +391,11 @@ namespace OpenMS
           continue;
         }
 
-        std::map<double, double> peak_raw_data;
-
-        peak_raw_data[central_peak_mz] = central_peak_int;
-        peak_raw_data[left_neighbor_mz] = left_neighbor_int;
-        peak_raw_data[right_neighbor_mz] = right_neighbor_int;
+        // reused between peaks and spectra to avoid allocations:
+        PeakRawData& peak_raw_data = ws.peak_raw_data;
+        peak_raw_data.clear(central_peak_mz, central_peak_int);
+        peak_raw_data.addLeft(left_neighbor_mz, left_neighbor_int);
+        peak_raw_data.addRight(right_neighbor_mz, right_neighbor_int);
 
         // peak core found, now extend it
         // to the left
@@ -230,9 +409,9 @@ namespace OpenMS
           (i - k + 1 > 0) && 
           !previous_zero_left && 
           (missing_left <= missing_) && 
-          (input[i - k].getIntensity() <= peak_raw_data.begin()->second) &&
+          (input[i - k].getIntensity() <= peak_raw_data.lowest.second) &&
           (!check_spacings || 
-          (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
+          (peak_raw_data.lowest.first - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
         {
           double act_snt_lk = 0.0;
 
@@ -243,16 +422,16 @@ namespace OpenMS
 
           if ((act_snt_lk >= signal_to_noise_) && 
             (!check_spacings ||
-            (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
+            (peak_raw_data.lowest.first - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+            peak_raw_data.addLeft(input[i - k].getMZ(), input[i - k].getIntensity());
           }
           else
           {
             ++missing_left;
             if (missing_left <= missing_)
             {
-              peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+              peak_raw_data.addLeft(input[i - k].getMZ(), input[i - k].getIntensity());
             }
           }
 
@@ -271,9 +450,9 @@ namespace OpenMS
         while ((i + k < input.size()) && 
           !previous_zero_right && 
           (missing_right <= missing_) && 
-          (input[i + k].getIntensity() <= peak_raw_data.rbegin()->second) &&
+          (input[i + k].getIntensity() <= peak_raw_data.highest.second) &&
           (!check_spacings ||
-          (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_gap_ * min_spacing)))
+          (input[i + k].getMZ() - peak_raw_data.highest.first < spacing_difference_gap_ * min_spacing)))
         {
           double act_snt_rk = 0.0;
 
@@ -284,16 +463,16 @@ namespace OpenMS
 
           if ((act_snt_rk >= signal_to_noise_) && 
             (!check_spacings ||
-            (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_ * min_spacing)))
+            (input[i + k].getMZ() - peak_raw_data.highest.first < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+            peak_raw_data.addRight(input[i + k].getMZ(), input[i + k].getIntensity());
           }
           else
           {
             ++missing_right;
             if (missing_right <= missing_)
             {
-              peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+              peak_raw_data.addRight(input[i + k].getMZ(), input[i + k].getIntensity());
             }
           }
 
@@ -303,9 +482,14 @@ namespace OpenMS
         }
 
         // skip if the minimal number of 3 points for fitting is not reached
-        if (peak_raw_data.size() < 3) continue;
+        if (peak_raw_data.finalize() < 3) continue;
 
-        CubicSpline2d peak_spline (peak_raw_data);
+        // Each peak gets its own spline. The tridiagonal solve is sequential and
+        // peaks have only a few knots, so fitting several peaks at once (SIMD
+        // batches) does not pay off. Re-initializing the spline avoids
+        // reallocation.
+        peak_raw_data.spline.init(peak_raw_data.x, peak_raw_data.y);
+        const CubicSpline2d& peak_spline = peak_raw_data.spline;
 
         // calculate maximum by evaluating the spline's 1st derivative
         // (bisection method)
@@ -323,7 +507,7 @@ namespace OpenMS
           threshold = 0.01 * fwhm_int;
           double mz_mid, int_mid; 
           // left:
-          double mz_left = peak_raw_data.begin()->first;
+          double mz_left = peak_raw_data.x.front();
           double mz_center = max_peak_mz;
           if (peak_spline.eval(mz_left) > fwhm_int)
           { // the spline ends before half max is reached -- take the leftmost point (probably an underestimation)
@@ -348,7 +532,7 @@ namespace OpenMS
           const double fwhm_left_mz = mz_mid;
 
           // right ...
-          double mz_right = peak_raw_data.rbegin()->first;
+          double mz_right = peak_raw_data.x.back();
           mz_center = max_peak_mz;
           if (peak_spline.eval(mz_right) > fwhm_int)
           { // the spline ends before half max is reached -- take the rightmost point (probably an underestimation)
@@ -426,63 +610,107 @@ namespace OpenMS
     Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    // MSLevel -> stats
-    map<int, SpectraPickInfo> pick_info;
+    // spectra are picked in parallel; results are collected by index, so the
+    // output doesn't depend on the number of threads:
+    std::vector<std::vector<PeakBoundary> > boundaries_per_scan(input.size());
+    std::vector<char> was_picked(input.size(), false);
+    ParallelExceptionCollector errors;
 
-    if (input.getNrSpectra() > 0)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      Workspace_ ws(*this); // one per thread
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
       {
-        bool was_picked{false};
-        // auto mode
-        if (ms_levels_.empty()) 
+        errors.run([&]()
         {
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID)
+          // auto mode
+          if (ms_levels_.empty()) 
+          {
+            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+            if (spectrum_type == SpectrumSettings::CENTROID)
+            {
+              output[scan_idx] = input[scan_idx];
+            }
+            else
+            {
+              pick_(input[scan_idx], output[scan_idx], boundaries_per_scan[scan_idx], true, ws);
+              was_picked[scan_idx] = true;
+            }
+          }
+          // manual mode
+          else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
           {
             output[scan_idx] = input[scan_idx];
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
+            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+            if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+
+            pick_(input[scan_idx], output[scan_idx], boundaries_per_scan[scan_idx], true, ws);
+            was_picked[scan_idx] = true;
           }
-        }
-        // manual mode
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
+        });
+#ifdef _OPENMP
+#pragma omp critical (PeakPickerHiRes_progress)
+#endif
         {
-          output[scan_idx] = input[scan_idx];
+          setProgress(++progress);
         }
-        else
-        {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
-          {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-          }
-
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
-        }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
       }
     }
+    errors.rethrow();
 
+    // MSLevel -> stats
+    map<int, SpectraPickInfo> pick_info;
+    for (Size scan_idx = 0; scan_idx < input.size(); ++scan_idx)
+    {
+      pick_info[input[scan_idx].getMSLevel()].picked += was_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
+      if (was_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(boundaries_per_scan[scan_idx]));
+      }
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    const std::vector<MSChromatogram>& input_chroms = input.getChromatograms();
+    std::vector<MSChromatogram> chromatograms(input_chroms.size());
+    std::vector<std::vector<PeakBoundary> > boundaries_per_chrom(input_chroms.size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      Workspace_ ws(*this); // one per thread
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)input_chroms.size(); ++i)
+      {
+        errors.run([&]()
+        {
+          pick_(input_chroms[i], chromatograms[i], boundaries_per_chrom[i], false, ws);
+        });
+#ifdef _OPENMP
+#pragma omp critical (PeakPickerHiRes_progress)
+#endif
+        {
+          setProgress(++progress);
+        }
+      }
+    }
+    errors.rethrow();
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      output.addChromatogram(std::move(chromatograms[i]));
+      boundaries_chrom.push_back(std::move(boundaries_per_chrom[i]));
     }
     endProgress();
 
@@ -509,53 +737,106 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    if (input.getNrSpectra() > 0)
+    // Reading from disc is not thread-safe, so spectra are read (and decoded)
+    // in batches by one thread, while the other threads pick the previous
+    // batch. Results are stored by index, so the output is deterministic.
+    const Size n_spectra = input.getNrSpectra() > 0 ? input.size() : 0;
+    Size batch_size = 16;
+#ifdef _OPENMP
+    batch_size *= omp_get_max_threads();
+#endif
+    const Size n_batches = (n_spectra + batch_size - 1) / batch_size;
+    std::vector<MSSpectrum> current_batch, next_batch;
+    ParallelExceptionCollector errors;
+
+    auto readBatch = [&input, &errors, batch_size, n_spectra](Size batch, std::vector<MSSpectrum>& spectra)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      spectra.clear();
+      errors.run([&]()
       {
-        if (ms_levels_.empty()) //auto mode
+        for (Size scan_idx = batch * batch_size; scan_idx < std::min(n_spectra, (batch + 1) * batch_size); ++scan_idx)
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            pick(s, output[scan_idx]);
-          }
+          spectra.push_back(input[scan_idx]);
         }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+      });
+    };
+
+    if (n_batches > 0) readBatch(0, current_batch);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      Workspace_ ws(*this); // one per thread
+      std::vector<PeakBoundary> boundaries;
+      for (Size batch = 0; batch < n_batches; ++batch)
+      {
+        // prefetch the next batch while the current one is picked:
+#ifdef _OPENMP
+#pragma omp single nowait
+#endif
         {
-          output[scan_idx] = input[scan_idx];
+          if (batch + 1 < n_batches) readBatch(batch + 1, next_batch);
         }
-        else
-        {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)current_batch.size(); ++i)
+        {
+          const Size scan_idx = batch * batch_size + i;
+          MSSpectrum& s = current_batch[i];
+          errors.run([&]()
+          {
+            if (!ms_levels_.empty() && !ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
+            {
+              output[scan_idx] = std::move(s);
+            }
+            else
+            {
+              // determine type of spectral data (profile or centroided)
+              SpectrumSettings::SpectrumType spectrum_type = s.getType();
+              if (ms_levels_.empty() && (spectrum_type == SpectrumSettings::CENTROID)) // auto mode
+              {
+                output[scan_idx] = std::move(s);
+              }
+              else
+              {
+                if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+                {
+                  throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+                }
+                s.sortByPosition();
+                boundaries.clear();
+                pick_(s, output[scan_idx], boundaries, true, ws);
+              }
+            }
+          });
+#ifdef _OPENMP
+#pragma omp critical (PeakPickerHiRes_progress)
+#endif
           {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            setProgress(++progress);
           }
+        } // implicit barrier: batch is done and the next one has been read
 
-          pick(s, output[scan_idx]);
+#ifdef _OPENMP
+#pragma omp single
+#endif
+        {
+          current_batch.swap(next_batch);
         }
-        setProgress(++progress);
       }
     }
+    errors.rethrow();
 
+    Workspace_ ws(*this);
+    std::vector<PeakBoundary> boundaries;
     for (Size i = 0; i < input.getNrChromatograms(); ++i)
     {
       MSChromatogram chromatogram;
-      pick(input.getChromatogram(i), chromatogram);
+      boundaries.clear();
+      pick_(input.getChromatogram(i), chromatogram, boundaries, false, ws);
       output.addChromatogram(chromatogram);
       setProgress(++progress);
     }
@@ -567,6 +848,7 @@ namespace OpenMS
   void PeakPickerHiRes::updateMembers_()
   {
     signal_to_noise_ = param_.getValue("signal_to_noise");
+    sn_estimator_exact_ = param_.getValue("SignalToNoise:estimator") == "exact";
     spacing_difference_gap_ = param_.getValue("spacing_difference_gap");
     if (spacing_difference_gap_ == 0.0) spacing_difference_gap_ = std::numeric_limits<double>::infinity();
     spacing_difference_ = param_.getValue("spacing_difference");
@@ -4,6 +4,7 @@ set(directory source/TRANSFORMATIONS/RAW2PEAK)
 ### list all filenames of the directory here
 set(sources_list
 ContinuousWaveletTransform.cpp
+ContinuousWaveletTransformFFT.cpp
 ContinuousWaveletTransformNumIntegration.cpp
 OptimizePeakDeconvolution.cpp
 OptimizePick.cpp
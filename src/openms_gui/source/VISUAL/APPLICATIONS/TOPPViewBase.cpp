@@ -2254,12 +2254,13 @@ namespace OpenMS
             // the newly created MSExperiment
             if (spec.size() > 0)
             {
-              // Get data from memory - copy data and tell TOPPView that this
-              // is MS1 data so that it will be displayed properly in 2D and 3D
+              // Get data from memory - copy data (shared with the layer if
+              // its spectra use copy-on-write) and tell TOPPView that this is
+              // MS1 data so that it will be displayed properly in 2D and 3D
               // view
               MSSpectrum t = spec;
               t.setMSLevel(1);
-              tmpe->addSpectrum(t);
+              tmpe->addSpectrum(std::move(t));
             }
             else if (layer.getOnDiscPeakData()->getNrSpectra() > k)
             {
@@ -2268,7 +2269,7 @@ namespace OpenMS
               // view
               MSSpectrum t = layer.getOnDiscPeakData()->getSpectrum(k);
               t.setMSLevel(1);
-              tmpe->addSpectrum(t);
+              tmpe->addSpectrum(std::move(t));
             }
           }
         }
@@ -119,6 +119,12 @@ public:
     OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelation(std::vector<double>& data1,
                                                                    std::vector<double>& data2, const int& maxdelay, const int& lag);
 
+    /// Calculate crosscorrelation on std::vector data that has already been standardized (see standardize_data)
+    /// The result is identical to normalizedCrossCorrelation, but the input is not modified which allows
+    /// to standardize a trace once and correlate it against many others.
+    OPENSWATHALGO_DLLAPI XCorrArrayType standardizedCrossCorrelation(const std::vector<double>& data1,
+                                                                     const std::vector<double>& data2, const int& maxdelay, const int& lag);
+
     /// Calculate crosscorrelation on std::vector data without normalization
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
                                                                   const std::vector<double>& data2, const int& maxdelay, const int& lag);
@@ -138,6 +144,28 @@ public:
     // Estimate rank-transformed mutual information between two vectors of data points
     OPENSWATHALGO_DLLAPI double rankedMutualInformation(std::vector<double>& data1, std::vector<double>& data2);
 
+    /// Rank-transformed data vector (see computeRank) together with the number of data points of each rank
+    struct OPENSWATHALGO_DLLAPI RankedVector
+    {
+      std::vector<unsigned int> ranks; ///< rank of each data point
+      std::vector<unsigned int> counts; ///< number of data points with a given rank (indexed by rank)
+    };
+
+    /// Rank a vector of data points once so that it can be used for many calls to rankedMutualInformation
+    OPENSWATHALGO_DLLAPI RankedVector computeRankedVector(const std::vector<double>& data);
+
+    /**
+      @brief Estimate rank-transformed mutual information between two pre-ranked vectors
+
+      Gives the same result as rankedMutualInformation on the original data.
+      Instead of allocating the full (dense) joint probability table, only
+      the occupied cells of the joint histogram are collected in @p workspace
+      which is reused across calls and does not allocate once it has reached
+      the length of the data.
+    */
+    OPENSWATHALGO_DLLAPI double rankedMutualInformation(const RankedVector& data1, const RankedVector& data2,
+                                                        std::vector<std::pair<unsigned int, unsigned int> >& workspace);
+
     //@}
 
   }
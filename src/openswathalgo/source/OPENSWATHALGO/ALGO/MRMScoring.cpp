@@ -41,29 +41,96 @@
 #include <iterator>
 
 
-namespace OpenSwath
+namespace
 {
+  typedef std::vector<std::vector<double> > TraceVectorType;
 
-  const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
+  /// Retrieve the intensity trace of each given fragment (or precursor) feature exactly once
+  void appendIntensityTraces(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& ids, bool precursor, TraceVectorType& traces)
   {
-    return xcorr_matrix_;
+    for (std::size_t i = 0; i < ids.size(); i++)
+    {
+      OpenSwath::MRMScoring::FeatureType f = precursor ? mrmfeature->getPrecursorFeature(ids[i]) : mrmfeature->getFeature(ids[i]);
+      traces.emplace_back();
+      f->getIntensity(traces.back());
+    }
   }
 
-  void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
+  /// Standardize each trace once so that it can be correlated against all others without copying it
+  void standardizeTraces(TraceVectorType& traces)
+  {
+    for (std::size_t i = 0; i < traces.size(); i++)
+    {
+      OpenSwath::Scoring::standardize_data(traces[i]);
+    }
+  }
+
+  /// Rank each trace once so that it can be used for all pairs in a mutual information matrix
+  void rankTraces(const TraceVectorType& traces, std::vector<OpenSwath::Scoring::RankedVector>& ranked)
+  {
+    ranked.resize(traces.size());
+    for (std::size_t i = 0; i < traces.size(); i++)
+    {
+      ranked[i] = OpenSwath::Scoring::computeRankedVector(traces[i]);
+    }
+  }
+
+  /// Cross-correlation of (b, a) from the cross-correlation of (a, b), valid for a symmetric lag range
+  void mirrorXCorr(const OpenSwath::MRMScoring::XCorrArrayType& xcorr, OpenSwath::MRMScoring::XCorrArrayType& mirrored)
+  {
+    mirrored.data.resize(xcorr.data.size());
+    std::size_t k = xcorr.data.size();
+    for (OpenSwath::MRMScoring::XCorrArrayType::const_iterator it = xcorr.begin(); it != xcorr.end(); ++it)
+    {
+      mirrored.data[--k] = std::make_pair(-it->first, it->second);
+    }
+  }
+
+  /**
+    @brief Fill a cross-correlation matrix from two sets of standardized traces
+
+    Each trace has already been standardized, so every pair only costs the
+    correlation itself. If @p upper_only is set (set1 and set2 are the same
+    set), only the entries j >= i are computed, otherwise the full matrix.
+    With @p mirror_lower, the entries j < i of a square matrix are obtained by
+    mirroring entry (j, i) which is exact since both sums contain the same
+    products in the same order.
+  */
+  void fillXCorrMatrix(const TraceVectorType& set1, const TraceVectorType& set2, bool upper_only, bool mirror_lower,
+                        OpenSwath::MRMScoring::XCorrMatrixType& matrix)
   {
-    xcorr_matrix_.resize(data.size());
-    for (std::size_t i = 0; i < data.size(); i++)
+    matrix.resize(set1.size());
+    for (std::size_t i = 0; i < set1.size(); i++)
     {
-      xcorr_matrix_[i].resize(data.size());
-      for (std::size_t j = i; j < data.size(); j++)
+      matrix[i].resize(set2.size());
+      for (std::size_t j = upper_only ? i : 0; j < set2.size(); j++)
       {
+        if (mirror_lower && j < i)
+        {
+          mirrorXCorr(matrix[j][i], matrix[i][j]);
+          continue;
+        }
         // compute normalized cross correlation
-        std::vector< double > tmp1(data[i]);
-        std::vector< double > tmp2(data[j]);
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(data[i].size()), 1);
+        matrix[i][j] = OpenSwath::Scoring::standardizedCrossCorrelation(set1[i], set2[j], boost::numeric_cast<int>(set1[i].size()), 1);
       }
     }
   }
+}
+
+namespace OpenSwath
+{
+
+  const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
+  {
+    return xcorr_matrix_;
+  }
+
+  void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
+  {
+    TraceVectorType traces(data);
+    standardizeTraces(traces);
+    fillXCorrMatrix(traces, traces, true, false, xcorr_matrix_);
+  }
 
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrContrastMatrix() const
   {
@@ -82,149 +149,64 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, native_ids, false, traces);
+    standardizeTraces(traces);
+    fillXCorrMatrix(traces, traces, true, false, xcorr_matrix_);
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    TraceVectorType traces1, traces2;
+    appendIntensityTraces(mrmfeature, native_ids_set1, false, traces1);
+    appendIntensityTraces(mrmfeature, native_ids_set2, false, traces2);
+    standardizeTraces(traces1);
+    standardizeTraces(traces2);
+    fillXCorrMatrix(traces1, traces2, false, false, xcorr_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces);
+    standardizeTraces(traces);
+    fillXCorrMatrix(traces, traces, true, false, xcorr_precursor_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    TraceVectorType traces1, traces2;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces1);
+    appendIntensityTraces(mrmfeature, native_ids, false, traces2);
+    standardizeTraces(traces1);
+    standardizeTraces(traces2);
+    fillXCorrMatrix(traces1, traces2, false, false, xcorr_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(const std::vector< std::vector< double > >& data_precursor, const std::vector< std::vector< double > >& data_fragments)
   {
-    xcorr_precursor_contrast_matrix_.resize(data_precursor.size());
-    for (std::size_t i = 0; i < data_precursor.size(); i++)
-    { 
-      xcorr_precursor_contrast_matrix_[i].resize(data_fragments.size());
-      for (std::size_t j = 0; j < data_fragments.size(); j++)
-      {
-        // compute normalized cross correlation
-        std::vector< double > tmp1(data_precursor[i]);
-        std::vector< double > tmp2(data_fragments[j]);
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(tmp1.size()), 1);
+    TraceVectorType traces1(data_precursor), traces2(data_fragments);
+    standardizeTraces(traces1);
+    standardizeTraces(traces2);
+    fillXCorrMatrix(traces1, traces2, false, false, xcorr_precursor_contrast_matrix_);
 #ifdef MRMSCORING_TESTING
-        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< tmp1.size() << " / " << tmp2.size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
-#endif
+    for (std::size_t i = 0; i < traces1.size(); i++)
+    {
+      for (std::size_t j = 0; j < traces2.size(); j++)
+      {
+        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< traces1[i].size() << " / " << traces2[j].size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
       }
     }
+#endif
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces);
+    appendIntensityTraces(mrmfeature, native_ids, false, traces);
+    standardizeTraces(traces);
+    fillXCorrMatrix(traces, traces, false, true, xcorr_precursor_combined_matrix_);
   }
 
   // see /IMSB/users/reiterl/bin/code/biognosys/trunk/libs/mrm_libs/MRM_pgroup.pm
@@ -710,128 +692,100 @@ namespace OpenSwath
 
   void MRMScoring::initializeMIMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, native_ids, false, traces);
+    std::vector<Scoring::RankedVector> ranked;
+    std::vector<std::pair<unsigned int, unsigned int> > workspace;
+    rankTraces(traces, ranked);
+    mi_matrix_.resize(traces.size());
+    for (std::size_t i = 0; i < traces.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
+      mi_matrix_[i].resize(traces.size());
+      for (std::size_t j = i; j < traces.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute ranked mutual information
-        mi_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
+        mi_matrix_[i][j] = Scoring::rankedMutualInformation(ranked[i], ranked[j], workspace);
       }
     }
   }
 
   void MRMScoring::initializeMIContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_set1, std::vector<String> native_ids_set2)
   { 
-    std::vector<double> intensityi, intensityj;
-    mi_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
+    TraceVectorType traces1, traces2;
+    appendIntensityTraces(mrmfeature, native_ids_set1, false, traces1);
+    appendIntensityTraces(mrmfeature, native_ids_set2, false, traces2);
+    std::vector<Scoring::RankedVector> ranked1, ranked2;
+    std::vector<std::pair<unsigned int, unsigned int> > workspace;
+    rankTraces(traces1, ranked1);
+    rankTraces(traces2, ranked2);
+    mi_contrast_matrix_.resize(traces1.size());
+    for (std::size_t i = 0; i < traces1.size(); i++)
     { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
+      mi_contrast_matrix_[i].resize(traces2.size());
+      for (std::size_t j = 0; j < traces2.size(); j++)
       {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute ranked mutual information
-        mi_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
+        mi_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(ranked1[i], ranked2[j], workspace);
       }
     }
   }
 
   void MRMScoring::initializeMIPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces);
+    std::vector<Scoring::RankedVector> ranked;
+    std::vector<std::pair<unsigned int, unsigned int> > workspace;
+    rankTraces(traces, ranked);
+    mi_precursor_matrix_.resize(traces.size());
+    for (std::size_t i = 0; i < traces.size(); i++)
     {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
+      mi_precursor_matrix_[i].resize(traces.size());
+      for (std::size_t j = i; j < traces.size(); j++)
       {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute ranked mutual information
-        mi_precursor_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
+        mi_precursor_matrix_[i][j] = Scoring::rankedMutualInformation(ranked[i], ranked[j], workspace);
       }
     }
   }
 
   void MRMScoring::initializeMIPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    TraceVectorType traces1, traces2;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces1);
+    appendIntensityTraces(mrmfeature, native_ids, false, traces2);
+    std::vector<Scoring::RankedVector> ranked1, ranked2;
+    std::vector<std::pair<unsigned int, unsigned int> > workspace;
+    rankTraces(traces1, ranked1);
+    rankTraces(traces2, ranked2);
+    mi_precursor_contrast_matrix_.resize(traces1.size());
+    for (std::size_t i = 0; i < traces1.size(); i++)
     { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
+      mi_precursor_contrast_matrix_[i].resize(traces2.size());
+      for (std::size_t j = 0; j < traces2.size(); j++)
       {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute ranked mutual information
-        mi_precursor_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
+        mi_precursor_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(ranked1[i], ranked2[j], workspace);
       }
     }
   }
 
   void MRMScoring::initializeMIPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    mi_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
+    TraceVectorType traces;
+    appendIntensityTraces(mrmfeature, precursor_ids, true, traces);
+    appendIntensityTraces(mrmfeature, native_ids, false, traces);
+    std::vector<Scoring::RankedVector> ranked;
+    std::vector<std::pair<unsigned int, unsigned int> > workspace;
+    rankTraces(traces, ranked);
+    mi_precursor_combined_matrix_.resize(traces.size());
+    for (std::size_t i = 0; i < traces.size(); i++)
     { 
-      FeatureType fi = features[i];
-      mi_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
+      mi_precursor_combined_matrix_[i].resize(traces.size());
+      for (std::size_t j = 0; j < traces.size(); j++)
       {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute ranked mutual information
-        mi_precursor_combined_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
+        mi_precursor_combined_matrix_[i][j] = Scoring::rankedMutualInformation(ranked[i], ranked[j], workspace);
       }
     }
   }
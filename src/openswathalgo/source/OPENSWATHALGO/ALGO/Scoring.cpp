@@ -36,15 +36,10 @@
 #include <OpenMS/OPENSWATHALGO/Macros.h>
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 
 #include <boost/numeric/conversion/cast.hpp>
 
-// Import dependencies from MIToolbox
-#include <ArrayOperations.c>
-#include <CalculateProbability.c>
-#include <Entropy.c>
-#include <MutualInformation.c>
-
 namespace OpenSwath
 {
   namespace Scoring
@@ -164,6 +159,14 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
+      return standardizedCrossCorrelation(data1, data2, maxdelay, lag);
+    }
+
+    XCorrArrayType standardizedCrossCorrelation(const std::vector<double>& data1,
+                                                const std::vector<double>& data2, const int& maxdelay, const int& lag)
+    {
+      OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
+
       XCorrArrayType result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
       for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
@@ -180,19 +183,60 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
-
-      for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
+      const double* x = &data1[0];
+      const double* y = &data2[0];
+
+      // Only positions i where i + delay lies inside data2 contribute, so each
+      // delay iterates over exactly that range (in increasing order of i to
+      // keep the summation order). Four consecutive delays are accumulated in
+      // the same pass over their common range, which keeps the four
+      // independent sums in flight instead of waiting on a single one.
+      int delay = -maxdelay;
+      for (; delay + 3 * lag <= maxdelay; delay += 4 * lag)
       {
-        double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        int start[4], end[4];
+        double sxy[4] = {0, 0, 0, 0};
+        for (int k = 0; k < 4; ++k)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
+          start[k] = std::max(0, -(delay + k * lag));
+          end[k] = std::min(datasize, datasize - (delay + k * lag));
+        }
+        // start and end decrease with the delay: [start[0], end[3]) is common to all four
+        const int common_start = start[0];
+        const int common_end = std::max(common_start, end[3]);
+        for (int k = 0; k < 4; ++k)
+        {
+          const int d = delay + k * lag;
+          for (int i = start[k]; i < std::min(common_start, end[k]); ++i)
           {
-            continue;
+            sxy[k] += x[i] * y[i + d];
+          }
+        }
+        for (int i = common_start; i < common_end; ++i)
+        {
+          sxy[0] += x[i] * y[i + delay];
+          sxy[1] += x[i] * y[i + delay + lag];
+          sxy[2] += x[i] * y[i + delay + 2 * lag];
+          sxy[3] += x[i] * y[i + delay + 3 * lag];
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+          const int d = delay + k * lag;
+          for (int i = std::max(common_end, start[k]); i < end[k]; ++i)
+          {
+            sxy[k] += x[i] * y[i + d];
           }
-          sxy += (data1[i]) * (data2[j]);
+          result.data.push_back(std::make_pair(d, sxy[k]));
+        }
+      }
+      for (; delay <= maxdelay; delay += lag)
+      {
+        const int start = std::max(0, -delay);
+        const int end = std::min(datasize, datasize - delay);
+        double sxy = 0;
+        for (int i = start; i < end; ++i)
+        {
+          sxy += x[i] * y[i + delay];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
@@ -293,15 +337,57 @@ namespace OpenSwath
       OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
 
       // rank the data
-      std::vector<unsigned int> int_data1 = computeRank(data1);
-      std::vector<unsigned int> int_data2 = computeRank(data2);
+      std::vector<std::pair<unsigned int, unsigned int> > workspace;
+      return rankedMutualInformation(computeRankedVector(data1), computeRankedVector(data2), workspace);
+    }
 
-      unsigned int* arr_int_data1 = &int_data1[0];
-      unsigned int* arr_int_data2 = &int_data2[0];
+    RankedVector computeRankedVector(const std::vector<double>& data)
+    {
+      RankedVector result;
+      result.ranks = computeRank(data);
+      result.counts.resize(data.size(), 0);
+      for (std::size_t i = 0; i < result.ranks.size(); ++i)
+      {
+        ++result.counts[result.ranks[i]];
+      }
+      return result;
+    }
 
-      double result = calcMutualInformation(arr_int_data1, arr_int_data2, int_data1.size());
+    double rankedMutualInformation(const RankedVector& data1, const RankedVector& data2,
+                                   std::vector<std::pair<unsigned int, unsigned int> >& workspace)
+    {
+      OPENSWATH_PRECONDITION(data1.ranks.size() != 0 && data1.ranks.size() == data2.ranks.size(), "Both data vectors need to have the same length");
+
+      // Collect the occupied cells of the joint histogram as (rank2, rank1)
+      // pairs. After sorting, equal cells are adjacent and appear in the same
+      // order in which MIToolbox traverses its dense joint probability table
+      // (rank2 * nr_states1 + rank1), so the sum below is carried out in the
+      // same order and gives the same result as calcMutualInformation.
+      const std::size_t n = data1.ranks.size();
+      workspace.resize(n);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        workspace[i] = std::make_pair(data2.ranks[i], data1.ranks[i]);
+      }
+      std::sort(workspace.begin(), workspace.end());
 
-      return result;
+      // I(X;Y) = \sum_x \sum_y p(x,y) * \log (p(x,y)/p(x)p(y))
+      const double length = n;
+      double mutual_information = 0.0;
+      for (std::size_t i = 0; i < n;)
+      {
+        std::size_t j = i + 1;
+        while (j < n && workspace[j] == workspace[i])
+        {
+          ++j;
+        }
+        const double p_joint = (j - i) / length;
+        const double p_first = data1.counts[workspace[i].second] / length;
+        const double p_second = data2.counts[workspace[i].first] / length;
+        mutual_information += p_joint * log(p_joint / p_first / p_second);
+        i = j;
+      }
+      return mutual_information / log(2.0); // in bits, like MIToolbox
     }
 
   } //end namespace Scoring
@@ -0,0 +1,13 @@
+from Types cimport *
+from ContinuousWaveletTransform cimport *
+
+cdef extern from "<OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformFFT.h>" namespace "OpenMS":
+    
+    cdef cppclass ContinuousWaveletTransformFFT(ContinuousWaveletTransform) :
+        # wrap-inherits:
+        #  ContinuousWaveletTransform
+        ContinuousWaveletTransformFFT() nogil except +
+        ContinuousWaveletTransformFFT(ContinuousWaveletTransformFFT) nogil except + #wrap-ignore
+
+        # TODO iterator
+        # TEMPLATE # void transform(InputPeakIterator begin_input, InputPeakIterator end_input, float resolution) nogil except +
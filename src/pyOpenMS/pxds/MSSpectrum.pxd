@@ -78,3 +78,7 @@ cdef extern from "<OpenMS/KERNEL/MSSpectrum.h>" namespace "OpenMS":
         void setIntegerDataArrays(libcpp_vector[IntegerDataArray] ida) nogil except +
         void setStringDataArrays(libcpp_vector[StringDataArray] sda) nogil except +
 
+        void setCopyOnWrite(bool cow) nogil except + #wrap-doc:Enables or disables sharing of peaks and data arrays between copies until one of them is modified
+        bool isCopyOnWrite() nogil except +
+        bool isShared() nogil except + #wrap-doc:Does this spectrum currently share its peaks or data arrays with another spectrum?
+
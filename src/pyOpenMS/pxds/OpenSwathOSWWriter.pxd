@@ -11,6 +11,7 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>" namespace "O
         OpenSwathOSWWriter(String output_filename, UInt64 run_id, String input_filename, bool ms1_scores, bool sonar, bool uis_scores) nogil except +
 
         bool isActive() nogil except +
+        void setShard(Size shard_index, Size nr_shards) nogil except +
         void writeHeader() nogil except +
         String prepareLine(LightCompound & compound, LightTransition * tr, FeatureMap & output, String id_) nogil except +
         void writeLines(libcpp_vector[ String ] to_osw_output) nogil except +
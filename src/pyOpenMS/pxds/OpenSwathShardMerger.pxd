@@ -0,0 +1,15 @@
+from Types cimport *
+from String cimport *
+from StringList cimport *
+
+cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathShardMerger.h>" namespace "OpenMS":
+
+    cdef cppclass OpenSwathShardMerger "OpenMS::OpenSwathShardMerger":
+        OpenSwathShardMerger() nogil except +
+        OpenSwathShardMerger(OpenSwathShardMerger) nogil except +
+
+# wrap static methods:
+cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathShardMerger.h>" namespace "OpenMS::OpenSwathShardMerger":
+
+        void mergeOSW(const StringList& shard_files, const String& output_file) nogil except + # wrap-attach:OpenSwathShardMerger
+        void mergeTSV(const StringList& shard_files, const String& output_file) nogil except + # wrap-attach:OpenSwathShardMerger
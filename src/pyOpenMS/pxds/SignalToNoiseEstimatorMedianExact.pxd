@@ -0,0 +1,17 @@
+from Types cimport *
+from SignalToNoiseEstimator cimport *
+from MSSpectrum cimport *
+from DefaultParamHandler cimport *
+from ProgressLogger cimport *
+
+cdef extern from "<OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianExact.h>" namespace "OpenMS":
+
+    cdef cppclass SignalToNoiseEstimatorMedianExact[Container]:
+        # wrap-instances:
+        #   SignalToNoiseEstimatorMedianExact := SignalToNoiseEstimatorMedianExact[ MSSpectrum ]
+
+        SignalToNoiseEstimatorMedianExact() nogil except +
+        SignalToNoiseEstimatorMedianExact(SignalToNoiseEstimatorMedianExact) nogil except +
+        void init(Container & c) nogil except +
+        double getSignalToNoise(Size index) nogil except +
+        double getSparseWindowPercent() nogil except +
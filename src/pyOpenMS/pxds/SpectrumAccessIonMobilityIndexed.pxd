@@ -0,0 +1,23 @@
+from Types cimport *
+from OpenSwathDataStructures cimport *
+from SpectrumAccessTransforming cimport *
+from SpectrumAccessOpenMS cimport *
+from SpectrumAccessOpenMSCached cimport *
+from SpectrumAccessOpenMSInMemory cimport *
+
+cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>" namespace "OpenMS":
+    
+    cdef cppclass SpectrumAccessIonMobilityIndexed(SpectrumAccessTransforming) :
+        # wrap-inherits:
+        #  SpectrumAccessTransforming
+
+        SpectrumAccessIonMobilityIndexed() nogil except + # wrap-pass-constructor
+        SpectrumAccessIonMobilityIndexed(SpectrumAccessIonMobilityIndexed) nogil except + #wrap-ignore
+
+        SpectrumAccessIonMobilityIndexed(shared_ptr[ SpectrumAccessOpenMS ], Size nr_im_bins, Size max_bytes) nogil except +
+        SpectrumAccessIonMobilityIndexed(shared_ptr[ SpectrumAccessOpenMSCached ], Size nr_im_bins, Size max_bytes) nogil except +
+        SpectrumAccessIonMobilityIndexed(shared_ptr[ SpectrumAccessOpenMSInMemory ], Size nr_im_bins, Size max_bytes) nogil except +
+
+        shared_ptr[OSSpectrum] getSpectrumByIdAndDrift(int id_, double drift_lower, double drift_upper) nogil except +
+        Size getNrIndexedSpectra() nogil except +
+        Size getNrIndexBuilds() nogil except +
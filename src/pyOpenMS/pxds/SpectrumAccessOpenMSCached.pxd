@@ -15,3 +15,5 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCach
         SpectrumAccessOpenMSCached(String filename) nogil except +
         SpectrumAccessOpenMSCached(SpectrumAccessOpenMSCached q) nogil except + # wrap-ignore
 
+        void setCacheSize(Size max_bytes) nogil except +
+
@@ -16,6 +16,8 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>"
         SpectrumAccessSqMass(SpectrumAccessSqMass)
         SpectrumAccessSqMass(MzMLSqliteHandler, libcpp_vector[int] indices) nogil except +
 
+        void setCacheSize(Size max_bytes) nogil except +
+
         # void getAllSpectra(libcpp_vector[ OpenSwath::SpectrumPtr ] & spectra, libcpp_vector< OpenSwath::SpectrumMeta > & spectra_meta) const;
         # SpectrumAccessSqMass(OpenMS::Internal::MzMLSqliteHandler handler);
         # SpectrumAccessSqMass(SpectrumAccessSqMass sp, std::vector<int> indices);
@@ -17,3 +17,12 @@ cdef extern from "<OpenMS/CONCEPT/UniqueIdGenerator.h>" namespace "OpenMS":
         # Returns the seed
         UInt64 getSeed() nogil except +
 
+        # Derives the seed of an independent stream of ids from the given seed
+        UInt64 deriveSeed(UInt64 seed, UInt64 stream) nogil except +
+
+
+        # Ties the generators used in parallel regions to the OpenMP thread number, making the ids reproducible
+        void setReproducibleParallelIds(bool) nogil except +
+
+        # Returns whether ids generated in parallel regions are reproducible
+        bool getReproducibleParallelIds() nogil except +
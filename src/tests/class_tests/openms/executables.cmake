@@ -11,6 +11,7 @@ set(concept_executables_list
   LogConfigHandler_test
   LogStream_test
   Multithreading_test
+  ParallelExceptionCollector_test
   UniqueIdGenerator_test
   UniqueIdIndexer_test
   UniqueIdInterface_test
@@ -264,11 +265,14 @@ set(format_executables_list
   # DATAACCESS
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
+  MSDataParallelTransformingConsumer_test
   MSDataChainingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
+  SpectrumAccessIonMobilityIndexed_test
   SpectrumAccessQuadMZTransforming_test
   SpectrumAccessSqMass_test
+  SpectrumLRUCache_test
   SiriusFragmentAnnotation_test
 )
 
@@ -303,6 +307,7 @@ set(math_executables_list
 )
 
 set(filtering_executables_list
+  AveragineIsotopePatternCache_test
   BernNorm_test
   ComplementFilter_test
   ComplementMarker_test
@@ -352,6 +357,7 @@ set(filtering_executables_list
   Scaler_test
   SignalToNoiseEstimatorMeanIterative_test
   SignalToNoiseEstimatorMedian_test
+  SignalToNoiseEstimatorMedianExact_test
   SignalToNoiseEstimatorMedianRapid_test
   SignalToNoiseEstimator_test
   SqrtMower_test
@@ -582,6 +588,7 @@ set(transformations_executables_list
   BaseModel_test
   BiGaussFitter1D_test
   BiGaussModel_test
+  ContinuousWaveletTransformFFT_test
   ContinuousWaveletTransformNumIntegration_test
   ContinuousWaveletTransform_test
   EGHTraceFitter_test
@@ -664,6 +671,7 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathHelper_test
     OpenSwathScoring_test
     OpenSwathScores_test
+    OpenSwathShardMerger_test
     PeakIntegrator_test
     PeakPickerMRM_test
     MRMTransitionGroupPicker_test
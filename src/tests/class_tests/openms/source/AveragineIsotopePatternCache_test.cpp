@@ -0,0 +1,172 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FILTERING/DATAREDUCTION/AveragineIsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+
+#include <thread>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AveragineIsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AveragineIsotopePatternCache* ptr = nullptr;
+AveragineIsotopePatternCache* null_ptr = nullptr;
+START_SECTION(AveragineIsotopePatternCache())
+{
+  ptr = new AveragineIsotopePatternCache();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getNrRequests(), 0)
+  TEST_EQUAL(ptr->getNrComputed(), 0)
+}
+END_SECTION
+
+START_SECTION(static AveragineIsotopePatternCache& getInstance())
+{
+  TEST_EQUAL(&AveragineIsotopePatternCache::getInstance() == &AveragineIsotopePatternCache::getInstance(), true)
+}
+END_SECTION
+
+START_SECTION(const IsotopeDistribution& estimateFromPeptideWeight(double average_weight, Size max_isotope))
+{
+  AveragineIsotopePatternCache cache;
+
+  // identical to the generator, for fragment and precursor sized masses
+  for (double weight = 150.0; weight < 5000.0; weight += 17.3)
+  {
+    for (Size max_isotope = 3; max_isotope < 6; ++max_isotope)
+    {
+      IsotopeDistribution expected = CoarseIsotopePatternGenerator(max_isotope).estimateFromPeptideWeight(weight);
+      const IsotopeDistribution& d = cache.estimateFromPeptideWeight(weight, max_isotope);
+      TEST_EQUAL(d.size(), expected.size())
+      TEST_EQUAL(d == expected, true)
+    }
+  }
+  TEST_EQUAL(cache.getNrComputed(), cache.size())
+
+  // weights within the same averagine sum formula share the pattern
+  Size computed = cache.getNrComputed();
+  const IsotopeDistribution& d1 = cache.estimateFromPeptideWeight(1000.0, 4);
+  const IsotopeDistribution& d2 = cache.estimateFromPeptideWeight(1000.1, 4);
+  TEST_EQUAL(&d1 == &d2, true)
+  TEST_EQUAL(cache.getNrComputed(), computed + 1)
+
+  // but not across different numbers of isotopes or distant weights
+  TEST_EQUAL(&d1 != &cache.estimateFromPeptideWeight(1000.0, 5), true)
+  TEST_EQUAL(&d1 != &cache.estimateFromPeptideWeight(1010.0, 4), true)
+  TEST_EQUAL(cache.getNrComputed(), computed + 3)
+}
+END_SECTION
+
+START_SECTION(Size getNrRequests() const)
+{
+  AveragineIsotopePatternCache cache;
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.estimateFromPeptideWeight(500.0, 4);
+  TEST_EQUAL(cache.getNrRequests(), 3)
+}
+END_SECTION
+
+START_SECTION(Size getNrComputed() const)
+{
+  AveragineIsotopePatternCache cache;
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.estimateFromPeptideWeight(800.0, 4);
+  TEST_EQUAL(cache.getNrComputed(), 2)
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+{
+  AveragineIsotopePatternCache cache;
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.estimateFromPeptideWeight(800.0, 4);
+  cache.estimateFromPeptideWeight(800.0, 4);
+  TEST_EQUAL(cache.size(), 2)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  AveragineIsotopePatternCache cache;
+  cache.estimateFromPeptideWeight(500.0, 4);
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+  TEST_EQUAL(cache.getNrRequests(), 0)
+  TEST_EQUAL(cache.getNrComputed(), 0)
+}
+END_SECTION
+
+START_SECTION([EXTRA] concurrent access)
+{
+  AveragineIsotopePatternCache cache;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&cache]()
+    {
+      for (int i = 0; i < 200; ++i)
+      {
+        cache.estimateFromPeptideWeight(300.0 + 10.0 * i, 4);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  TEST_EQUAL(cache.getNrRequests(), 800)
+  TEST_EQUAL(cache.size(), 200)
+  // a pattern requested by several threads at once may be computed more than once, but is only stored (and counted) once
+  TEST_EQUAL(cache.getNrComputed(), 200)
+  TEST_EQUAL(cache.estimateFromPeptideWeight(1300.0, 4) == CoarseIsotopePatternGenerator(4).estimateFromPeptideWeight(1300.0), true)
+}
+END_SECTION
+
+delete ptr;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
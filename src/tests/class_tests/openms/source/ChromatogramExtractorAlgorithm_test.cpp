@@ -38,6 +38,7 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -260,6 +261,206 @@ START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessP
 }
 END_SECTION
 
+START_SECTION([EXTRA] extractChromatograms with a large number of coordinates)
+{
+  typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
+
+  // 20 spectra with 2000 data points each between 400 and 480 m/z
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  for (int i = 0; i < 20; i++)
+  {
+    MSSpectrum s;
+    s.setRT(i);
+    FloatDataArray fda;
+    for (int k = 0; k < 2000; k++)
+    {
+      s.push_back(Peak1D(400.0 + k * 0.04 + (k * 7919 % 13) * 0.001, 100.0 + (k * 31 + i) % 97));
+      fda.push_back(0.6 + ((k * 17 + i) % 80) * 0.01);
+    }
+    fda.setName("Ion Mobility");
+    s.getFloatDataArrays().push_back(fda);
+    exp->addSpectrum(s);
+  }
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  // 10k coordinates, some of them restricted in RT and some without ion mobility
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  for (int k = 0; k < 10000; k++)
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 399.0 + k * 0.0081;
+    coord.ion_mobility = (k % 7 == 0) ? -1 : 0.6 + (k % 50) * 0.016;
+    coord.rt_start = (k % 3 == 0) ? 5 : 0;
+    coord.rt_end = (k % 3 == 0) ? 15 : -1;
+    coord.id = String(k);
+    coordinates.push_back(coord);
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+  const double im_windows[2] = {-1, 0.1};
+  for (Size w = 0; w < 2; ++w)
+  {
+    std::vector< OpenSwath::ChromatogramPtr > out_exp;
+    for (Size k = 0; k < coordinates.size(); k++)
+    {
+      out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+    extractor.extractChromatograms(expptr, out_exp, coordinates, 0.05, false, im_windows[w], "tophat");
+    TEST_EQUAL(out_exp[1]->getIntensityArray()->data.size(), 20)
+    TEST_EQUAL(out_exp[3]->getIntensityArray()->data.size(), 11)
+
+    // compare every 100th chromatogram against the single-value extraction
+    Size nr_differences = 0;
+    for (Size k = 0; k < coordinates.size(); k += 100)
+    {
+      Size p = 0;
+      for (Size i = 0; i < expptr->getNrSpectra(); ++i)
+      {
+        if (coordinates[k].rt_end > 0 && (i < coordinates[k].rt_start || i > coordinates[k].rt_end)) continue;
+        OpenSwath::SpectrumPtr sptr = expptr->getSpectrumById(i);
+        const std::vector<double>& mz = sptr->getMZArray()->data;
+        const std::vector<double>& intensity = sptr->getIntensityArray()->data;
+        const std::vector<double>& im = sptr->getDriftTimeArray()->data;
+        std::vector<double>::const_iterator mz_it = mz.begin(), int_it = intensity.begin(), im_it = im.begin();
+        double expected = 0;
+        if (im_windows[w] > 0 && coordinates[k].ion_mobility >= 0)
+        {
+          extractor.extract_value_tophat(mz.begin(), mz_it, mz.end(), int_it, im_it,
+            coordinates[k].mz, coordinates[k].ion_mobility, expected, 0.05, im_windows[w], false);
+        }
+        else
+        {
+          extractor.extract_value_tophat(mz.begin(), mz_it, mz.end(), int_it, coordinates[k].mz, expected, 0.05, false);
+        }
+        if (p >= out_exp[k]->getIntensityArray()->data.size() ||
+            out_exp[k]->getTimeArray()->data[p] != double(i) ||
+            out_exp[k]->getIntensityArray()->data[p] != expected)
+        {
+          ++nr_differences;
+        }
+        ++p;
+      }
+      if (p != out_exp[k]->getIntensityArray()->data.size()) ++nr_differences;
+    }
+    TEST_EQUAL(nr_differences, 0)
+  }
+}
+END_SECTION
+
+#if 0
+START_SECTION(( [STRESSTEST] extractChromatograms with a library of 200k transitions ))
+{
+  // Benchmark at the size of a large spectral library for one SWATH window:
+  // 200k coordinates with ion mobility, 100 spectra with 20k data points each.
+  // Takes a few seconds, switch on for profiling.
+  typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
+
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  for (int i = 0; i < 100; i++)
+  {
+    MSSpectrum s;
+    s.setRT(i);
+    FloatDataArray fda;
+    for (int k = 0; k < 20000; k++)
+    {
+      s.push_back(Peak1D(200.0 + k * 0.08 + (k * 7919 % 13) * 0.001, 100.0 + (k * 31 + i) % 97));
+      fda.push_back(0.6 + ((k * 17 + i) % 80) * 0.01);
+    }
+    fda.setName("Ion Mobility");
+    s.getFloatDataArrays().push_back(fda);
+    exp->addSpectrum(s);
+  }
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  // coordinates sorted by m/z, a third of them restricted to 20 s in RT
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  for (int k = 0; k < 200000; k++)
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 200.0 + k * 0.008;
+    coord.ion_mobility = 0.6 + (k * 13 % 50) * 0.016;
+    coord.rt_start = (k % 3 == 0) ? (k % 80) : 0;
+    coord.rt_end = (k % 3 == 0) ? (k % 80) + 20 : -1;
+    coord.id = String(k);
+    coordinates.push_back(coord);
+  }
+
+  ChromatogramExtractorAlgorithm extractor;
+  const double im_windows[2] = {-1, 0.06};
+  for (Size w = 0; w < 2; ++w)
+  {
+    std::vector< OpenSwath::ChromatogramPtr > out_exp;
+    for (Size k = 0; k < coordinates.size(); k++)
+    {
+      out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+    StopWatch sw;
+    sw.start();
+    extractor.extractChromatograms(expptr, out_exp, coordinates, 25, true, im_windows[w], "tophat");
+    sw.stop();
+
+    Size nr_points = 0;
+    for (Size k = 0; k < out_exp.size(); k++)
+    {
+      nr_points += out_exp[k]->getIntensityArray()->data.size();
+    }
+    // 133333 coordinates with 100 points, 66667 with 21 points
+    TEST_EQUAL(nr_points, 133333 * 100 + 66667 * 21)
+    STATUS("Extracted " << coordinates.size() << " chromatograms (ion mobility window "
+           << im_windows[w] << ") in " << sw.getClockTime() << " s");
+  }
+}
+END_SECTION
+#endif
+
+START_SECTION([EXTRA] extractChromatograms with coordinates with and without ion mobility)
+{
+  typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
+
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MSSpectrum s;
+  FloatDataArray fda;
+  for (int k = 0; k < 4; k++)
+  {
+    s.push_back(Peak1D(400.0 + k, 10.0 * (k + 1)));
+    fda.push_back(1.0 + k);
+  }
+  fda.setName("Ion Mobility");
+  s.getFloatDataArrays().push_back(fda);
+  exp->addSpectrum(s);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  // the first coordinate is extracted without ion mobility; this must not
+  // affect the ion mobility filter of the following ones
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  const double mz[3] = {401.0, 402.0, 403.0};
+  const double im[3] = {-1, 3.0, 4.0};
+  for (Size k = 0; k < 3; k++)
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = mz[k];
+    coord.ion_mobility = im[k];
+    coord.rt_start = 0;
+    coord.rt_end = -1;
+    coord.id = String(k);
+    coordinates.push_back(coord);
+  }
+
+  std::vector< OpenSwath::ChromatogramPtr > out_exp;
+  for (Size k = 0; k < coordinates.size(); k++)
+  {
+    out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  ChromatogramExtractorAlgorithm extractor;
+  extractor.extractChromatograms(expptr, out_exp, coordinates, 0.5, false, 0.2, "tophat");
+
+  ABORT_IF(out_exp[2]->getIntensityArray()->data.size() != 1)
+  TEST_REAL_SIMILAR(out_exp[0]->getIntensityArray()->data[0], 20.0)
+  TEST_REAL_SIMILAR(out_exp[1]->getIntensityArray()->data[0], 30.0)
+  TEST_REAL_SIMILAR(out_exp[2]->getIntensityArray()->data[0], 40.0)
+}
+END_SECTION
+
 ///////////////////////////////////////////////////////////////////////////
 /// Private functions
 ///////////////////////////////////////////////////////////////////////////
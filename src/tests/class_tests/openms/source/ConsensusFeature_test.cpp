@@ -240,6 +240,32 @@ START_SECTION((void insert(const HandleSetType &handle_set)))
   TEST_EQUAL(cf.begin()->getMapIndex(),10);
   TEST_EQUAL(cf.rbegin()->getMapIndex(),12);
 
+  // merge interleaved handles, order is kept
+  ConsensusFeature::HandleSetType hs2;
+  fh.setMapIndex(11);
+  fh.setUniqueId(5);
+  hs2.insert(fh);
+  fh.setMapIndex(13);
+  hs2.insert(fh);
+  cf.insert(hs2);
+  TEST_EQUAL(cf.size(),5);
+  ABORT_IF(cf.size() != 5);
+  ConsensusFeature::const_iterator it = cf.begin();
+  TEST_EQUAL(it->getMapIndex(),10);
+  ++it;
+  TEST_EQUAL(it->getMapIndex(),11);
+  TEST_EQUAL(it->getUniqueId(),5);
+  ++it;
+  TEST_EQUAL(it->getMapIndex(),11);
+  TEST_EQUAL(it->getUniqueId(),1001);
+  ++it;
+  TEST_EQUAL(it->getMapIndex(),12);
+  ++it;
+  TEST_EQUAL(it->getMapIndex(),13);
+
+  // duplicates are rejected without modifying the consensus feature
+  TEST_EXCEPTION(Exception::InvalidValue, cf.insert(hs2));
+  TEST_EQUAL(cf.size(),5);
 END_SECTION
 
 START_SECTION((void insert(UInt64 map_index, const Peak2D &element, UInt64 element_index)))
@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformFFT.h>
+///////////////////////////
+
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformNumIntegration.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ContinuousWaveletTransformFFT, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+ContinuousWaveletTransformFFT* ptr = nullptr;
+ContinuousWaveletTransformFFT* nullPointer = nullptr;
+START_SECTION((ContinuousWaveletTransformFFT()))
+  ptr = new ContinuousWaveletTransformFFT();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+END_SECTION
+
+START_SECTION((virtual ~ContinuousWaveletTransformFFT()))
+  delete ptr;
+END_SECTION
+
+START_SECTION((virtual void init(double scale, double spacing)))
+  ContinuousWaveletTransformFFT transformer;
+  float scale = 0.5f;
+  float spacing = 0.1f;
+
+  transformer.init(scale,spacing);
+  TEST_REAL_SIMILAR(transformer.getWavelet()[0],1.)
+  TEST_EQUAL(transformer.getWavelet().size(), 26)
+  TEST_REAL_SIMILAR(transformer.getScale(),scale)
+  TEST_REAL_SIMILAR(transformer.getSpacing(),spacing)
+END_SECTION
+
+START_SECTION((template <typename InputPeakIterator> void transform(InputPeakIterator begin_input, InputPeakIterator end_input, float resolution)))
+{
+  // a Gaussian peak, sampled every 0.01 Th
+  std::vector<Peak1D> raw_data;
+  for (Size i = 0; i <= 200; ++i)
+  {
+    double mz = 99.0 + i * 0.01;
+    raw_data.push_back(Peak1D(mz, 1000.0 * exp(-0.5 * (mz - 100.0) * (mz - 100.0) / 0.01)));
+  }
+
+  ContinuousWaveletTransformFFT transformer;
+  transformer.init(0.15, 0.001);
+  ContinuousWaveletTransformNumIntegration reference;
+  reference.init(0.15, 0.001);
+
+  transformer.transform(raw_data.begin(), raw_data.end(), 1.);
+  reference.transform(raw_data.begin(), raw_data.end(), 1.);
+  TEST_EQUAL(transformer.getSize(), 201)
+  TEST_EQUAL(transformer.getSignalLength(), 201)
+  TEST_EQUAL(transformer.getLeftPaddingIndex(), -1)
+  TEST_EQUAL(transformer.getRightPaddingIndex(), 201)
+  TEST_REAL_SIMILAR(transformer.getSignal()[17].getMZ(), raw_data[17].getMZ())
+
+  // both transforms approximate the same integral
+  TOLERANCE_RELATIVE(1.01)
+  for (Size i = 80; i <= 120; i += 5)
+  {
+    TEST_REAL_SIMILAR(transformer[i], reference[i])
+  }
+  TOLERANCE_RELATIVE(1.00001)
+
+  // the maximum of the transform is at the apex of the peak
+  Size max_index = 0;
+  for (Int i = 0; i < transformer.getSize(); ++i)
+  {
+    if (transformer[i] > transformer[max_index]) max_index = i;
+  }
+  TEST_EQUAL(max_index, 100)
+
+  // higher resolution: equally spaced positions
+  transformer.transform(raw_data.begin(), raw_data.end(), 2.);
+  TEST_EQUAL(transformer.getSize(), 402)
+  TEST_REAL_SIMILAR(transformer.getSignal()[0].getMZ(), 99.0)
+  TEST_REAL_SIMILAR(transformer.getSignal()[401].getMZ(), 101.0)
+
+  // empty input
+  transformer.transform(raw_data.begin(), raw_data.begin(), 1.);
+  TEST_EQUAL(transformer.getSize(), 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
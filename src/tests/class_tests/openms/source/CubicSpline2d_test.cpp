@@ -108,6 +108,36 @@ START_SECTION(CubicSpline2d(const std::map<double, double>& m))
   delete sp4;
 END_SECTION
 
+START_SECTION(CubicSpline2d())
+  CubicSpline2d* sp7 = new CubicSpline2d();
+  TEST_NOT_EQUAL(sp7, nullPointer)
+  delete sp7;
+END_SECTION
+
+START_SECTION(void init(const std::vector<double>& x, const std::vector<double>& y))
+  CubicSpline2d sp7;
+  sp7.init(mz, intensity);
+  for (Size i = 0; i < 27; ++i)
+  {
+    double xx = mz.front() + (double)i / 26 * (mz.back() - mz.front());
+    TEST_EQUAL(sp7.eval(xx), sp1.eval(xx))
+    TEST_EQUAL(sp7.derivatives(xx, 1), sp1.derivatives(xx, 1))
+  }
+  // re-initialization with fewer points
+  sp7.init(x, y);
+  for (Size i = 0; i < (n + 6); ++i)
+  {
+    double xx = x_min + (double)i / (n + 5) * (x_max - x_min);
+    TEST_EQUAL(sp7.eval(xx), sp5.eval(xx))
+    TEST_EQUAL(sp7.derivatives(xx, 2), sp5.derivatives(xx, 2))
+  }
+  // same checks as the constructor
+  std::vector<double> unsorted(x.rbegin(), x.rend());
+  TEST_EXCEPTION(Exception::IllegalArgument, sp7.init(unsorted, y))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp7.init(x, intensity))
+  TEST_EXCEPTION(Exception::IllegalArgument, sp7.init(std::vector<double>(1, 0.0), std::vector<double>(1, 0.0)))
+END_SECTION
+
 START_SECTION(double eval(double x))
   // near border of spline range
   TEST_REAL_SIMILAR(sp1.eval(486.785), 35173.1841778984);
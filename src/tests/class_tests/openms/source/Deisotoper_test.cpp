@@ -43,6 +43,7 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FILTERING/DATAREDUCTION/Deisotoper.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
 ///////////////////////////
 
@@ -155,6 +156,57 @@ START_SECTION(static void deisotopeAndSingleChargeMSSpectrum(MSSpectrum& in,
 }
 END_SECTION
 
+START_SECTION(static void deisotopeAndSingleCharge(PeakMap& exp,
+                                          double fragment_tolerance,
+                                          bool fragment_unit_ppm,
+                                          int min_charge = 1,
+                                          int max_charge = 3,
+                                          bool keep_only_deisotoped = false,
+                                          unsigned int min_isopeaks = 3,
+                                          unsigned int max_isopeaks = 10,
+                                          bool make_single_charged = true,
+                                          bool annotate_charge = false,
+                                          bool annotate_iso_peak_count = false,
+                                          bool use_decreasing_model = true,
+                                          unsigned int start_intensity_check = 2,
+                                          bool add_up_intensity = false))
+{
+   TheoreticalSpectrumGenerator spec_generator;
+   Param param = spec_generator.getParameters();
+   param.setValue("isotope_model", "coarse");
+   param.setValue("max_isotope", 3);
+   param.setValue("add_losses", "true");
+   spec_generator.setParameters(param);
+
+   PeakMap exp;
+   const StringList peptides = ListUtils::create<String>("PEPTIDE,ELVISLIVES,SAMPLER,DFPIANGER,ACDEFGHIKLMNPQRSTVWY");
+   for (Size i = 0; i != peptides.size(); ++i)
+   {
+     MSSpectrum spec;
+     spec_generator.getSpectrum(spec, AASequence::fromString(peptides[i]), 1, 3);
+     spec.sortByPosition();
+     exp.addSpectrum(spec);
+   }
+   exp.addSpectrum(MSSpectrum()); // empty spectra are skipped
+
+   // the batch version must give the same result as deisotoping each spectrum on its own
+   PeakMap batch = exp;
+   Deisotoper::deisotopeAndSingleCharge(batch, 10.0, true, 1, 3, false, 2, 10, true, true, true, true, 2, true);
+   TEST_EQUAL(batch.size(), exp.size());
+   for (Size i = 0; i != exp.size(); ++i)
+   {
+     MSSpectrum single = exp[i];
+     Deisotoper::deisotopeAndSingleCharge(single, 10.0, true, 1, 3, false, 2, 10, true, true, true, true, 2, true);
+     TEST_EQUAL(batch[i] == single, true);
+   }
+   TEST_EQUAL(batch[0].size() < exp[0].size(), true);
+   TEST_EQUAL(batch[batch.size() - 1].empty(), true);
+
+   // invalid settings
+   TEST_EXCEPTION(Exception::IllegalArgument, Deisotoper::deisotopeAndSingleCharge(batch, 10.0, true, 1, 3, false, 1, 10));
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -48,6 +48,14 @@ using namespace std;
 
 #define PI 3.14159265358979323846
 
+// gives access to the initial parameter estimation
+class EGHTraceFitterTest :
+  public EGHTraceFitter
+{
+public:
+  using EGHTraceFitter::setInitialParameters_;
+};
+
 // TODO: include a more asymmetric trace in the test
 
 START_TEST(EGHTraceFitter, "$Id$")
@@ -432,6 +440,30 @@ START_SECTION((double getFWHM() const))
 }
 END_SECTION
 
+START_SECTION((void setInitialParameters_(FeatureFinderAlgorithmPickedHelperStructs::MassTraces& traces)))
+{
+  // the RT bounds have to describe the initial model, not a previous fit
+  // (they are reported if the subsequent optimization fails):
+  EGHTraceFitterTest fitter;
+  fitter.fit(mts);
+  TEST_REAL_SIMILAR(fitter.getLowerRTBound(), expected_x0 - 2.5 * expected_sigma)
+
+  FeatureFinderAlgorithmPickedHelperStructs::MassTraces shifted = mts;
+  for (Size i = 0; i < shifted.size(); ++i)
+  {
+    for (Size j = 0; j < shifted[i].peaks.size(); ++j)
+    {
+      shifted[i].peaks[j].first -= 500.0;
+    }
+  }
+  fitter.setInitialParameters_(shifted);
+  TEST_REAL_SIMILAR(fitter.getCenter(), expected_x0 - 500.0)
+  TEST_REAL_SIMILAR(fitter.getSigma(), 1.56093849)
+  TEST_REAL_SIMILAR(fitter.getLowerRTBound(), fitter.getCenter() - 2.5 * fitter.getSigma())
+  TEST_REAL_SIMILAR(fitter.getUpperRTBound(), fitter.getCenter() + 2.5 * fitter.getSigma())
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
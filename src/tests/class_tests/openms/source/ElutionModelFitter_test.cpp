@@ -40,6 +40,10 @@
 #include <OpenMS/FORMAT/FeatureXMLFile.h>
 ///////////////////////////
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -104,6 +108,39 @@ START_SECTION((void fitElutionModels(FeatureMap& features)))
     TEST_EQUAL(it->metaValueExists("model_EGH_tau"), true);
     TEST_EQUAL(it->metaValueExists("model_EGH_sigma"), true);
   }
+
+  // features are fitted in parallel: the result must not depend on the number of threads
+  for (Size asymmetric = 0; asymmetric < 2; ++asymmetric)
+  {
+    params.setValue("asymmetric", asymmetric ? "true" : "false");
+    emf.setParameters(params);
+
+    FeatureMap features_single, features_multi;
+    FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ElutionModelFitter_test.featureXML"), features_single);
+    features_multi = features_single;
+#ifdef _OPENMP
+    int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    emf.fitElutionModels(features_single);
+#ifdef _OPENMP
+    omp_set_num_threads(std::max(4, max_threads));
+#endif
+    emf.fitElutionModels(features_multi);
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    TEST_EQUAL(features_multi.size(), features_single.size());
+    ABORT_IF(features_multi.size() != features_single.size());
+    for (Size i = 0; i < features_single.size(); ++i)
+    {
+      TEST_EQUAL(features_multi[i].getIntensity(), features_single[i].getIntensity());
+      TEST_EQUAL(features_multi[i].getMetaValue("model_area"), features_single[i].getMetaValue("model_area"));
+      TEST_EQUAL(features_multi[i].getMetaValue("model_status"), features_single[i].getMetaValue("model_status"));
+      TEST_EQUAL(features_multi[i].getMetaValue("model_width"), features_single[i].getMetaValue("model_width"));
+    }
+  }
 }
 END_SECTION
 
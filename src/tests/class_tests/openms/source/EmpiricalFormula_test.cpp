@@ -44,7 +44,9 @@
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
+#include <map>
 #include <sstream>
 
 using namespace OpenMS;
@@ -195,6 +197,23 @@ START_SECTION(EmpiricalFormula operator+(const EmpiricalFormula& rhs) const)
   TEST_EQUAL(ef2, "C4")
   ef2 = ef2 + EmpiricalFormula("C-4H2");
   TEST_EQUAL(ef2, "H2")
+
+  // zeroed elements of either operand are not carried over
+  EmpiricalFormula zero_s(0, db->getElement("S"));
+  ef2 = zero_s + EmpiricalFormula("H2O");
+  TEST_EQUAL(std::distance(ef2.begin(), ef2.end()), 2)
+  TEST_EQUAL(ef2.toString(), "H2O1")
+  TEST_EQUAL(ef2 == EmpiricalFormula("H2O"), true)
+  ef2 = EmpiricalFormula("H2O") + zero_s;
+  TEST_EQUAL(ef2.toString(), "H2O1")
+
+  // estimateFromWeightAndComp() stores S and P even if they round to 0
+  EmpiricalFormula estimate;
+  estimate.estimateFromWeightAndComp(1000.0, 4.9384, 7.7583, 1.3577, 1.4773, 0.0, 0.0);
+  ef2 = estimate + EmpiricalFormula("H2O");
+  TEST_EQUAL(ef2.toString().hasSubstring("S"), false)
+  TEST_EQUAL(ef2.toString().hasSubstring("P"), false)
+  TEST_EQUAL(std::distance(ef2.begin(), ef2.end()), 4)
 END_SECTION
 
 START_SECTION(EmpiricalFormula& operator-=(const EmpiricalFormula& rhs))
@@ -203,6 +222,9 @@ START_SECTION(EmpiricalFormula& operator-=(const EmpiricalFormula& rhs))
   TEST_EQUAL(*e_ptr == ef1, true)
   ef1 -= EmpiricalFormula("C4H-2");
   TEST_EQUAL(ef1, "H2");
+  ef1 -= EmpiricalFormula(0, db->getElement("P"));
+  TEST_EQUAL(std::distance(ef1.begin(), ef1.end()), 1)
+  TEST_EQUAL(ef1.toString(), "H2")
 END_SECTION
 
 START_SECTION(EmpiricalFormula operator-(const EmpiricalFormula& rhs) const)
@@ -611,6 +633,89 @@ START_SECTION(([EXTRA] Check correct charge semantics))
   TEST_EQUAL(ef11.getCharge(), 3)
 END_SECTION
 
+START_SECTION(([EXTRA] Arithmetic on formulas with many distinct elements))
+  // more distinct elements than are stored inline
+  EmpiricalFormula ef1("C10H20N2O5S1P1Na1K1Cl2Br1Se1");
+  EmpiricalFormula ef2("C2H-4Fe1Na-1Cl-2Mg3");
+  EmpiricalFormula sum = ef1 + ef2;
+  TEST_EQUAL(sum, EmpiricalFormula("C12H16N2O5S1P1K1Br1Se1Fe1Mg3"))
+  TEST_EQUAL(sum.hasElement(db->getElement("Na")), false)
+  TEST_EQUAL(sum.hasElement(db->getElement("Cl")), false)
+  TEST_REAL_SIMILAR(sum.getMonoWeight(), ef1.getMonoWeight() + ef2.getMonoWeight())
+  EmpiricalFormula diff = sum - ef2;
+  TEST_EQUAL(diff, ef1)
+  diff -= ef1;
+  TEST_EQUAL(diff.isEmpty(), true)
+  diff += ef2;
+  TEST_EQUAL(diff, ef2)
+  TEST_EQUAL(ef1 * 0, EmpiricalFormula())
+
+  // iteration order is independent of the order of construction
+  EmpiricalFormula ef3 = EmpiricalFormula("Se1Br1") + EmpiricalFormula("K1Na1Cl2") + EmpiricalFormula("C10H20N2O5S1P1");
+  TEST_EQUAL(ef3, ef1)
+  TEST_EQUAL(ef3 < ef1, false)
+  TEST_EQUAL(ef1 < ef3, false)
+  Size count(0);
+  for (EmpiricalFormula::ConstIterator it1 = ef1.begin(), it3 = ef3.begin(); it1 != ef1.end(); ++it1, ++it3)
+  {
+    TEST_EQUAL(it1->first, it3->first)
+    TEST_EQUAL(it1->second, it3->second)
+    ++count;
+  }
+  TEST_EQUAL(count, 11)
+END_SECTION
+
+START_SECTION(([EXTRA] Benchmark of formula arithmetic against a std::map))
+  // summing up residue formulas is the hot path of AASequence::getFormula() and friends;
+  // the reference sums the same formulas in a std::map, the layout used before the flat_map
+  vector<EmpiricalFormula> residues;
+  for (const char* s : {"C3H5N1O1", "C6H12N4O1", "C4H6N2O2", "C4H5N1O3", "C3H5N1O1S1", "C5H7N1O3", "C5H8N2O2", "C2H3N1O1",
+                        "C6H7N3O1", "C6H11N1O1", "C6H12N2O1", "C5H9N1O1S1", "C9H9N1O1", "C5H7N1O1", "C3H5N1O2", "C11H10N2O1"})
+  {
+    residues.emplace_back(s);
+  }
+  const EmpiricalFormula water("H2O1");
+  const Size rounds = 20000;
+
+  StopWatch sw;
+  sw.start();
+  EmpiricalFormula total;
+  for (Size r = 0; r < rounds; ++r)
+  {
+    EmpiricalFormula peptide = water;
+    for (const EmpiricalFormula& res : residues)
+    {
+      peptide += res;
+    }
+    total = total + peptide - water;
+  }
+  sw.stop();
+  const double t_flat = sw.getClockTime();
+
+  sw.reset();
+  sw.start();
+  map<const Element*, SignedSize> reference;
+  for (Size r = 0; r < rounds; ++r)
+  {
+    map<const Element*, SignedSize> peptide(water.begin(), water.end());
+    for (const EmpiricalFormula& res : residues)
+    {
+      for (const auto& e : res) peptide[e.first] += e.second;
+    }
+    for (const auto& e : peptide) reference[e.first] += e.second;
+    for (const auto& e : water) reference[e.first] -= e.second;
+  }
+  sw.stop();
+  const double t_map = sw.getClockTime();
+  STATUS("EmpiricalFormula: " << t_flat << " s, std::map: " << t_map << " s")
+
+  TEST_EQUAL(std::distance(total.begin(), total.end()), Int(reference.size()))
+  for (const auto& e : reference)
+  {
+    TEST_EQUAL(total.getNumberOf(e.first), e.second)
+  }
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
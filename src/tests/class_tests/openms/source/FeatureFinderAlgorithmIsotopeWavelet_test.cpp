@@ -36,6 +36,12 @@
 #include <OpenMS/test_config.h>
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmIsotopeWavelet.h>
+#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinder.h>
+#include <OpenMS/FORMAT/MzDataFile.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 START_TEST(FeatureFinderAlgorithmIsotopeWavelet, "$Id$")
 
@@ -58,7 +64,21 @@ START_SECTION(IsotopeWaveletTransform<PeakType>::TransSpectrum* prepareHRDataCud
 END_SECTION
 
 START_SECTION(MSSpectrum* createHRData(const UInt i))
-	NOT_TESTABLE
+{
+  // a scan without signal cannot be interpolated with zeros
+  PeakMap map;
+  map.resize(1);
+  map[0].setMSLevel(1);
+  map[0].setRT(100.0);
+  map[0].push_back(Peak1D(500.0, 0.0));
+  map[0].push_back(Peak1D(500.5, 0.0));
+  map.updateRanges();
+  FeatureMap features;
+  FeatureFinder ff;
+  FFASS algo;
+  algo.setData(map, features, ff);
+  TEST_EXCEPTION(Exception::IllegalArgument, algo.createHRData(0))
+}
 END_SECTION
 
 START_SECTION(virtual ~FeatureFinderAlgorithmIsotopeWavelet())
@@ -66,7 +86,54 @@ START_SECTION(virtual ~FeatureFinderAlgorithmIsotopeWavelet())
 END_SECTION
 
 START_SECTION(void run())
-	NOT_TESTABLE
+{
+  PeakMap input;
+  MzDataFile().load(OPENMS_GET_TEST_DATA_PATH("IsotopeWaveletTestData.mzData"), input);
+  input.updateRanges();
+
+  FeatureFinder ff;
+  Param param = ff.getParameters(FFASS::getProductName());
+
+  // scans are transformed in parallel: the result must not depend on the number of threads
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  FeatureMap features_single;
+  ff.run(FFASS::getProductName(), input, features_single, param, FeatureMap());
+
+#ifdef _OPENMP
+  omp_set_num_threads(std::max(4, max_threads));
+#endif
+  FeatureMap features_multi;
+  ff.run(FFASS::getProductName(), input, features_multi, param, FeatureMap());
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  TEST_EQUAL(features_single.size(), 9)
+  TEST_EQUAL(features_multi.size(), features_single.size())
+  ABORT_IF(features_multi.size() != features_single.size())
+  for (Size i = 0; i < features_single.size(); ++i)
+  {
+    TEST_EQUAL(features_multi[i].getRT(), features_single[i].getRT())
+    TEST_EQUAL(features_multi[i].getMZ(), features_single[i].getMZ())
+    TEST_EQUAL(features_multi[i].getIntensity(), features_single[i].getIntensity())
+    TEST_EQUAL(features_multi[i].getCharge(), features_single[i].getCharge())
+  }
+
+  // high-resolution mode reports scans it cannot interpolate instead of terminating the process
+  PeakMap empty_scans;
+  empty_scans.resize(1);
+  empty_scans[0].setMSLevel(1);
+  empty_scans[0].setRT(100.0);
+  empty_scans[0].push_back(Peak1D(500.0, 0.0));
+  empty_scans[0].push_back(Peak1D(500.5, 0.0));
+  empty_scans.updateRanges();
+  param.setValue("hr_data", "true");
+  FeatureMap features_hr;
+  TEST_EXCEPTION(Exception::IllegalArgument, ff.run(FFASS::getProductName(), empty_scans, features_hr, param, FeatureMap()))
+}
 END_SECTION
 
 START_SECTION((static FeatureFinderAlgorithm<PeakType>* create()))
@@ -197,6 +197,51 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] filterExperiment gives the same results as filtering spectra one by one)
+  PeakMap exp;
+  for (Size s = 0; s < 50; ++s)
+  {
+    MSSpectrum spectrum;
+    for (Size i = 0; i < 200; ++i)
+    {
+      Peak1D p;
+      p.setMZ(500.0 + 0.01 * i + 0.001 * (i % 3));
+      p.setIntensity(float((i * 7 + s * 13) % 23));
+      spectrum.push_back(p);
+    }
+    exp.addSpectrum(spectrum);
+  }
+
+  for (const String& use_ppm : ListUtils::create<String>("false,true"))
+  {
+    GaussFilter gauss;
+    Param param;
+    param.setValue("gaussian_width", 0.05);
+    param.setValue("use_ppm_tolerance", use_ppm);
+    gauss.setParameters(param);
+
+    PeakMap filtered = exp;
+    gauss.filterExperiment(filtered);
+    TEST_EQUAL(filtered.size(), exp.size())
+    for (Size s = 0; s < exp.size(); ++s)
+    {
+      MSSpectrum spectrum = exp[s];
+      gauss.filter(spectrum);
+      TEST_EQUAL(filtered[s] == spectrum, true)
+    }
+  }
+
+  // ppm tolerance cannot be used on chromatograms - fail before changing anything
+  GaussFilter gauss;
+  Param param;
+  param.setValue("use_ppm_tolerance", "true");
+  gauss.setParameters(param);
+  PeakMap with_chrom = exp;
+  with_chrom.addChromatogram(MSChromatogram());
+  TEST_EXCEPTION(Exception::IllegalArgument, gauss.filterExperiment(with_chrom))
+  TEST_EQUAL(with_chrom[0] == exp[0], true)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -528,6 +528,41 @@ START_SECTION((static bool isBetterScore(double first, double second, bool highe
 }
 END_SECTION
 
+START_SECTION((void reserve(Size queries, Size parents, Size molecules, Size matches, MoleculeType molecule_type = MoleculeType::PROTEIN)))
+{
+  IdentificationData reserved_data;
+  reserved_data.reserve(10, 10, 10, 10);
+  reserved_data.reserve(10, 10, 10, 10, IdentificationData::MoleculeType::RNA);
+  for (Size i = 0; i < 10; ++i)
+  {
+    IdentificationData::DataQuery query("spectrum_" + String(i));
+    IdentificationData::DataQueryRef reserved_query_ref =
+      reserved_data.registerDataQuery(query);
+    IdentificationData::ParentMolecule protein("protein_" + String(i % 3));
+    IdentificationData::ParentMoleculeRef reserved_protein_ref =
+      reserved_data.registerParentMolecule(protein);
+    IdentificationData::IdentifiedPeptide peptide(
+      AASequence::fromString(i % 2 ? "PEPTIDE" : "EDIT"));
+    peptide.parent_matches[reserved_protein_ref];
+    IdentificationData::IdentifiedPeptideRef reserved_peptide_ref =
+      reserved_data.registerIdentifiedPeptide(peptide);
+    IdentificationData::MoleculeQueryMatch match(reserved_peptide_ref,
+                                                 reserved_query_ref, 2);
+    reserved_data.registerMoleculeQueryMatch(match);
+  }
+  TEST_EQUAL(reserved_data.getDataQueries().size(), 10);
+  TEST_EQUAL(reserved_data.getParentMolecules().size(), 3);
+  TEST_EQUAL(reserved_data.getIdentifiedPeptides().size(), 2);
+  TEST_EQUAL(reserved_data.getMoleculeQueryMatches().size(), 10);
+
+  // references are still checked:
+  IdentificationData::MoleculeQueryMatch match(peptide_ref,
+    reserved_data.getDataQueries().begin(), 2);
+  TEST_EXCEPTION(Exception::IllegalArgument,
+                 reserved_data.registerMoleculeQueryMatch(match));
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
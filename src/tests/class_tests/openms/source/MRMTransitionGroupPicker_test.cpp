@@ -396,6 +396,34 @@ START_SECTION((template < typename SpectrumT, typename TransitionT > void pickTr
     TEST_REAL_SIMILAR(mrmfeature.getFeature("3").getMetaValue("peak_apex_position"), 7);
   }
 
+  { // transition group 1 -- exact median for the signal-to-noise estimation
+    MRMTransitionGroupType transition_group;
+    setup_transition_group(transition_group);
+
+    MRMTransitionGroupPicker trgroup_picker;
+    Param picker_param = trgroup_picker.getDefaults();
+    picker_param.setValue("PeakPickerMRM:method", "corrected");
+    picker_param.setValue("PeakPickerMRM:peak_width", -1.0);
+    trgroup_picker.setParameters(picker_param);
+    trgroup_picker.pickTransitionGroup(transition_group);
+
+    TEST_EQUAL(transition_group.getFeatures().size(), 1)
+    TEST_REAL_SIMILAR(transition_group.getFeatures()[0].getMetaValue("leftWidth"), 1481.84)
+    TEST_REAL_SIMILAR(transition_group.getFeatures()[0].getMetaValue("rightWidth"), 1504.0)
+
+    // the histogram median of the 18 points is far above the baseline, the
+    // exact median allows extending the peak further to the left
+    MRMTransitionGroupType transition_group_exact;
+    setup_transition_group(transition_group_exact);
+    picker_param.setValue("PeakPickerMRM:sn_estimator", "exact");
+    trgroup_picker.setParameters(picker_param);
+    trgroup_picker.pickTransitionGroup(transition_group_exact);
+
+    TEST_EQUAL(transition_group_exact.getFeatures().size(), 1)
+    TEST_REAL_SIMILAR(transition_group_exact.getFeatures()[0].getMetaValue("leftWidth"), 1479.08)
+    TEST_REAL_SIMILAR(transition_group_exact.getFeatures()[0].getMetaValue("rightWidth"), 1504.0)
+  }
+
   { // transition group 1 -- only quantifying
     MRMTransitionGroupPicker trgroup_picker;
     Param picker_param = trgroup_picker.getDefaults();
@@ -198,6 +198,18 @@ START_SECTION (  void addChromatogram(SpectrumType &chromatogram, String key))
 }
 END_SECTION
 
+START_SECTION (  void addChromatogram(SpectrumType &&chromatogram, String key)) 
+{
+  MRMTransitionGroupType mrmtrgroup;
+  MSChromatogram chrom = chrom1;
+  chrom.setMetaValue("some_value", 2);
+  mrmtrgroup.addChromatogram(std::move(chrom), "dummy1");
+  TEST_EQUAL(mrmtrgroup.hasChromatogram("dummy1"), true)
+  TEST_EQUAL(mrmtrgroup.getChromatogram("dummy1").getMetaValue("some_value"), 2)
+  TEST_EXCEPTION(Exception::InvalidValue, mrmtrgroup.addChromatogram(MSChromatogram(), "dummy1"))
+}
+END_SECTION
+
 START_SECTION (  SpectrumType& getChromatogram(String key))
 {
   MRMTransitionGroupType mrmtrgroup;
@@ -223,6 +235,18 @@ START_SECTION (  void addPrecusorChromatogram(SpectrumType &chromatogram, String
 }
 END_SECTION
 
+START_SECTION (  void addPrecursorChromatogram(SpectrumType &&chromatogram, String key)) 
+{
+  MRMTransitionGroupType mrmtrgroup;
+  MSChromatogram chrom = chrom1;
+  chrom.setMetaValue("some_value", 2);
+  mrmtrgroup.addPrecursorChromatogram(std::move(chrom), "dummy1");
+  TEST_EQUAL(mrmtrgroup.hasPrecursorChromatogram("dummy1"), true)
+  TEST_EQUAL(mrmtrgroup.getPrecursorChromatogram("dummy1").getMetaValue("some_value"), 2)
+  TEST_EXCEPTION(Exception::InvalidValue, mrmtrgroup.addPrecursorChromatogram(MSChromatogram(), "dummy1"))
+}
+END_SECTION
+
 START_SECTION (  SpectrumType& getPrecursorChromatogram(String key))
 {
   MRMTransitionGroupType mrmtrgroup;
@@ -0,0 +1,183 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelTransformingConsumer* parallel_consumer_ptr = nullptr;
+MSDataParallelTransformingConsumer* parallel_consumer_nullPointer = nullptr;
+
+PeakMap expc;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), expc);
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0)))
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(parallel_consumer_ptr, parallel_consumer_nullPointer)
+  delete parallel_consumer_ptr;
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // remaining data is passed on
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 10);
+    parallel_consumer.consumeSpectrum(expc.getSpectrum(0));
+    TEST_EQUAL(storing_consumer.getData().size(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType & s)))
+{
+  // many more spectra than the batch size, processed in parallel
+  std::vector<MSSpectrum> spectra;
+  for (Size i = 0; i < 100; ++i)
+  {
+    MSSpectrum s = expc.getSpectrum(i % expc.size());
+    s.setRT(i);
+    spectra.push_back(s);
+  }
+
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 7);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s) { s.sortByIntensity(); s.setName("processed"); });
+  for (MSSpectrum& s : spectra)
+  {
+    parallel_consumer.consumeSpectrum(s);
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 98) // 14 complete batches
+  TEST_EQUAL(spectra[0].getName(), "") // input is left unchanged
+  parallel_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), 100)
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    // order is preserved
+    TEST_REAL_SIMILAR(result[i].getRT(), i)
+    TEST_EQUAL(result[i].getName(), "processed")
+    TEST_EQUAL(result[i].size(), spectra[i].size())
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType & c)))
+{
+  TEST_EQUAL(expc.getNrChromatograms() > 0, true)
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 3);
+  parallel_consumer.setChromatogramProcessingFunc([](MSChromatogram& c) { c.setName("processed"); });
+
+  // pending spectra are passed on before the first chromatogram
+  parallel_consumer.consumeSpectrum(expc.getSpectrum(0));
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSChromatogram c = expc.getChromatogram(0);
+    c.setNativeID(String(i));
+    parallel_consumer.consumeChromatogram(c);
+  }
+  parallel_consumer.flush();
+
+  const PeakMap& result = storing_consumer.getData();
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result.getNrChromatograms(), 5)
+  for (Size i = 0; i < result.getNrChromatograms(); ++i)
+  {
+    TEST_EQUAL(result.getChromatograms()[i].getNativeID(), String(i))
+    TEST_EQUAL(result.getChromatograms()[i].getName(), "processed")
+  }
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // exceptions of the processing function are passed on
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 100);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+  {
+    if (s.getRT() > 5) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "RT too large", String(s.getRT()));
+  });
+  for (Size i = 0; i < 10; ++i)
+  {
+    MSSpectrum s;
+    s.setRT(i);
+    parallel_consumer.consumeSpectrum(s);
+  }
+  TEST_EXCEPTION(Exception::InvalidValue, parallel_consumer.flush())
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+  NOT_TESTABLE // passed on to the next consumer
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& es)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+  ExperimentalSettings s;
+  s.setComment("test settings");
+  bool called = false;
+  parallel_consumer.setExperimentalSettingsFunc([&called](const ExperimentalSettings&) { called = true; });
+  parallel_consumer.setExperimentalSettings(s);
+  TEST_EQUAL(called, true)
+  TEST_EQUAL(storing_consumer.getData().getComment(), "test settings")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
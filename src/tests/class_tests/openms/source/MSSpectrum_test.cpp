@@ -1630,6 +1630,113 @@ START_SECTION(inline IntegerDataArray& getIntegerDataArrayByName(String name))
 }
 END_SECTION
 
+START_SECTION(void setCopyOnWrite(bool cow))
+{
+  MSSpectrum spec;
+  spec.push_back(Peak1D(100.0, 1.0f));
+  spec.push_back(Peak1D(200.0, 2.0f));
+  spec.getFloatDataArrays().resize(1);
+  spec.getFloatDataArrays()[0].push_back(0.5f);
+  spec.getFloatDataArrays()[0].push_back(1.5f);
+  TEST_EQUAL(spec.isCopyOnWrite(), false);
+  spec.setCopyOnWrite(true);
+  TEST_EQUAL(spec.isCopyOnWrite(), true);
+  TEST_EQUAL(spec.size(), 2);
+  TEST_EQUAL(spec.getFloatDataArrays().size(), 1);
+
+  // copies share the data:
+  MSSpectrum copy(spec);
+  TEST_EQUAL(copy.isCopyOnWrite(), true);
+  TEST_EQUAL(spec.isShared(), true);
+  TEST_EQUAL(copy.isShared(), true);
+  TEST_EQUAL(&(*static_cast<const MSSpectrum&>(copy).begin()),
+             &(*static_cast<const MSSpectrum&>(spec).begin()));
+  TEST_EQUAL(copy == spec, true);
+
+  // changing meta data doesn't copy peaks:
+  copy.setRT(10.0);
+  TEST_EQUAL(copy.isShared(), true);
+
+  // modification of the copy doesn't affect the original:
+  copy[0].setIntensity(10.0f);
+  TEST_REAL_SIMILAR(copy[0].getIntensity(), 10.0);
+  TEST_REAL_SIMILAR(static_cast<const MSSpectrum&>(spec)[0].getIntensity(), 1.0);
+  copy.push_back(Peak1D(300.0, 3.0f));
+  TEST_EQUAL(copy.size(), 3);
+  TEST_EQUAL(spec.size(), 2);
+  copy.getFloatDataArrays()[0].push_back(2.5f);
+  TEST_EQUAL(copy.getFloatDataArrays()[0].size(), 3);
+  TEST_EQUAL(spec.getFloatDataArrays()[0].size(), 2);
+  TEST_EQUAL(copy.isShared(), false);
+  TEST_EQUAL(spec.isShared(), false);
+
+  // positions passed to "erase"/"insert" remain valid:
+  MSSpectrum copy2 = spec;
+  MSSpectrum::ConstIterator pos = static_cast<const MSSpectrum&>(copy2).begin() + 1;
+  copy2.erase(pos);
+  TEST_EQUAL(copy2.size(), 1);
+  TEST_REAL_SIMILAR(copy2[0].getMZ(), 100.0);
+  TEST_EQUAL(spec.size(), 2);
+
+  // sorting and selection work on shared data:
+  MSSpectrum copy3 = copy;
+  copy3.sortByIntensity(true);
+  TEST_REAL_SIMILAR(copy3[0].getMZ(), 100.0);
+  TEST_REAL_SIMILAR(copy3.getFloatDataArrays()[0][0], 0.5);
+  TEST_REAL_SIMILAR(copy[0].getMZ(), 100.0);
+  TEST_REAL_SIMILAR(copy.getFloatDataArrays()[0][2], 2.5);
+
+  // shared data arrays are replaced, not modified:
+  copy.getFloatDataArrays()[0].setName("fda");
+  copy.getIntegerDataArrays().resize(1);
+  copy.getIntegerDataArrays()[0].assign({1, 2, 3});
+  const MSSpectrum& const_copy = copy;
+  MSSpectrum copy6 = copy;
+  const float* fda = const_copy.getFloatDataArrays()[0].data();
+  copy6.sortByIntensity(true);
+  TEST_EQUAL(copy6.getFloatDataArrays()[0].getName(), "fda");
+  TEST_REAL_SIMILAR(copy6.getFloatDataArrays()[0][1], 2.5);
+  TEST_EQUAL(copy6.getIntegerDataArrays()[0][1], 3);
+  TEST_EQUAL(const_copy.getFloatDataArrays()[0].data(), fda);
+  TEST_REAL_SIMILAR(const_copy.getFloatDataArrays()[0][1], 1.5);
+  TEST_EQUAL(const_copy.getIntegerDataArrays()[0][1], 2);
+  copy6 = copy;
+  copy6.setFloatDataArrays(MSSpectrum::FloatDataArrays(2));
+  TEST_EQUAL(copy6.getFloatDataArrays().size(), 2);
+  TEST_EQUAL(copy6.getIntegerDataArrays()[0].size(), 3);
+  TEST_EQUAL(const_copy.getFloatDataArrays().size(), 1);
+  TEST_EQUAL(const_copy.getFloatDataArrays()[0].data(), fda);
+
+  // disabling takes over (or copies) the data:
+  copy.setCopyOnWrite(false);
+  TEST_EQUAL(copy.isCopyOnWrite(), false);
+  TEST_EQUAL(copy.size(), 3);
+  TEST_EQUAL(copy.getFloatDataArrays()[0].size(), 3);
+  MSSpectrum copy4 = copy;
+  TEST_EQUAL(copy4.isShared(), false);
+
+  // clearing a shared spectrum:
+  MSSpectrum copy5 = spec;
+  copy5.clear(true);
+  TEST_EQUAL(copy5.empty(), true);
+  TEST_EQUAL(copy5.getFloatDataArrays().empty(), true);
+  TEST_EQUAL(spec.size(), 2);
+  TEST_EQUAL(spec.getFloatDataArrays().size(), 1);
+}
+END_SECTION
+
+START_SECTION(bool isCopyOnWrite() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(bool isShared() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -40,6 +40,12 @@
 #include <OpenMS/FILTERING/DATAREDUCTION/MassTraceDetection.h>
 ///////////////////////////
 
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -198,6 +204,84 @@ std::vector<MassTrace> found_mtraces;
 
 PeakMap::ConstAreaIterator mt_end = input.areaEndConst();
 
+START_SECTION([EXTRA] parallel extension yields the sequential result)
+{
+  // many co-eluting traces and noise peaks, so that the m/z axis is split into stripes
+  PeakMap synthetic;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<std::vector<double> > compounds; // m/z, RT, width, height
+  for (Size i = 0; i < 3000; ++i)
+  {
+    compounds.push_back({100.0 + 900.0 * uniform(rng), 200.0 * uniform(rng), 2.0 + 8.0 * uniform(rng), 100.0 + 1e5 * uniform(rng)});
+  }
+  for (Size i = 0; i < 300; ++i)
+  {
+    // close neighbours in m/z which compete for peaks
+    std::vector<double> c = compounds[i];
+    c[0] += (uniform(rng) - 0.5) * c[0] * 4e-5;
+    c[1] += 10.0 * (uniform(rng) - 0.5);
+    compounds.push_back(c);
+  }
+  for (Size scan = 0; scan < 200; ++scan)
+  {
+    MSSpectrum spec;
+    spec.setRT(scan);
+    spec.setMSLevel(1);
+    for (const auto& c : compounds)
+    {
+      double d = (scan - c[1]) / c[2];
+      if (std::fabs(d) > 4.0 || uniform(rng) < 0.1) continue;
+      spec.push_back(Peak1D(c[0] * (1.0 + (uniform(rng) - 0.5) * 4e-6), c[3] * std::exp(-0.5 * d * d)));
+    }
+    for (Size k = 0; k < 300; ++k)
+    {
+      spec.push_back(Peak1D(100.0 + 900.0 * uniform(rng), 60.0 * uniform(rng)));
+    }
+    spec.sortByPosition();
+    synthetic.addSpectrum(spec);
+  }
+
+  auto same_traces = [](const std::vector<MassTrace>& a, const std::vector<MassTrace>& b)
+  {
+    if (a.size() != b.size()) return false;
+    for (Size i = 0; i < a.size(); ++i)
+    {
+      if (a[i].getLabel() != b[i].getLabel() || a[i].getSize() != b[i].getSize() ||
+          a[i].getCentroidMZ() != b[i].getCentroidMZ() || a[i].getCentroidRT() != b[i].getCentroidRT())
+      {
+        return false;
+      }
+      for (Size j = 0; j < a[i].getSize(); ++j)
+      {
+        if (!(a[i][j] == b[i][j])) return false;
+      }
+    }
+    return true;
+  };
+
+  MassTraceDetection mtd;
+  std::vector<MassTrace> sequential, parallel, limited;
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  mtd.run(synthetic, sequential);
+#ifdef _OPENMP
+  omp_set_num_threads(std::max(4, max_threads));
+#endif
+  mtd.run(synthetic, parallel);
+  mtd.run(synthetic, limited, 100);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+  TEST_NOT_EQUAL(sequential.size(), 0)
+  TEST_EQUAL(same_traces(sequential, parallel), true)
+  TEST_EQUAL(limited.size(), 100)
+  TEST_EQUAL(same_traces(std::vector<MassTrace>(sequential.begin(), sequential.begin() + 100), limited), true)
+}
+END_SECTION
+
 START_SECTION((void run(PeakMap::ConstAreaIterator &begin, PeakMap::ConstAreaIterator &end, std::vector< MassTrace > &found_masstraces)))
 {
 
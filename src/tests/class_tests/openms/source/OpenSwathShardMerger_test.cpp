@@ -0,0 +1,278 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathShardMerger.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <sqlite3.h>
+
+#include <fstream>
+#include <tuple>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  // a minimal OSW file with a single run and the given peak groups (id, precursor, RT), shard "index of count" (if count > 0)
+  void writeShard(const String& filename, Int64 run_id, const String& run_file, const vector<tuple<Int64, Int64, double> >& features,
+                  Size index, Size count)
+  {
+    SqliteConnector conn(filename);
+    conn.executeStatement("CREATE TABLE PRECURSOR(ID INT PRIMARY KEY NOT NULL); "
+                          "CREATE TABLE RUN(ID INT PRIMARY KEY NOT NULL, FILENAME TEXT NOT NULL); "
+                          "CREATE TABLE FEATURE(ID INT PRIMARY KEY NOT NULL, RUN_ID INT NOT NULL, PRECURSOR_ID INT NOT NULL, EXP_RT REAL NOT NULL); "
+                          "CREATE TABLE FEATURE_TRANSITION(FEATURE_ID INT NOT NULL, TRANSITION_ID INT NOT NULL, AREA_INTENSITY REAL NOT NULL); "
+                          "INSERT INTO PRECURSOR VALUES (1), (2), (3); "
+                          "INSERT INTO RUN VALUES (" + String(run_id) + ", '" + run_file + "');");
+    if (count > 0)
+    {
+      conn.executeStatement("CREATE TABLE SHARD(SHARD_INDEX INT NOT NULL, SHARD_COUNT INT NOT NULL); "
+                            "INSERT INTO SHARD VALUES (" + String(index) + ", " + String(count) + ");");
+    }
+    for (const auto& f : features)
+    {
+      String id(get<0>(f));
+      conn.executeStatement("INSERT INTO FEATURE VALUES (" + id + ", " + String(run_id) + ", " + String(get<1>(f)) + ", " + String(get<2>(f)) + "); "
+                            "INSERT INTO FEATURE_TRANSITION VALUES (" + id + ", 2, 1.0), (" + id + ", 1, 1.0);");
+    }
+  }
+
+  // all rows of a table, one string per row
+  vector<String> readTable(const String& filename, const String& statement)
+  {
+    SqliteConnector conn(filename, SqliteConnector::SqlOpenMode::READONLY);
+    sqlite3_stmt* stmt;
+    conn.prepareStatement(&stmt, statement);
+    vector<String> rows;
+    while (Internal::SqliteHelper::nextRow(stmt) == Internal::SqliteHelper::SqlState::SQL_ROW)
+    {
+      String row;
+      for (int i = 0; i < sqlite3_column_count(stmt); ++i)
+      {
+        String value;
+        Internal::SqliteHelper::extractValue<String>(&value, stmt, i);
+        row += (i > 0 ? "|" : "") + value;
+      }
+      rows.push_back(row);
+    }
+    sqlite3_finalize(stmt);
+    return rows;
+  }
+}
+
+START_TEST(OpenSwathShardMerger, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION(static void mergeOSW(const StringList& shard_files, const String& output_file))
+{
+  String shard0, shard1, shard2, other, out;
+  NEW_TMP_FILE(shard0);
+  NEW_TMP_FILE(shard1);
+  NEW_TMP_FILE(shard2);
+  NEW_TMP_FILE(other);
+  NEW_TMP_FILE(out);
+  writeShard(shard0, 111, "run.mzML", {make_tuple(5, 3, 20.0), make_tuple(9, 1, 10.0)}, 0, 3);
+  writeShard(shard1, 222, "run.mzML", {make_tuple(7, 1, 5.0), make_tuple(3, 2, 1.0)}, 1, 3);
+  writeShard(shard2, 333, "run.mzML", {}, 2, 3);
+  writeShard(other, 444, "other.mzML", {}, 2, 3);
+
+  // the order of the shards does not matter, the run is taken from the first shard
+  OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard1 + "," + shard0 + "," + shard2), out);
+
+  vector<String> run = readTable(out, "SELECT ID, FILENAME FROM RUN;");
+  TEST_EQUAL(run.size(), 1)
+  TEST_EQUAL(run[0], "222|run.mzML")
+  // the merged output is not a shard anymore
+  TEST_EQUAL(readTable(out, "SELECT name FROM sqlite_master WHERE name = 'SHARD';").size(), 0)
+
+  vector<String> precursors = readTable(out, "SELECT ID FROM PRECURSOR;");
+  TEST_EQUAL(precursors.size(), 3)
+
+  vector<String> features = readTable(out, "SELECT ID, RUN_ID, PRECURSOR_ID FROM FEATURE;");
+  TEST_EQUAL(features.size(), 4)
+  TEST_EQUAL(features[0], "7|222|1")
+  TEST_EQUAL(features[1], "9|222|1")
+  TEST_EQUAL(features[2], "3|222|2")
+  TEST_EQUAL(features[3], "5|222|3")
+
+  vector<String> transitions = readTable(out, "SELECT FEATURE_ID, TRANSITION_ID FROM FEATURE_TRANSITION;");
+  TEST_EQUAL(transitions.size(), 8)
+  TEST_EQUAL(transitions[0], "3|1")
+  TEST_EQUAL(transitions[1], "3|2")
+  TEST_EQUAL(transitions[7], "9|2")
+
+  // shards of different runs cannot be merged, the existing output is not touched
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1 + "," + other), out))
+  TEST_EQUAL(readTable(out, "SELECT ID FROM FEATURE;").size(), 4)
+
+  // no partial output is left behind if merging fails (a shard given twice)
+  String failed;
+  NEW_TMP_FILE(failed);
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1 + "," + shard1), failed))
+  TEST_EQUAL(File::exists(failed), false)
+
+  // all shards are required, each exactly once
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1), failed))
+  String shard3, shard1_of_4;
+  NEW_TMP_FILE(shard3);
+  NEW_TMP_FILE(shard1_of_4);
+  writeShard(shard3, 555, "run.mzML", {}, 3, 4);
+  writeShard(shard1_of_4, 666, "run.mzML", {}, 1, 4);
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1 + "," + shard2 + "," + shard3), failed))
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1_of_4 + "," + shard2), failed))
+  TEST_EQUAL(File::exists(failed), false)
+
+  // files without shard information: a single one is accepted, several are not
+  String single, single2;
+  NEW_TMP_FILE(single);
+  NEW_TMP_FILE(single2);
+  writeShard(single, 777, "run.mzML", {make_tuple(7, 1, 5.0)}, 0, 0);
+  writeShard(single2, 888, "run.mzML", {}, 0, 0);
+  OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(single), failed);
+  TEST_EQUAL(readTable(failed, "SELECT ID FROM FEATURE;").size(), 1)
+  File::remove(failed);
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(single + "," + single2), failed))
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(single + "," + shard1), failed))
+  TEST_EQUAL(File::exists(failed), false)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(StringList(), out))
+
+  // the output must not overwrite a shard
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1), shard0))
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1), shard1))
+  TEST_EQUAL(readTable(shard0, "SELECT ID FROM FEATURE;").size(), 2)
+
+  TEST_EXCEPTION(Exception::FileNotFound, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + ",does_not_exist.osw"), out))
+  TEST_EXCEPTION(Exception::UnableToCreateFile, OpenSwathShardMerger::mergeOSW(ListUtils::create<String>(shard0 + "," + shard1 + "," + shard2), File::getTempDirectory() + "/does_not_exist/out.osw"))
+}
+END_SECTION
+
+START_SECTION(static void mergeTSV(const StringList& shard_files, const String& output_file))
+{
+  String shard0, shard1, other, out;
+  NEW_TMP_FILE(shard0);
+  NEW_TMP_FILE(shard1);
+  NEW_TMP_FILE(other);
+  NEW_TMP_FILE(out);
+  {
+    ofstream ofs(shard0.c_str());
+    ofs << "# shard 0 of 2\n"
+        << "transition_group_id\trun_id\tRT\tid\n"
+        << "PEPB_2\t0\t100.5\t11\n"
+        << "PEPA_2\t0\t300\t12\n";
+  }
+  {
+    ofstream ofs(shard1.c_str());
+    ofs << "# shard 1 of 2\n"
+        << "transition_group_id\trun_id\tRT\tid\n"
+        << "PEPA_2\t0\t20\t13\n"
+        << "PEPC_3\t0\t7\t14\n";
+  }
+  {
+    ofstream ofs(other.c_str());
+    ofs << "# shard 1 of 2\n"
+        << "transition_group_id\tRT\n";
+  }
+  String run0, run1;
+  NEW_TMP_FILE(run0);
+  NEW_TMP_FILE(run1);
+  {
+    ofstream ofs(run0.c_str());
+    ofs << "# shard 0 of 2\n"
+        << "transition_group_id\tfilename\tRT\n"
+        << "PEPA_2\trun.mzML\t20\n";
+  }
+  {
+    ofstream ofs(run1.c_str());
+    ofs << "# shard 1 of 2\n"
+        << "transition_group_id\tfilename\tRT\n"
+        << "PEPB_2\trun.mzML\t30\n"
+        << "PEPC_2\tother.mzML\t40\n";
+  }
+
+  OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard1 + "," + shard0), out);
+
+  ifstream ifs(out.c_str());
+  vector<String> lines;
+  string line;
+  while (getline(ifs, line)) lines.push_back(line);
+  TEST_EQUAL(lines.size(), 5)
+  TEST_EQUAL(lines[0], "transition_group_id\trun_id\tRT\tid")
+  TEST_EQUAL(lines[1], "PEPA_2\t0\t20\t13")
+  TEST_EQUAL(lines[2], "PEPA_2\t0\t300\t12")
+  TEST_EQUAL(lines[3], "PEPB_2\t0\t100.5\t11")
+  TEST_EQUAL(lines[4], "PEPC_3\t0\t7\t14")
+
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard0 + "," + other), out))
+  // shards of different runs cannot be merged
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(run0 + "," + run1), out))
+  TEST_EXCEPTION(Exception::FileNotFound, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard0 + ",does_not_exist.tsv"), out))
+
+  // all shards are required, each exactly once
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard0), out))
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard1 + "," + shard1), out))
+  String invalid, single;
+  NEW_TMP_FILE(invalid);
+  NEW_TMP_FILE(single);
+  {
+    ofstream ofs(invalid.c_str());
+    ofs << "# shard 2 of 2\n"
+        << "transition_group_id\trun_id\tRT\tid\n";
+  }
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(shard0 + "," + invalid), out))
+
+  // a single file without shard information is accepted on its own, but not together with shards
+  {
+    ofstream ofs(single.c_str());
+    ofs << "transition_group_id\trun_id\tRT\tid\n"
+        << "PEPB_2\t0\t100.5\t11\n";
+  }
+  OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(single), out);
+  TEST_EXCEPTION(Exception::IllegalArgument, OpenSwathShardMerger::mergeTSV(ListUtils::create<String>(single + "," + shard1), out))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
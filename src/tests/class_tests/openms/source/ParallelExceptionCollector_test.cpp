@@ -0,0 +1,134 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CONCEPT/ParallelExceptionCollector.h>
+///////////////////////////
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <atomic>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(ParallelExceptionCollector, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION((template <typename FunctionT> void run(FunctionT&& f)))
+{
+  // no error
+  ParallelExceptionCollector ok;
+  std::atomic<int> calls(0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < 100; ++i)
+  {
+    ok.run([&]() { ++calls; });
+  }
+  TEST_EQUAL(calls, 100)
+  TEST_EQUAL(ok.failed(), false)
+  ok.rethrow(); // does nothing
+
+  // the type of the exception is kept and later iterations are skipped
+  ParallelExceptionCollector errors;
+  for (SignedSize i = 0; i < 10; ++i)
+  {
+    errors.run([&]()
+    {
+      if (i >= 2) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "error", String(i));
+    });
+  }
+  TEST_EQUAL(errors.failed(), true)
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::InvalidValue, errors.rethrow(), "the value '2' was used but is not valid; error")
+
+  // with several threads, one of the exceptions is rethrown
+  ParallelExceptionCollector parallel_errors;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < 100; ++i)
+  {
+    parallel_errors.run([&]() { throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "error"); });
+  }
+  TEST_EXCEPTION(Exception::Precondition, parallel_errors.rethrow())
+}
+END_SECTION
+
+START_SECTION((void capture()))
+{
+  ParallelExceptionCollector errors;
+  try
+  {
+    throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "first");
+  }
+  catch (...)
+  {
+    errors.capture();
+  }
+  try
+  {
+    throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "second");
+  }
+  catch (...)
+  {
+    errors.capture(); // ignored, the first exception is kept
+  }
+  TEST_EQUAL(errors.failed(), true)
+  TEST_EXCEPTION(Exception::IllegalArgument, errors.rethrow())
+}
+END_SECTION
+
+START_SECTION((bool failed() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((void rethrow() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -35,6 +35,7 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
 ///////////////////////////
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerCWT.h>
@@ -108,6 +109,53 @@ START_SECTION((void pickExperiment(const PeakMap &input, PeakMap &output)))
   }
 END_SECTION
 
+START_SECTION([EXTRA] wavelet_transform:algorithm fft)
+  PeakPickerCWT pp_fft;
+  Param param_fft = param;
+  param_fft.setValue("wavelet_transform:algorithm", "fft");
+  pp_fft.setParameters(param_fft);
+  MSSpectrum spec;
+  pp_fft.pick(input[0], spec);
+  // the transform values differ slightly, the picked positions do not
+  ABORT_IF(spec.size() != output[0].size())
+  for (Size p = 0; p < spec.size(); ++p)
+  {
+    TEST_REAL_SIMILAR(spec[p].getMZ(), output[0][p].getMZ())
+  }
+END_SECTION
+
+START_SECTION([EXTRA] benchmark of the wavelet transform algorithms on a wide profile spectrum)
+{
+  // 200 Th of profile data with a Lorentzian peak every 10 Th
+  MSSpectrum wide;
+  for (double mz = 400.0; mz < 600.0; mz += 0.005)
+  {
+    double d = (mz - (400.0 + 10.0 * floor((mz - 400.0) / 10.0 + 0.5))) / 0.05;
+    wide.push_back(Peak1D(mz, 10.0 + 5000.0 / (1.0 + d * d)));
+  }
+  wide.setMSLevel(1);
+
+  Size n_peaks[2];
+  const char* algorithms[2] = {"integration", "fft"};
+  for (Size a = 0; a < 2; ++a)
+  {
+    PeakPickerCWT pp_bench;
+    Param param_bench = param;
+    param_bench.setValue("wavelet_transform:algorithm", algorithms[a]);
+    pp_bench.setParameters(param_bench);
+    MSSpectrum picked;
+    StopWatch sw;
+    sw.start();
+    pp_bench.pick(wide, picked);
+    sw.stop();
+    n_peaks[a] = picked.size();
+    STATUS(algorithms[a] << ": picked " << picked.size() << " peaks from " << wide.size() << " data points in " << sw.getClockTime() << " s");
+  }
+  TEST_NOT_EQUAL(n_peaks[0], 0)
+  TEST_EQUAL(n_peaks[1], n_peaks[0])
+}
+END_SECTION
+
 START_SECTION(double estimatePeakWidth(const PeakMap& input))
   PeakPickerCWT pp;
   // add empty spectra.. make sure that the algorithm does not stumble
@@ -35,6 +35,10 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
+#include <OpenMS/MATH/MISC/CubicSpline2d.h>
+#include <OpenMS/MATH/MISC/SplineBisection.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 
 ///////////////////////////
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
@@ -491,4 +495,248 @@ START_SECTION(void pick(const MSSpectrum& input, MSSpectrum& output, std::vector
     
 END_SECTION
 
+START_SECTION([EXTRA] pickExperiment gives the same results as picking spectra one by one)
+{
+  PeakMap tmp_picked;
+  std::vector<std::vector<PeakPickerHiRes::PeakBoundary> > tmp_boundaries_s, tmp_boundaries_c;
+  pp_hires.pickExperiment(input, tmp_picked, tmp_boundaries_s, tmp_boundaries_c);
+  TEST_EQUAL(tmp_picked.size(), input.size());
+  Size boundaries_idx = 0; // boundaries are only reported for picked spectra
+  for (Size scan_idx = 0; scan_idx < input.size(); ++scan_idx)
+  {
+    if (input[scan_idx].getType(true) == SpectrumSettings::CENTROID) continue;
+    MSSpectrum tmp_spec;
+    std::vector<PeakPickerHiRes::PeakBoundary> tmp_boundaries;
+    pp_hires.pick(input[scan_idx], tmp_spec, tmp_boundaries);
+    TEST_EQUAL(tmp_picked[scan_idx] == tmp_spec, true);
+    ABORT_IF(boundaries_idx >= tmp_boundaries_s.size());
+    TEST_EQUAL(tmp_boundaries_s[boundaries_idx].size(), tmp_boundaries.size());
+    ++boundaries_idx;
+  }
+  TEST_EQUAL(boundaries_idx, tmp_boundaries_s.size());
+}
+END_SECTION
+
+START_SECTION(void pickExperiment(OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type = true) const)
+{
+  PeakPickerHiRes pp_ondisc;
+  Param pp_param = pp_ondisc.getParameters();
+  pp_param.setValue("ms_levels", ListUtils::create<Int>("1,2"));
+  pp_ondisc.setParameters(pp_param);
+
+  OnDiscPeakMap ondisc_input;
+  ondisc_input.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  PeakMap ondisc_picked;
+  pp_ondisc.pickExperiment(ondisc_input, ondisc_picked, false);
+
+  PeakMap inmemory_input, inmemory_picked;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), inmemory_input);
+  for (auto& spec : inmemory_input)
+  {
+    spec.sortByPosition(); // the on-disc variant sorts before picking
+  }
+  pp_ondisc.pickExperiment(inmemory_input, inmemory_picked, false);
+
+  // prefetching and parallel picking neither change the order of the spectra
+  // nor the picked peaks (reference: picking one spectrum after the other)
+  TEST_EQUAL(ondisc_picked.size(), inmemory_input.size());
+  TEST_EQUAL(inmemory_picked.size(), inmemory_input.size());
+  ABORT_IF(ondisc_picked.size() != inmemory_input.size() || inmemory_picked.size() != inmemory_input.size());
+  for (Size scan_idx = 0; scan_idx < inmemory_input.size(); ++scan_idx)
+  {
+    MSSpectrum serial_picked;
+    pp_ondisc.pick(inmemory_input[scan_idx], serial_picked);
+    TEST_REAL_SIMILAR(ondisc_picked[scan_idx].getRT(), serial_picked.getRT());
+    TEST_REAL_SIMILAR(inmemory_picked[scan_idx].getRT(), serial_picked.getRT());
+    TEST_EQUAL(ondisc_picked[scan_idx].size(), serial_picked.size());
+    TEST_EQUAL(inmemory_picked[scan_idx].size(), serial_picked.size());
+    ABORT_IF(ondisc_picked[scan_idx].size() != serial_picked.size() || inmemory_picked[scan_idx].size() != serial_picked.size());
+    for (Size i = 0; i < serial_picked.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(ondisc_picked[scan_idx][i].getMZ(), serial_picked[i].getMZ());
+      TEST_REAL_SIMILAR(ondisc_picked[scan_idx][i].getIntensity(), serial_picked[i].getIntensity());
+      TEST_REAL_SIMILAR(inmemory_picked[scan_idx][i].getMZ(), serial_picked[i].getMZ());
+      TEST_REAL_SIMILAR(inmemory_picked[scan_idx][i].getIntensity(), serial_picked[i].getIntensity());
+    }
+  }
+
+  TEST_EQUAL(ondisc_picked.getChromatograms().size(), inmemory_input.getChromatograms().size());
+  TEST_EQUAL(inmemory_picked.getChromatograms().size(), inmemory_input.getChromatograms().size());
+  ABORT_IF(ondisc_picked.getChromatograms().size() != inmemory_input.getChromatograms().size() ||
+           inmemory_picked.getChromatograms().size() != inmemory_input.getChromatograms().size());
+  for (Size chrom_idx = 0; chrom_idx < inmemory_input.getChromatograms().size(); ++chrom_idx)
+  {
+    MSChromatogram serial_picked;
+    std::vector<PeakPickerHiRes::PeakBoundary> serial_boundaries;
+    pp_ondisc.pick(inmemory_input.getChromatograms()[chrom_idx], serial_picked, serial_boundaries);
+    const MSChromatogram& ondisc_chrom = ondisc_picked.getChromatograms()[chrom_idx];
+    const MSChromatogram& inmemory_chrom = inmemory_picked.getChromatograms()[chrom_idx];
+    TEST_EQUAL(ondisc_chrom.size(), serial_picked.size());
+    TEST_EQUAL(inmemory_chrom.size(), serial_picked.size());
+    ABORT_IF(ondisc_chrom.size() != serial_picked.size() || inmemory_chrom.size() != serial_picked.size());
+    for (Size i = 0; i < serial_picked.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(ondisc_chrom[i].getRT(), serial_picked[i].getRT());
+      TEST_REAL_SIMILAR(ondisc_chrom[i].getIntensity(), serial_picked[i].getIntensity());
+      TEST_REAL_SIMILAR(inmemory_chrom[i].getRT(), serial_picked[i].getRT());
+      TEST_REAL_SIMILAR(inmemory_chrom[i].getIntensity(), serial_picked[i].getIntensity());
+    }
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] throughput benchmark)
+{
+  // picks the Orbitrap profile data (signal-to-noise 1) and compares the
+  // result with the reference output of the previous implementation
+  PeakMap profile, reference;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("PeakPickerHiRes_orbitrap.mzML"), profile);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("PeakPickerHiRes_orbitrap_sn1_out.mzML"), reference);
+  PeakPickerHiRes pp_bench;
+  Param bench_param = pp_bench.getParameters();
+  bench_param.setValue("signal_to_noise", 1.0);
+  pp_bench.setParameters(bench_param);
+  pp_bench.setLogType(ProgressLogger::NONE);
+
+  const Size repeats = 20;
+  PeakMap picked;
+  StopWatch sw;
+  sw.start();
+  for (Size r = 0; r < repeats; ++r)
+  {
+    pp_bench.pickExperiment(profile, picked);
+  }
+  sw.stop();
+  Size n_peaks = 0;
+  TEST_EQUAL(picked.size(), reference.size())
+  ABORT_IF(picked.size() != reference.size())
+  for (Size scan_idx = 0; scan_idx < picked.size(); ++scan_idx)
+  {
+    TEST_EQUAL(picked[scan_idx].size(), reference[scan_idx].size())
+    ABORT_IF(picked[scan_idx].size() != reference[scan_idx].size())
+    for (Size peak_idx = 0; peak_idx < picked[scan_idx].size(); ++peak_idx)
+    {
+      TEST_REAL_SIMILAR(picked[scan_idx][peak_idx].getMZ(), reference[scan_idx][peak_idx].getMZ())
+      TEST_REAL_SIMILAR(picked[scan_idx][peak_idx].getIntensity(), reference[scan_idx][peak_idx].getIntensity())
+    }
+    n_peaks += picked[scan_idx].size();
+  }
+  STATUS("Picked " << repeats * n_peaks << " peaks in " << sw.getClockTime() << " s ("
+         << (sw.getClockTime() > 0 ? repeats * n_peaks / sw.getClockTime() : 0.0) << " peaks/s)");
+
+  // spline kernel on the raw data of every picked peak: previous path (a map
+  // of the raw points and a new spline per peak) vs. re-initialized spline
+  std::vector<std::vector<double> > peaks_x, peaks_y;
+  for (const MSSpectrum& spec : profile)
+  {
+    MSSpectrum tmp_spec;
+    std::vector<PeakPickerHiRes::PeakBoundary> tmp_boundaries;
+    pp_bench.pick(spec, tmp_spec, tmp_boundaries);
+    for (const PeakPickerHiRes::PeakBoundary& boundary : tmp_boundaries)
+    {
+      std::vector<double> x, y;
+      for (auto it = spec.MZBegin(boundary.mz_min); (it != spec.end()) && (it->getMZ() <= boundary.mz_max); ++it)
+      {
+        x.push_back(it->getMZ());
+        y.push_back(it->getIntensity());
+      }
+      if (x.size() < 3) continue;
+      peaks_x.push_back(x);
+      peaks_y.push_back(y);
+    }
+  }
+  TEST_NOT_EQUAL(peaks_x.size(), 0)
+
+  std::vector<double> old_mz(peaks_x.size()), old_int(peaks_x.size());
+  StopWatch sw_old;
+  sw_old.start();
+  for (Size r = 0; r < repeats; ++r)
+  {
+    for (Size i = 0; i < peaks_x.size(); ++i)
+    {
+      std::map<double, double> raw;
+      for (Size j = 0; j < peaks_x[i].size(); ++j) raw[peaks_x[i][j]] = peaks_y[i][j];
+      CubicSpline2d spline(raw);
+      old_mz[i] = (peaks_x[i].front() + peaks_x[i].back()) / 2;
+      Math::spline_bisection(spline, peaks_x[i].front(), peaks_x[i].back(), old_mz[i], old_int[i]);
+    }
+  }
+  sw_old.stop();
+
+  std::vector<double> new_mz(peaks_x.size()), new_int(peaks_x.size());
+  CubicSpline2d reused;
+  StopWatch sw_new;
+  sw_new.start();
+  for (Size r = 0; r < repeats; ++r)
+  {
+    for (Size i = 0; i < peaks_x.size(); ++i)
+    {
+      reused.init(peaks_x[i], peaks_y[i]);
+      new_mz[i] = (peaks_x[i].front() + peaks_x[i].back()) / 2;
+      Math::spline_bisection(reused, peaks_x[i].front(), peaks_x[i].back(), new_mz[i], new_int[i]);
+    }
+  }
+  sw_new.stop();
+  for (Size i = 0; i < peaks_x.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(new_mz[i], old_mz[i])
+    TEST_REAL_SIMILAR(new_int[i], old_int[i])
+  }
+  STATUS("Spline kernel for " << repeats * peaks_x.size() << " peaks: " << sw_old.getClockTime()
+         << " s (new spline per peak) vs. " << sw_new.getClockTime() << " s (re-initialized spline)");
+}
+END_SECTION
+
+START_SECTION([EXTRA] exact signal-to-noise estimation)
+{
+  // noisy baseline (5-15) with a single peak (height 200) at m/z 105: its
+  // apex and direct neighbors have an S/N of 12.5-19.5 with the histogram
+  // estimate and of 13.2-20.7 with the exact median
+  MSSpectrum spec;
+  for (Size i = 0; i < 1000; ++i)
+  {
+    double mz = 100.0 + i * 0.01;
+    spec.push_back(Peak1D(mz, 5.0 + (i * 7 % 11) + 200.0 * exp(-pow(mz - 105.0, 2) / (2 * 0.01 * 0.01))));
+  }
+
+  PeakPickerHiRes pp;
+  Param param = pp.getParameters();
+  param.setValue("signal_to_noise", 13.0);
+  pp.setParameters(param);
+  MSSpectrum picked;
+  pp.pick(spec, picked);
+  TEST_EQUAL(picked.size(), 0)
+
+  param.setValue("SignalToNoise:estimator", "exact");
+  pp.setParameters(param);
+  pp.pick(spec, picked);
+  TEST_EQUAL(picked.size(), 1)
+  TEST_REAL_SIMILAR(picked[0].getMZ(), 105.0)
+
+  // the estimator is reused for all spectra picked by a thread - this must
+  // not change the results (spectra of different length and noise level)
+  PeakMap noisy_map;
+  for (Size s = 0; s < 20; ++s)
+  {
+    MSSpectrum tmp;
+    for (Size i = 0; i < 500 + 37 * s; ++i)
+    {
+      double mz = 100.0 + i * 0.01;
+      tmp.push_back(Peak1D(mz, 5.0 + s + (i * 7 % 11) + 200.0 * exp(-pow(mz - 102.0, 2) / (2 * 0.01 * 0.01))));
+    }
+    tmp.setType(SpectrumSettings::PROFILE);
+    noisy_map.addSpectrum(tmp);
+  }
+  PeakMap exp_picked;
+  pp.pickExperiment(noisy_map, exp_picked);
+  TEST_EQUAL(exp_picked.size(), noisy_map.size())
+  for (Size s = 0; s < noisy_map.size(); ++s)
+  {
+    MSSpectrum single;
+    pp.pick(noisy_map[s], single);
+    TEST_EQUAL(exp_picked[s] == single, true)
+  }
+}
+END_SECTION
+
 END_TEST
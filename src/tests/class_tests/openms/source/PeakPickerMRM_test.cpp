@@ -162,6 +162,20 @@ START_SECTION(void pickChromatogram(const RichPeakChromatogram &chromatogram, Ri
   TEST_REAL_SIMILAR( picked_chrom.getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][0], 1481.84);  // leftWidth
   TEST_REAL_SIMILAR( picked_chrom.getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][0], 1504.0);   // rightWidth
 
+  ///////////////////////////////////////////////////////////////////////////
+  // Exact median for the signal-to-noise estimation: most of the points are
+  // baseline, the peak gets extended further than with the histogram median.
+  chrom = get_chrom(0);
+  picker_param.setValue("sn_estimator", "exact");
+  picker.setParameters(picker_param);
+  picker.pickChromatogram(chrom, picked_chrom);
+  TEST_EQUAL( picked_chrom.size(), 1);
+  TEST_REAL_SIMILAR( picked_chrom[0].getMZ(), 1495.11);
+  TEST_REAL_SIMILAR( picked_chrom.getFloatDataArrays()[PeakPickerMRM::IDX_ABUNDANCE][0], 61398.8); // IntegratedIntensity
+  TEST_REAL_SIMILAR( picked_chrom.getFloatDataArrays()[PeakPickerMRM::IDX_LEFTBORDER][0], 1482.64); // leftWidth
+  TEST_REAL_SIMILAR( picked_chrom.getFloatDataArrays()[PeakPickerMRM::IDX_RIGHTBORDER][0], 1507.56); // rightWidth
+  picker_param.setValue("sn_estimator", "histogram");
+
 #ifdef WITH_CRAWDAD
   chrom = get_chrom(0);
   picker_param.setValue("method", "crawdad");
@@ -40,6 +40,8 @@
 #include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
 #include <OpenMS/KERNEL/Peak2D.h>
 
+#include <cmath>
+
 ///////////////////////////
 
 START_TEST(SavitzkyGolayFilter<D>, "$Id$")
@@ -157,6 +159,40 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] filter(MSSpectrum&) gives the same result as the iterator-based filter)
+  Param p;
+  p.setValue("polynomial_order", 4);
+  p.setValue("frame_length", 11);
+  SavitzkyGolayFilter sgolay;
+  sgolay.setParameters(p);
+
+  MSSpectrum spectrum;
+  for (Size i = 0; i < 1000; ++i) // more than one block of the vectorized steady state
+  {
+    Peak1D peak;
+    peak.setMZ(500.0 + i * 0.001);
+    peak.setIntensity(100.0f * (1.0f + std::sin(i * 0.1f)) + (i % 7));
+    spectrum.push_back(peak);
+  }
+  MSSpectrum reference = spectrum;
+  sgolay.filter(spectrum.begin(), spectrum.end(), reference.begin());
+  sgolay.filter(spectrum);
+  TEST_EQUAL(spectrum.size(), reference.size())
+  for (Size i = 0; i < spectrum.size(); ++i)
+  {
+    TEST_EQUAL(spectrum[i].getMZ(), reference[i].getMZ())
+    TEST_EQUAL(spectrum[i].getIntensity(), reference[i].getIntensity())
+  }
+
+  // fewer data points than the frame length: unchanged
+  MSSpectrum small_spectrum;
+  small_spectrum.resize(5);
+  small_spectrum[2].setIntensity(1.0f);
+  MSSpectrum small_copy = small_spectrum;
+  sgolay.filter(small_spectrum);
+  TEST_EQUAL(small_spectrum == small_copy, true)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
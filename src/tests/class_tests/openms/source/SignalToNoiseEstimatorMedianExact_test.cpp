@@ -0,0 +1,185 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+#include <OpenMS/FORMAT/DTAFile.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+///////////////////////////
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianExact.h>
+///////////////////////////
+
+#include <algorithm>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SignalToNoiseEstimatorMedianExact, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// brute force reference: lower median of the intensities in [mz - win_len/2, mz + win_len/2]
+auto referenceSTN = [](const MSSpectrum& s, double win_len, Size min_elements, double noise_for_empty_window)
+{
+  vector<double> result;
+  for (Size i = 0; i < s.size(); ++i)
+  {
+    vector<double> window;
+    for (Size j = 0; j < s.size(); ++j)
+    {
+      if (s[j].getMZ() >= s[i].getMZ() - win_len / 2 && s[j].getMZ() <= s[i].getMZ() + win_len / 2)
+      {
+        window.push_back(s[j].getIntensity());
+      }
+    }
+    double noise = noise_for_empty_window;
+    if (window.size() >= min_elements)
+    {
+      sort(window.begin(), window.end());
+      noise = max(1.0, window[(window.size() + 1) / 2 - 1]);
+    }
+    result.push_back(s[i].getIntensity() / noise);
+  }
+  return result;
+};
+
+SignalToNoiseEstimatorMedianExact< >* ptr = nullptr;
+SignalToNoiseEstimatorMedianExact< >* nullPointer = nullptr;
+START_SECTION((SignalToNoiseEstimatorMedianExact()))
+  ptr = new SignalToNoiseEstimatorMedianExact<>;
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  SignalToNoiseEstimatorMedianExact<> sne;
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianExact& operator=(const SignalToNoiseEstimatorMedianExact &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianExact<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianExact<> sne2;
+  sne2 = sne;
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianExact(const SignalToNoiseEstimatorMedianExact &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianExact<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianExact<> sne2(sne);
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((virtual ~SignalToNoiseEstimatorMedianExact()))
+  delete ptr;
+END_SECTION
+
+START_SECTION((double getSparseWindowPercent() const))
+  MSSpectrum s;
+  for (Size i = 0; i < 20; ++i)
+  {
+    s.push_back(Peak1D(100.0 + i * 10.0, 5.0));
+  }
+  SignalToNoiseEstimatorMedianExact<> sne;
+  Param p = sne.getParameters();
+  p.setValue("win_len", 40.0); // 5 points per window at most
+  p.setValue("min_required_elements", 5);
+  p.setValue("write_log_messages", "false");
+  sne.setParameters(p);
+  sne.init(s);
+  // only the first two and the last two windows are sparse
+  TEST_REAL_SIMILAR(sne.getSparseWindowPercent(), 20.0)
+END_SECTION
+
+START_SECTION([EXTRA](virtual void init(const Container& c)))
+  MSSpectrum raw_data;
+  DTAFile dta_file;
+  dta_file.load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+  SignalToNoiseEstimatorMedianExact< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+  sne.init(raw_data);
+
+  vector<double> expected = referenceSTN(raw_data, 40.0, 10, 2.0);
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(sne.getSignalToNoise(i), expected[i])
+  }
+
+  // the workspace is reused for a smaller spectrum with ties and zero intensities
+  MSSpectrum small;
+  double intensities[] = {3, 0, 7, 7, 1, 3, 250, 3, 0, 12, 7, 7};
+  for (Size i = 0; i < 12; ++i)
+  {
+    small.push_back(Peak1D(500.0 + i * 0.5, intensities[i]));
+  }
+  p.setValue("win_len", 2.0);
+  p.setValue("min_required_elements", 3);
+  sne.setParameters(p);
+  sne.init(small);
+  expected = referenceSTN(small, 2.0, 3, 2.0);
+  for (Size i = 0; i < small.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(sne.getSignalToNoise(i), expected[i])
+  }
+
+  // empty input
+  MSSpectrum empty;
+  sne.init(empty);
+  TEST_EQUAL(sne.getSparseWindowPercent(), 0.0)
+END_SECTION
+
+START_SECTION([EXTRA](chromatograms))
+  MSChromatogram chrom;
+  for (Size i = 0; i < 50; ++i)
+  {
+    chrom.push_back(ChromatogramPeak(i * 1.0, (i % 7) * 10.0 + (i == 25 ? 1000.0 : 0.0)));
+  }
+  SignalToNoiseEstimatorMedianExact< MSChromatogram > sne;
+  Param p = sne.getParameters();
+  p.setValue("win_len", 11.0);
+  p.setValue("min_required_elements", 5);
+  sne.setParameters(p);
+  sne.init(chrom);
+  // window around RT 25: RT 20..30 -> intensities (i % 7) * 10 with 25 -> 1040, median is 20
+  TEST_REAL_SIMILAR(sne.getSignalToNoise(25), 1040.0 / 20.0)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
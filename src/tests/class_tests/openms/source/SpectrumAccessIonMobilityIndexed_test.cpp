@@ -0,0 +1,203 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// one spectrum with ion mobility (peaks sorted by m/z, with a tie in m/z) and one without
+boost::shared_ptr<PeakMap > getData()
+{
+  boost::shared_ptr<PeakMap > exp2(new PeakMap);
+  MSSpectrum spec;
+  spec.getFloatDataArrays().resize(1);
+  spec.getFloatDataArrays()[0].setName("Ion Mobility");
+  double mz[] = {100, 200, 200, 300, 400, 500, 600, 700};
+  double im[] = {0.9, 0.7, 1.3, 1.1, 0.7, 1.0, 1.2, 0.8};
+  for (Size i = 0; i < 8; ++i)
+  {
+    Peak1D p;
+    p.setMZ(mz[i]);
+    p.setIntensity(10.0 * (i + 1));
+    spec.push_back(p);
+    spec.getFloatDataArrays()[0].push_back(im[i]);
+  }
+  exp2->addSpectrum(spec);
+
+  MSSpectrum spec_no_im;
+  Peak1D p;
+  p.setMZ(100);
+  p.setIntensity(50);
+  spec_no_im.push_back(p);
+  exp2->addSpectrum(spec_no_im);
+  return exp2;
+}
+
+START_TEST(SpectrumAccessIonMobilityIndexed, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectrumAccessIonMobilityIndexed* ptr = nullptr;
+SpectrumAccessIonMobilityIndexed* nullPointer = nullptr;
+
+boost::shared_ptr<PeakMap > exp = getData();
+OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+START_SECTION(SpectrumAccessIonMobilityIndexed(OpenSwath::SpectrumAccessPtr sptr, Size nr_im_bins = 64, Size max_bytes = 512 * 1024 * 1024))
+{
+  ptr = new SpectrumAccessIonMobilityIndexed(expptr);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNrSpectra(), 2)
+  TEST_EQUAL(ptr->getNrIndexedSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessIonMobilityIndexed())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  // spectra are passed on unchanged
+  SpectrumAccessIonMobilityIndexed im_access(expptr, 4);
+  OpenSwath::SpectrumPtr spec = im_access.getSpectrumById(0);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 8)
+  TEST_EQUAL(spec->getDriftTimeArray()->data.size(), 8)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[3], 300)
+  TEST_EQUAL(im_access.getNrIndexBuilds(), 0)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumByIdAndDrift(int id, double drift_lower, double drift_upper))
+{
+  SpectrumAccessIonMobilityIndexed im_access(expptr, 4);
+
+  // peaks with 0.75 < im < 1.15 in m/z order
+  OpenSwath::SpectrumPtr spec = im_access.getSpectrumByIdAndDrift(0, 0.75, 1.15);
+  TEST_EQUAL(spec->getDataArrays().size(), 3)
+  TEST_EQUAL(spec->getDriftTimeArray()->description, "Ion Mobility")
+  TEST_EQUAL(spec->getMZArray()->data.size(), 4)
+  TEST_EQUAL(spec->getIntensityArray()->data.size(), 4)
+  TEST_EQUAL(spec->getDriftTimeArray()->data.size(), 4)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[0], 100)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[1], 300)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[2], 500)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[3], 700)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[0], 10)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[1], 40)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[2], 60)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[3], 80)
+  TEST_REAL_SIMILAR(spec->getDriftTimeArray()->data[0], 0.9)
+  TEST_REAL_SIMILAR(spec->getDriftTimeArray()->data[3], 0.8)
+  TEST_EQUAL(im_access.getNrIndexedSpectra(), 1)
+
+  // the boundaries are exclusive and peaks with identical m/z keep their order
+  spec = im_access.getSpectrumByIdAndDrift(0, 0.7, 1.31);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 6)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[0], 100)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[1], 200)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[1], 30)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[2], 300)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[5], 700)
+
+  // whole range and empty / inverted windows
+  spec = im_access.getSpectrumByIdAndDrift(0, 0.0, 2.0);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 8)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[1], 20)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[2], 30)
+  spec = im_access.getSpectrumByIdAndDrift(0, 1.4, 2.0);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 0)
+  spec = im_access.getSpectrumByIdAndDrift(0, 1.0, 0.8);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 0)
+
+  // the index is only built once
+  TEST_EQUAL(im_access.getNrIndexBuilds(), 1)
+
+  // spectra without ion mobility are returned unfiltered
+  spec = im_access.getSpectrumByIdAndDrift(1, 0.75, 1.15);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 1)
+  TEST_REAL_SIMILAR(spec->getIntensityArray()->data[0], 50)
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  boost::shared_ptr<SpectrumAccessIonMobilityIndexed> im_access(new SpectrumAccessIonMobilityIndexed(expptr, 4));
+  im_access->getSpectrumByIdAndDrift(0, 0.75, 1.15);
+
+  boost::shared_ptr<SpectrumAccessIonMobilityIndexed> clone_ptr =
+    boost::dynamic_pointer_cast<SpectrumAccessIonMobilityIndexed>(im_access->lightClone());
+  TEST_NOT_EQUAL(clone_ptr.get(), nullPointer)
+  TEST_EQUAL(clone_ptr->getNrSpectra(), 2)
+
+  // the clone shares the index cache
+  OpenSwath::SpectrumPtr spec = clone_ptr->getSpectrumByIdAndDrift(0, 0.75, 1.15);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 4)
+  TEST_EQUAL(clone_ptr->getNrIndexBuilds(), 1)
+  TEST_EQUAL(im_access->getNrIndexedSpectra(), 1)
+}
+END_SECTION
+
+START_SECTION(Size getNrIndexedSpectra() const)
+{
+  // a memory budget that is too small for any index: nothing is cached
+  SpectrumAccessIonMobilityIndexed im_access(expptr, 4, 0);
+  OpenSwath::SpectrumPtr spec = im_access.getSpectrumByIdAndDrift(0, 0.75, 1.15);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 4)
+  spec = im_access.getSpectrumByIdAndDrift(0, 0.75, 1.15);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 4)
+  TEST_EQUAL(im_access.getNrIndexedSpectra(), 0)
+  TEST_EQUAL(im_access.getNrIndexBuilds(), 2)
+}
+END_SECTION
+
+START_SECTION(Size getNrIndexBuilds() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
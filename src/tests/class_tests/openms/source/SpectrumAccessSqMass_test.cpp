@@ -249,6 +249,39 @@ START_SECTION(void getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra
 }
 END_SECTION
 
+START_SECTION(void setCacheSize(Size max_bytes))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+
+  ptr = new SpectrumAccessSqMass(handler);
+  TEST_EQUAL(ptr->getCache() == nullptr, true)
+  ptr->setCacheSize(1024 * 1024);
+  TEST_EQUAL(ptr->getCache() == nullptr, false)
+
+  // the cache is shared with clones and subsets (using the same spectrum indices)
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> ptr2 = ptr->lightClone();
+  std::vector<int> indices;
+  indices.push_back(1);
+  SpectrumAccessSqMass subset(*ptr, indices);
+
+  TEST_EQUAL(ptr->getSpectrumById(1)->getMZArray()->data.size(), 19800)
+  TEST_EQUAL(ptr2->getSpectrumById(1)->getMZArray()->data.size(), 19800)
+  TEST_EQUAL(subset.getSpectrumById(0)->getMZArray()->data.size(), 19800)
+  TEST_EQUAL(subset.getSpectrumById(0)->getIntensityArray()->data.size(), 19800)
+  TEST_EQUAL(ptr->getCache()->getMisses(), 1)
+  TEST_EQUAL(ptr->getCache()->getHits(), 3)
+
+  ptr->setCacheSize(0);
+  TEST_EQUAL(ptr->getCache() == nullptr, true)
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<SpectrumLRUCache> getCache() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
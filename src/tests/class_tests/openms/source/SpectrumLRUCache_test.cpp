@@ -0,0 +1,206 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumLRUCache.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+OpenSwath::SpectrumPtr createSpectrum(Size nr_peaks, double offset)
+{
+  OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+  for (Size i = 0; i < nr_peaks; ++i)
+  {
+    sptr->getMZArray()->data.push_back(offset + i);
+    sptr->getIntensityArray()->data.push_back(10.0 * i);
+  }
+  return sptr;
+}
+
+START_TEST(SpectrumLRUCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectrumLRUCache* ptr = nullptr;
+SpectrumLRUCache* nullPointer = nullptr;
+
+START_SECTION(SpectrumLRUCache(Size max_bytes))
+{
+  ptr = new SpectrumLRUCache(1000);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getMaxBytes(), 1000)
+  TEST_EQUAL(ptr->getBytes(), 0)
+  TEST_EQUAL(ptr->getNrSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION(~SpectrumLRUCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(bool get(Size id, OpenSwath::SpectrumPtr& spectrum))
+{
+  SpectrumLRUCache cache(1000);
+  OpenSwath::SpectrumPtr sptr;
+  TEST_EQUAL(cache.get(5, sptr), false)
+  TEST_EQUAL(sptr == nullptr, true)
+
+  cache.put(5, createSpectrum(10, 100.0));
+  TEST_EQUAL(cache.get(5, sptr), true)
+  TEST_EQUAL(sptr->getMZArray()->data.size(), 10)
+  TEST_REAL_SIMILAR(sptr->getMZArray()->data[3], 103.0)
+  TEST_REAL_SIMILAR(sptr->getIntensityArray()->data[3], 30.0)
+
+  // the returned spectrum is a copy and can be modified
+  sptr->getMZArray()->data[3] = -1.0;
+  OpenSwath::SpectrumPtr sptr2;
+  TEST_EQUAL(cache.get(5, sptr2), true)
+  TEST_REAL_SIMILAR(sptr2->getMZArray()->data[3], 103.0)
+
+  TEST_EQUAL(cache.getHits(), 2)
+  TEST_EQUAL(cache.getMisses(), 1)
+}
+END_SECTION
+
+START_SECTION(void put(Size id, const OpenSwath::SpectrumPtr& spectrum))
+{
+  // 10 peaks in two arrays use 160 bytes, so 3 spectra fit into the cache
+  SpectrumLRUCache cache(500);
+  OpenSwath::SpectrumPtr sptr;
+  cache.put(1, createSpectrum(10, 100.0));
+  cache.put(2, createSpectrum(10, 200.0));
+  cache.put(3, createSpectrum(10, 300.0));
+  TEST_EQUAL(cache.getNrSpectra(), 3)
+  TEST_EQUAL(cache.getBytes(), 480)
+
+  // spectrum 1 becomes the most recently used, so spectrum 2 is removed next
+  TEST_EQUAL(cache.get(1, sptr), true)
+  cache.put(4, createSpectrum(10, 400.0));
+  TEST_EQUAL(cache.getNrSpectra(), 3)
+  TEST_EQUAL(cache.get(2, sptr), false)
+  TEST_EQUAL(cache.get(1, sptr), true)
+  TEST_EQUAL(cache.get(3, sptr), true)
+  TEST_EQUAL(cache.get(4, sptr), true)
+  TEST_REAL_SIMILAR(sptr->getMZArray()->data[0], 400.0)
+
+  // adding a cached spectrum again does not change anything
+  cache.put(4, createSpectrum(5, 500.0));
+  TEST_EQUAL(cache.get(4, sptr), true)
+  TEST_EQUAL(sptr->getMZArray()->data.size(), 10)
+  TEST_EQUAL(cache.getBytes(), 480)
+
+  // spectra larger than the budget are not stored
+  cache.put(6, createSpectrum(100, 600.0));
+  TEST_EQUAL(cache.get(6, sptr), false)
+  TEST_EQUAL(cache.getNrSpectra(), 3)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  SpectrumLRUCache cache(500);
+  OpenSwath::SpectrumPtr sptr;
+  cache.put(1, createSpectrum(10, 100.0));
+  TEST_EQUAL(cache.get(1, sptr), true)
+  cache.clear();
+  TEST_EQUAL(cache.getNrSpectra(), 0)
+  TEST_EQUAL(cache.getBytes(), 0)
+  TEST_EQUAL(cache.get(1, sptr), false)
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_EQUAL(cache.getMisses(), 1)
+}
+END_SECTION
+
+START_SECTION(Size getHits() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getMisses() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getNrSpectra() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getBytes() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION(Size getMaxBytes() const)
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION([EXTRA] concurrent access)
+{
+  SpectrumLRUCache cache(20 * 160);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < 1000; ++i)
+  {
+    OpenSwath::SpectrumPtr sptr;
+    Size id = i % 50;
+    if (!cache.get(id, sptr))
+    {
+      cache.put(id, createSpectrum(10, 100.0 * id));
+    }
+  }
+  TEST_EQUAL(cache.getHits() + cache.getMisses(), 1000)
+  TEST_EQUAL(cache.getNrSpectra() <= 20, true)
+  TEST_EQUAL(cache.getBytes(), cache.getNrSpectra() * 160)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -42,6 +42,8 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
 ///////////////////////////
 
+#include <fstream>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -80,6 +82,62 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION(void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false))
+{
+  // library with peptides and compounds, the PQP file returns the transitions
+  // ordered by precursor m/z and product m/z (UNION of the peptide and the compound query)
+  String tsv_filename, pqp_filename;
+  NEW_TMP_FILE(tsv_filename)
+  NEW_TMP_FILE(pqp_filename)
+  {
+    std::ofstream ofs(tsv_filename.c_str());
+    ofs << "PrecursorMz\tProductMz\tLibraryIntensity\tNormalizedRetentionTime\tPeptideSequence\tModifiedPeptideSequence\tPrecursorCharge\t"
+        << "ProteinId\tCompoundName\tSumFormula\tSMILES\tAdducts\tTransitionGroupId\tTransitionId\tDecoy\n"
+        << "500.2\t300.1\t100\t10\tPEPTIDEK\tPEPTIDEK\t2\tProtA\t\t\t\t\tpep_1\ttr_1\t0\n"
+        << "500.2\t400.1\t50\t10\tPEPTIDEK\tPEPTIDEK\t2\tProtA\t\t\t\t\tpep_1\ttr_2\t0\n"
+        << "300.5\t150.2\t80\t20\t\t\t1\t\tGlucose\tC6H12O6\tOCC1OC(O)C(O)C(O)C1O\t[M+H]+\tcmp_1\ttr_3\t0\n"
+        << "300.5\t120.3\t40\t20\t\t\t1\t\tGlucose\tC6H12O6\tOCC1OC(O)C(O)C(O)C1O\t[M+H]+\tcmp_1\ttr_4\t0\n"
+        << "450.7\t600.3\t70\t30\tELVISLIVESK\tELVISLIVESK\t2\tProtA;ProtB\t\t\t\t\tpep_2\ttr_5\t0\n"
+        << "450.7\t500.4\t60\t30\tELVISLIVESK\tELVISLIVESK\t2\tProtA;ProtB\t\t\t\t\tpep_2\ttr_6\t0\n"
+        << "550.9\t200.5\t30\t40\t\t\t1\t\tCitrate\tC6H8O7\tOC(=O)CC(O)(CC(O)=O)C(O)=O\t[M+H]+\tcmp_2\ttr_7\t0\n";
+  }
+  TransitionPQPFile pqp_file;
+  TargetedExperiment targeted_exp;
+  pqp_file.convertTSVToTargetedExperiment(tsv_filename.c_str(), FileTypes::TSV, targeted_exp);
+  pqp_file.convertTargetedExperimentToPQP(pqp_filename.c_str(), targeted_exp);
+
+  OpenSwath::LightTargetedExperiment exp;
+  pqp_file.convertPQPToTargetedExperiment(pqp_filename.c_str(), exp, true);
+
+  const char* transitions[] = {"tr_4", "tr_3", "tr_6", "tr_5", "tr_1", "tr_2", "tr_7"};
+  const char* groups[] = {"cmp_1", "cmp_1", "pep_2", "pep_2", "pep_1", "pep_1", "cmp_2"};
+  const double product_mz[] = {120.3, 150.2, 500.4, 600.3, 300.1, 400.1, 200.5};
+  TEST_EQUAL(exp.transitions.size(), 7)
+  ABORT_IF(exp.transitions.size() != 7)
+  for (Size i = 0; i < exp.transitions.size(); ++i)
+  {
+    TEST_EQUAL(exp.transitions[i].transition_name, transitions[i])
+    TEST_EQUAL(exp.transitions[i].peptide_ref, groups[i])
+    TEST_REAL_SIMILAR(exp.transitions[i].product_mz, product_mz[i])
+  }
+
+  TEST_EQUAL(exp.compounds.size(), 4)
+  ABORT_IF(exp.compounds.size() != 4)
+  TEST_EQUAL(exp.compounds[0].id, "cmp_1")
+  TEST_EQUAL(exp.compounds[0].isPeptide(), false)
+  TEST_EQUAL(exp.compounds[0].compound_name, "Glucose")
+  TEST_EQUAL(exp.compounds[0].sum_formula, "C6H12O6")
+  TEST_EQUAL(exp.compounds[1].id, "pep_2")
+  TEST_EQUAL(exp.compounds[1].sequence, "ELVISLIVESK")
+  TEST_EQUAL(exp.compounds[1].protein_refs.size(), 2)
+  TEST_EQUAL(exp.compounds[2].id, "pep_1")
+  TEST_EQUAL(exp.compounds[2].sequence, "PEPTIDEK")
+  TEST_EQUAL(exp.compounds[3].id, "cmp_2")
+  TEST_EQUAL(exp.compounds[3].compound_name, "Citrate")
+  TEST_EQUAL(exp.proteins.size(), 2)
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
@@ -42,9 +42,39 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVFile.h>
 ///////////////////////////
 
+#include <fstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
+// Writes a transition list with interleaved transition groups, the
+// transition ids count down in file order. Lines in @p bad_lines (1-based,
+// without header) miss their last column.
+void writeTransitionList(const String& filename, Size nr_transitions, const std::set<Size>& bad_lines = std::set<Size>(),
+                         const String& precursor_column = "PrecursorMz")
+{
+  const char* sequences[] = {"PEPTIDEK", "ELVISLIVESK", "NGGTLLAR", "ALVAYYQK", "SAPSTGGVK"};
+  std::ofstream ofs(filename.c_str());
+  ofs << precursor_column << "\tProductMz\tLibraryIntensity\tNormalizedRetentionTime\tPeptideSequence\tModifiedPeptideSequence\t"
+      << "PrecursorCharge\tProteinId\tTransitionGroupId\tTransitionId\tDecoy\n";
+  for (Size i = 0; i < nr_transitions; ++i)
+  {
+    Size group = (i * 7) % 50;
+    ofs << 400.0 + group << "\t" << 200.0 + i * 0.5 << "\t" << i + 1 << "\t" << group << "\t"
+        << sequences[group % 5] << "\t" << sequences[group % 5] << "\t2\tProtein_" << group % 3 << "\t"
+        << "group_" << group << "\ttr_" << nr_transitions - i;
+    if (bad_lines.find(i + 1) == bad_lines.end())
+    {
+      ofs << "\t0";
+    }
+    ofs << "\n";
+  }
+}
+
 START_TEST(TransitionTSVFile, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -80,6 +110,91 @@ START_SECTION( void convertTSVToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION(void convertTSVToTargetedExperiment(const char* filename, FileTypes::Type filetype, OpenSwath::LightTargetedExperiment& targeted_exp))
+{
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(std::max(4, max_threads));
+#endif
+
+  // the transitions are stored in the order of the file, independent of the chunks the file is parsed in
+  const Size nr_transitions = 2500;
+  String filename;
+  NEW_TMP_FILE(filename)
+  writeTransitionList(filename, nr_transitions);
+
+  TransitionTSVFile tsv_file;
+  OpenSwath::LightTargetedExperiment reference;
+  tsv_file.convertTSVToTargetedExperiment(filename.c_str(), FileTypes::TSV, reference);
+  TEST_EQUAL(reference.transitions.size(), nr_transitions)
+  TEST_EQUAL(reference.compounds.size(), 50)
+  TEST_EQUAL(reference.proteins.size(), 3)
+  ABORT_IF(reference.transitions.size() != nr_transitions)
+  for (Size i = 0; i < nr_transitions; i += 499)
+  {
+    TEST_EQUAL(reference.transitions[i].transition_name, "tr_" + String(nr_transitions - i))
+    TEST_EQUAL(reference.transitions[i].peptide_ref, "group_" + String((i * 7) % 50))
+    TEST_REAL_SIMILAR(reference.transitions[i].product_mz, 200.0 + i * 0.5)
+    TEST_REAL_SIMILAR(reference.transitions[i].library_intensity, i + 1.0)
+  }
+  TEST_EQUAL(reference.compounds[1].id, "group_7")
+  TEST_EQUAL(reference.compounds[1].sequence, "NGGTLLAR")
+
+  for (int chunk_size : {1, 7, 1000, 2500})
+  {
+    Param p = tsv_file.getParameters();
+    p.setValue("chunk_size", chunk_size);
+    TransitionTSVFile chunked_file;
+    chunked_file.setParameters(p);
+    OpenSwath::LightTargetedExperiment chunked;
+    chunked_file.convertTSVToTargetedExperiment(filename.c_str(), FileTypes::TSV, chunked);
+    TEST_EQUAL(chunked.transitions.size(), nr_transitions)
+    TEST_EQUAL(chunked.compounds.size(), reference.compounds.size())
+    ABORT_IF(chunked.transitions.size() != nr_transitions)
+    for (Size i = 0; i < nr_transitions; ++i)
+    {
+      if (chunked.transitions[i].transition_name != reference.transitions[i].transition_name ||
+          chunked.transitions[i].product_mz != reference.transitions[i].product_mz)
+      {
+        TEST_EQUAL(chunked.transitions[i].transition_name, reference.transitions[i].transition_name)
+        break;
+      }
+    }
+    for (Size i = 0; i < reference.compounds.size(); ++i)
+    {
+      TEST_EQUAL(chunked.compounds[i].id, reference.compounds[i].id)
+    }
+  }
+
+  // of several erroneous lines (parsed by different threads), the first one is reported
+  String bad_filename;
+  NEW_TMP_FILE(bad_filename)
+  writeTransitionList(bad_filename, 5000, {4800, 2600, 1500});
+  for (int chunk_size : {100000, 1000})
+  {
+    Param p = tsv_file.getParameters();
+    p.setValue("chunk_size", chunk_size);
+    TransitionTSVFile bad_file;
+    bad_file.setParameters(p);
+    OpenSwath::LightTargetedExperiment exp;
+    TEST_EXCEPTION_WITH_MESSAGE(Exception::IllegalArgument, bad_file.convertTSVToTargetedExperiment(bad_filename.c_str(), FileTypes::TSV, exp),
+      "Error reading the file on line 1500: length of the header and length of the line do not match: 10 != 11")
+  }
+
+  // a missing PrecursorMz column is reported before any line is parsed
+  String no_precursor_filename;
+  NEW_TMP_FILE(no_precursor_filename)
+  writeTransitionList(no_precursor_filename, 10, {}, "Q1");
+  OpenSwath::LightTargetedExperiment exp;
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::IllegalArgument, tsv_file.convertTSVToTargetedExperiment(no_precursor_filename.c_str(), FileTypes::TSV, exp),
+    "Expected a header named PrecursorMz but found none")
+
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
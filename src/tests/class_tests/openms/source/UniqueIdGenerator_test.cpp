@@ -37,8 +37,10 @@
 
 ///////////////////////////
 #include <OpenMS/CONCEPT/UniqueIdGenerator.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
 #include <ctime>
 #include <algorithm> // for std::sort and std::adjacent_find
+#include <set>
 // array_wrapper needs to be included before it is used
 // only in boost1.64+. See issue #2790
 #if OPENMS_BOOST_VERSION_MINOR >= 64
@@ -168,6 +170,83 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION((static void setReproducibleParallelIds(bool reproducible)))
+{
+  TEST_EQUAL(OpenMS::UniqueIdGenerator::getReproducibleParallelIds(), false)
+  OpenMS::UniqueIdGenerator::setReproducibleParallelIds(true);
+  TEST_EQUAL(OpenMS::UniqueIdGenerator::getReproducibleParallelIds(), true)
+
+  // same seed and number of threads result in the same ids (per index with a static schedule)
+  std::vector<OpenMS::UInt64> ids(nofIdsToGenerate), ids2(nofIdsToGenerate);
+  OpenMS::UniqueIdGenerator::setSeed(546666321);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(nofIdsToGenerate); ++i)
+  {
+    ids[i] = OpenMS::UniqueIdGenerator::getUniqueId();
+  }
+  OpenMS::UniqueIdGenerator::setSeed(546666321);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(nofIdsToGenerate); ++i)
+  {
+    ids2[i] = OpenMS::UniqueIdGenerator::getUniqueId();
+  }
+  TEST_EQUAL(ids == ids2, true)
+
+  std::sort(ids.begin(), ids.end());
+  TEST_EQUAL(std::adjacent_find(ids.begin(), ids.end()) == ids.end(), true)
+
+  OpenMS::UniqueIdGenerator::setReproducibleParallelIds(false);
+  TEST_EQUAL(OpenMS::UniqueIdGenerator::getReproducibleParallelIds(), false)
+}
+END_SECTION
+
+START_SECTION((static bool getReproducibleParallelIds()))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((static UInt64 deriveSeed(UInt64 seed, UInt64 stream)))
+{
+  const OpenMS::UInt64 seed = 546666321;
+  TEST_EQUAL(OpenMS::UniqueIdGenerator::deriveSeed(seed, 3), OpenMS::UniqueIdGenerator::deriveSeed(seed, 3))
+  // streams of neighbouring seeds do not overlap (as seed + stream would)
+  std::set<OpenMS::UInt64> seeds;
+  for (OpenMS::UInt64 s = seed; s < seed + 16; ++s)
+  {
+    for (OpenMS::UInt64 stream = 0; stream < 16; ++stream)
+    {
+      seeds.insert(OpenMS::UniqueIdGenerator::deriveSeed(s, stream));
+    }
+  }
+  TEST_EQUAL(seeds.size(), 256)
+}
+END_SECTION
+
+START_SECTION([EXTRA] contention benchmark)
+{
+  // not a real test: reports the time needed to draw ids concurrently from all threads
+  const int nof_ids = 10 * nofIdsToGenerate;
+  std::vector<OpenMS::UInt64> ids(nof_ids);
+  for (bool reproducible : {false, true})
+  {
+    OpenMS::UniqueIdGenerator::setReproducibleParallelIds(reproducible);
+    OpenMS::StopWatch sw;
+    sw.start();
+#pragma omp parallel for
+    for (int i = 0; i < nof_ids; ++i)
+    {
+      ids[i] = OpenMS::UniqueIdGenerator::getUniqueId();
+    }
+    sw.stop();
+    STATUS("reproducible: " << reproducible << ", " << nof_ids << " ids in " << sw.getClockTime() << " s");
+    std::sort(ids.begin(), ids.end());
+    TEST_EQUAL(std::adjacent_find(ids.begin(), ids.end()) == ids.end(), true)
+  }
+  OpenMS::UniqueIdGenerator::setReproducibleParallelIds(false);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -315,6 +315,17 @@ BOOST_AUTO_TEST_CASE(initializeXCorrPrecursorCombinedMatrix)
 
   TEST_EQUAL(mrmscore.getXCorrPrecursorCombinedMatrix().size(), 5)
   TEST_EQUAL(mrmscore.getXCorrPrecursorCombinedMatrix()[0].size(), 5)
+
+  // the lower triangle mirrors the upper triangle
+  const MRMScoring::XCorrMatrixType& xcorr = mrmscore.getXCorrPrecursorCombinedMatrix();
+  std::size_t n = xcorr[0][1].data.size();
+  TEST_EQUAL(xcorr[1][0].data.size(), n)
+  for (std::size_t k = 0; k < n; ++k)
+  {
+    TEST_EQUAL(xcorr[1][0].data[k].first, -xcorr[0][1].data[n - 1 - k].first)
+    TEST_EQUAL(xcorr[1][0].data[k].second, xcorr[0][1].data[n - 1 - k].second)
+  }
+  delete imrmfeature;
 }
 END_SECTION
 
@@ -36,6 +36,12 @@
 
 #include "OpenMS/OPENSWATHALGO/ALGO/Scoring.h"
 
+// MIToolbox serves as reference implementation for the mutual information
+#include <ArrayOperations.c>
+#include <CalculateProbability.c>
+#include <Entropy.c>
+#include <MutualInformation.c>
+
 #ifdef USE_BOOST_UNIT_TEST
 
 // include boost unit test framework
@@ -350,6 +356,56 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_standardizedCrossCorrelation)
+//START_SECTION((XCorrArrayType standardizedCrossCorrelation(const std::vector<double>& data1, const std::vector<double>& data2, const int& maxdelay, const int& lag)))
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+  std::vector<double> data1_copy(data1), data2_copy(data2);
+
+  OpenSwath::Scoring::XCorrArrayType result = Scoring::standardizedCrossCorrelation(data1, data2, 2, 1);
+
+  TEST_REAL_SIMILAR (result.data[4].second, -0.7374631);
+  TEST_REAL_SIMILAR (result.data[3].second, -0.567846);
+  TEST_REAL_SIMILAR (result.data[2].second,  0.4159292);
+  TEST_REAL_SIMILAR (result.data[1].second,  0.8215339);
+  TEST_REAL_SIMILAR (result.data[0].second,  0.15634218);
+  TEST_EQUAL (result.data[0].first, -2)
+  TEST_EQUAL (result.data[4].first, 2)
+
+  // input is not modified
+  TEST_EQUAL (data1 == data1_copy, true)
+  TEST_EQUAL (data2 == data2_copy, true)
+
+  // full range of delays (as used by MRMScoring) is identical to the explicit sum
+  result = Scoring::standardizedCrossCorrelation(data1, data2, 6, 1);
+  TEST_EQUAL (result.data.size(), 13)
+  for (int k = 0; k < 13; ++k)
+  {
+    int delay = k - 6;
+    double sxy = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+      if (i + delay >= 0 && i + delay < 6) sxy += data1[i] * data2[i + delay];
+    }
+    TEST_EQUAL (result.data[k].first, delay)
+    TEST_EQUAL (result.data[k].second, sxy / 6)
+  }
+
+  // a lag larger than one skips delays
+  result = Scoring::standardizedCrossCorrelation(data1, data2, 6, 2);
+  TEST_EQUAL (result.data.size(), 7)
+  TEST_EQUAL (result.data[0].first, -6)
+  TEST_EQUAL (result.data[3].first, 0)
+  TEST_REAL_SIMILAR (result.data[3].second, 0.4159292);
+  TEST_REAL_SIMILAR (result.data[4].second, -0.7374631);
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::calcxcorr(std::vector<double>& data1, std::vector<double>& data2, bool normalize)))
 {
@@ -451,6 +507,62 @@ m1 = mi(x_ranking,y_ranking)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_computeRankedVector)
+{
+  static const double arr1[] =
+  {
+    5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765,
+    8.40812492370605, 2.83419919013977, 6.94378805160522, 7.69957494735718, 4.08597040176392
+  };
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+
+  Scoring::RankedVector result = Scoring::computeRankedVector(data1);
+
+  TEST_EQUAL (result.ranks == Scoring::computeRank(data1), true)
+  TEST_EQUAL (result.counts.size(), 11)
+  TEST_EQUAL (result.counts[0], 1)
+  TEST_EQUAL (result.counts[2], 2) // tie
+  TEST_EQUAL (result.counts[3], 0) // skipped after tie
+  TEST_EQUAL (result.counts[10], 1)
+}
+END_SECTION
+
+BOOST_AUTO_TEST_CASE(test_rankedMutualInformation_ranked)
+{
+  static const double arr1[] =
+  {
+    5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765,
+    8.40812492370605, 2.83419919013977, 6.94378805160522, 7.69957494735718, 4.08597040176392
+  };
+  static const double arr2[] =
+  {
+    15.8951349258423, 41.5446395874023, 76.0746307373047, 109.069435119629, 111.90364074707, 169.79216003418,
+    121.043930053711, 63.0136985778809, 44.6150207519531, 21.4926776885986, 7.93575811386108
+  };
+  static const double arr3[] = {0, 0, 1, 2, 2, 2, 1, 0, 0, 0, 0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+  std::vector<double> data3 (arr3, arr3 + sizeof(arr3) / sizeof(arr3[0]) );
+
+  Scoring::RankedVector ranked1 = Scoring::computeRankedVector(data1);
+  Scoring::RankedVector ranked2 = Scoring::computeRankedVector(data2);
+  Scoring::RankedVector ranked3 = Scoring::computeRankedVector(data3);
+  std::vector<std::pair<unsigned int, unsigned int> > workspace;
+
+  TEST_REAL_SIMILAR (Scoring::rankedMutualInformation(ranked1, ranked2, workspace), 3.2776);
+
+  // identical to MIToolbox on the rank-transformed data, also with many ties
+  std::vector<unsigned int> rank1 = Scoring::computeRank(data1);
+  std::vector<unsigned int> rank2 = Scoring::computeRank(data2);
+  std::vector<unsigned int> rank3 = Scoring::computeRank(data3);
+  TEST_EQUAL (Scoring::rankedMutualInformation(ranked1, ranked2, workspace), calcMutualInformation(&rank1[0], &rank2[0], rank1.size()))
+  TEST_EQUAL (Scoring::rankedMutualInformation(ranked3, ranked1, workspace), calcMutualInformation(&rank3[0], &rank1[0], rank3.size()))
+  TEST_EQUAL (Scoring::rankedMutualInformation(ranked2, ranked3, workspace), calcMutualInformation(&rank2[0], &rank3[0], rank2.size()))
+  TEST_EQUAL (Scoring::rankedMutualInformation(ranked3, ranked3, workspace), calcMutualInformation(&rank3[0], &rank3[0], rank3.size()))
+  TEST_EQUAL (workspace.size(), 11)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
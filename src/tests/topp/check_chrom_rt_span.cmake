@@ -0,0 +1,34 @@
+# Checks that all SRM chromatograms listed by FileInfo -d (FILE) cover an RT
+# range of at most MAX_SPAN seconds.
+
+# keep empty lines in lists
+cmake_policy(SET CMP0007 NEW)
+
+file(STRINGS ${FILE} LINES)
+set(IN_LISTING FALSE)
+set(COUNT 0)
+foreach(LINE IN LISTS LINES)
+  if(LINE STREQUAL "Q1 Q3 RT_begin RT_end name comment")
+    set(IN_LISTING TRUE)
+  elseif(IN_LISTING)
+    # Q1 Q3 RT_begin RT_end name [comment]
+    if(NOT LINE MATCHES "^[-0-9.e+]+ [-0-9.e+]+ ([-0-9.e+]+) ([-0-9.e+]+) ")
+      break()
+    endif()
+    set(RT_BEGIN ${CMAKE_MATCH_1})
+    set(RT_END ${CMAKE_MATCH_2})
+    # math(EXPR) only supports integers, the truncated difference is not
+    # larger than the true one rounded up
+    string(REGEX REPLACE "\\..*" "" RT_BEGIN_INT "${RT_BEGIN}")
+    string(REGEX REPLACE "\\..*" "" RT_END_INT "${RT_END}")
+    math(EXPR SPAN "${RT_END_INT} - ${RT_BEGIN_INT}")
+    if(SPAN GREATER MAX_SPAN)
+      message(FATAL_ERROR "Chromatogram covers ${RT_BEGIN} - ${RT_END} s, more than ${MAX_SPAN} s: ${LINE}")
+    endif()
+    math(EXPR COUNT "${COUNT} + 1")
+  endif()
+endforeach()
+if(COUNT EQUAL 0)
+  message(FATAL_ERROR "${FILE} does not list any SRM chromatograms")
+endif()
+message(STATUS "Match: ${COUNT} chromatograms cover at most ${MAX_SPAN} s")
@@ -0,0 +1,50 @@
+# Compares two OpenSwathWorkflow TSV files (FILE1, FILE2) independent of the
+# row order and of the feature ids (column "id"), which depend on the random
+# seed of the process that wrote them (e.g. different for each shard).
+
+# keep empty fields in lists
+cmake_policy(SET CMP0007 NEW)
+
+function(read_osw_tsv FILE RESULT)
+  file(READ ${FILE} CONTENT)
+  # semicolons separate CMake list elements
+  string(REPLACE ";" "," CONTENT "${CONTENT}")
+  string(REGEX REPLACE "\n$" "" CONTENT "${CONTENT}")
+  string(REPLACE "\n" ";" LINES "${CONTENT}")
+  list(GET LINES 0 HEADER)
+  string(REPLACE "\t" ";" HEADER "${HEADER}")
+  list(FIND HEADER "id" ID_COL)
+  if(ID_COL EQUAL -1)
+    message(FATAL_ERROR "${FILE} has no 'id' column")
+  endif()
+  set(ROWS "")
+  foreach(LINE ${LINES})
+    # drop the id column
+    string(REPLACE "\t" ";" FIELDS "${LINE}")
+    list(REMOVE_AT FIELDS ${ID_COL})
+    string(REPLACE ";" "\t" LINE "${FIELDS}")
+    list(APPEND ROWS "${LINE}")
+  endforeach()
+  list(SORT ROWS)
+  set(${RESULT} "${ROWS}" PARENT_SCOPE)
+endfunction()
+
+read_osw_tsv(${FILE1} ROWS1)
+read_osw_tsv(${FILE2} ROWS2)
+list(LENGTH ROWS1 N1)
+list(LENGTH ROWS2 N2)
+if(NOT N1 EQUAL N2)
+  message(FATAL_ERROR "Mismatch: ${FILE1} has ${N1} lines, ${FILE2} has ${N2} lines")
+endif()
+if(N1 LESS 2)
+  message(FATAL_ERROR "${FILE1} does not contain any peak groups")
+endif()
+math(EXPR LAST "${N1} - 1")
+foreach(I RANGE ${LAST})
+  list(GET ROWS1 ${I} ROW1)
+  list(GET ROWS2 ${I} ROW2)
+  if(NOT ROW1 STREQUAL ROW2)
+    message(FATAL_ERROR "Mismatch:\n${ROW1}\n!=\n${ROW2}")
+  endif()
+endforeach()
+message(STATUS "Match: ${N1} lines")
@@ -39,6 +39,7 @@
 #include <OpenMS/APPLICATIONS/TOPPBase.h>
 #include <OpenMS/DATASTRUCTURES/StringListUtils.h>
 
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
 
 using namespace OpenMS;
@@ -98,35 +99,6 @@ public:
   {
   }
 
-  /**
-    @brief Helper class for the Low Memory Noise filtering
-  */
-  class NFGaussMzMLConsumer :
-    public MSDataWritingConsumer 
-  {
-
-  public:
-
-    NFGaussMzMLConsumer(const String& filename, const GaussFilter& gf) :
-      MSDataWritingConsumer(filename) 
-    {
-      gf_ = gf;
-    }
-
-    void processSpectrum_(MapType::SpectrumType& s) override
-    {
-      gf_.filter(s);
-    }
-
-    void processChromatogram_(MapType::ChromatogramType& c) override 
-    {
-      gf_.filter(c);
-    }
-
-  private:
-    GaussFilter gf_;
-  };
-
   void registerOptionsAndFlags_() override
   {
     registerInputFile_("in", "<file>", "", "input raw data file ");
@@ -145,13 +117,19 @@ public:
     return GaussFilter().getDefaults();
   }
 
-  ExitCodes doLowMemAlgorithm(const GaussFilter& gauss)
+  ExitCodes doLowMemAlgorithm(GaussFilter& gauss)
   {
     ///////////////////////////////////
-    // Create the consumer object, add data processing
+    // Create the consumer objects, add data processing
     ///////////////////////////////////
-    NFGaussMzMLConsumer gaussConsumer(out, gauss);
-    gaussConsumer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+    PlainMSDataWritingConsumer writer(out);
+    writer.addDataProcessing(getProcessingInfo_(DataProcessing::SMOOTHING));
+
+    // smooth batches of spectra/chromatograms on all cores while streaming
+    // through the file (filter() is thread-safe):
+    MSDataParallelTransformingConsumer gaussConsumer(&writer);
+    gaussConsumer.setSpectraProcessingFunc([&gauss](MSSpectrum& s) { gauss.filter(s); });
+    gaussConsumer.setChromatogramProcessingFunc([&gauss](MSChromatogram& c) { gauss.filter(c); });
 
     ///////////////////////////////////
     // Create new MSDataReader and set our consumer
@@ -159,6 +137,7 @@ public:
     MzMLFile mz_data_file;
     mz_data_file.setLogType(log_type_);
     mz_data_file.transform(in, &gaussConsumer);
+    gaussConsumer.flush();
 
     return EXECUTION_OK;
   }
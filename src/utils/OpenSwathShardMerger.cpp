@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathShardMerger.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/FileTypes.h>
+
+using namespace OpenMS;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+  @page UTILS_OpenSwathShardMerger OpenSwathShardMerger
+
+  @brief Combines the partial results of a sharded OpenSwathWorkflow analysis.
+
+  OpenSwathWorkflow can distribute the SWATH windows of a single run over
+  several processes (parameters @p -shard_count and @p -shard_index of @ref
+  UTILS_OpenSwathWorkflow), each of which writes a partial OSW or TSV file.
+  This tool combines all partial files of a run into a single file, which can
+  then be used like the output of a single OpenSwathWorkflow process (e.g. as
+  input to pyProphet). All input files and the output file need to be of the
+  same type. Each partial file records its shard index and the number of
+  shards, and all shards of the analysis have to be given (each once).
+
+  The peak groups are written in a canonical order (by precursor and retention
+  time) so that the output does not depend on the number of shards or on the
+  thread scheduling of the individual processes.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude UTILS_OpenSwathShardMerger.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude UTILS_OpenSwathShardMerger.html
+
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPOpenSwathShardMerger :
+  public TOPPBase
+{
+ public:
+
+  TOPPOpenSwathShardMerger()
+    : TOPPBase("OpenSwathShardMerger", "Combines the partial results of a sharded OpenSwathWorkflow analysis.", false)
+  {
+  }
+
+ protected:
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFileList_("in", "<files>", StringList(), "Partial OpenSwathWorkflow output files (one per shard)");
+    setValidFormats_("in", ListUtils::create<String>("osw,tsv"));
+
+    registerOutputFile_("out", "<file>", "", "Merged output file (same type as the input files)");
+    setValidFormats_("out", ListUtils::create<String>("osw,tsv"));
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    StringList in = getStringList_("in");
+    String out = getStringOption_("out");
+
+    FileTypes::Type out_type = FileHandler::getTypeByFileName(out);
+    for (const String& f : in)
+    {
+      if (FileHandler::getTypeByFileName(f) != out_type)
+      {
+        OPENMS_LOG_ERROR << "Input file '" << f << "' is not of the same type as the output file '" << out << "'." << std::endl;
+        return ILLEGAL_PARAMETERS;
+      }
+    }
+
+    if (out_type == FileTypes::OSW)
+    {
+      OpenSwathShardMerger::mergeOSW(in, out);
+    }
+    else
+    {
+      OpenSwathShardMerger::mergeTSV(in, out);
+    }
+
+    return EXECUTION_OK;
+  }
+
+};
+
+int main(int argc, const char** argv)
+{
+  TOPPOpenSwathShardMerger tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
@@ -58,6 +58,8 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSCached.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Helpers
@@ -188,6 +190,35 @@ using namespace OpenMS;
   In addition, the extracted chromatograms can be written out using the
   @p -out_chrom parameter.
 
+  For large assay libraries, the @p -lean_output flag reduces the memory
+  used for scoring: results are written every few peptides instead of once
+  per batch, and transient data structures are re-used by each thread. With
+  @p -out_chrom, each MS2 chromatogram is then written only within the RT
+  extraction window used for scoring (@p -rt_extraction_window). This mode is
+  not supported for SONAR data.
+
+  <h4> Distributing an analysis over several processes </h4>
+
+  A single run can be analyzed by several independent processes (e.g. on
+  different cluster nodes) using the @p -shard_count and @p -shard_index
+  parameters. Each process analyzes only every n-th SWATH window (starting at
+  window @p -shard_index) and writes a partial @p -out_tsv or @p -out_osw
+  file, all other steps (such as the RT normalization) are performed by each
+  process. The partial files are then combined using @ref UTILS_OpenSwathShardMerger,
+  for example:
+
+  @code
+  for i in 0 1 2 3; do
+    OpenSwathWorkflow -in run.mzML -tr library.pqp -out_osw run_$i.osw -shard_count 4 -shard_index $i [...] &
+  done
+  wait
+  OpenSwathShardMerger -in run_0.osw run_1.osw run_2.osw run_3.osw -out run.osw
+  @endcode
+
+  Sharding is not supported for SONAR data or for @p -out_features. If
+  @p -out_chrom is used, each process writes the chromatograms of its own
+  windows.
+
   <h4> Feature list output format </h4>
 
   The tab-separated feature output contains the following information:
@@ -530,6 +561,17 @@ protected:
     registerIntOption_("batchSize", "<number>", 1000, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 250-1000)", false, true);
     setMinInt_("batchSize", 0);
     registerIntOption_("outer_loop_threads", "<number>", -1, "How many threads should be used for the outer loop (-1 use all threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
+    registerIntOption_("spectrum_cache_memory", "<MB>", 0, "Memory (in MB) used to keep recently read spectra in memory so that they are not read from disk again (only with readOptions cache or sqMass input without working in memory, 0 disables the cache).", false, true);
+    setMinInt_("spectrum_cache_memory", 0);
+    registerIntOption_("prefetch_memory", "<MB>", 0, "Memory (in MB) that may be used to load the next SWATH windows in the background while the current ones are analyzed (only with readOptions cacheWorkingInMemory or workingInMemory, 0 disables prefetching).", false, true);
+    setMinInt_("prefetch_memory", 0);
+    registerIntOption_("im_index_memory", "<MB>", 512, "Memory (in MB) used to keep the ion mobility indices of recently scored spectra, per SWATH window analyzed at once (see outer_loop_threads) and for the MS1 map (only with ion_mobility_window, 0 disables the index).", false, true);
+    setMinInt_("im_index_memory", 0);
+    registerIntOption_("shard_count", "<number>", 1, "Number of processes (shards) the SWATH windows are distributed to. Each process analyzes only the windows of its shard (see shard_index), the partial results are combined with OpenSwathShardMerger (only with out_tsv or out_osw).", false, true);
+    setMinInt_("shard_count", 1);
+    registerIntOption_("shard_index", "<number>", 0, "Shard analyzed by this process (0 to shard_count - 1), only used if shard_count is larger than 1.", false, true);
+    setMinInt_("shard_index", 0);
+    registerFlag_("lean_output", "Write scoring results every few peptides and re-use transient data structures to reduce memory usage. Written MS2 chromatograms (out_chrom) only cover the RT extraction window used for scoring (not supported for SONAR data).", true);
 
     registerIntOption_("ms1_isotopes", "<number>", 3, "The number of MS1 isotopes used for extraction", false, true);
     setMinInt_("ms1_isotopes", 0);
@@ -691,6 +733,12 @@ protected:
     bool enable_uis_scoring = getStringOption_("enable_ipf") == "true";
     int batchSize = (int)getIntOption_("batchSize");
     int outer_loop_threads = (int)getIntOption_("outer_loop_threads");
+    Size prefetch_memory = (Size)getIntOption_("prefetch_memory") * 1024 * 1024;
+    Size spectrum_cache_memory = (Size)getIntOption_("spectrum_cache_memory") * 1024 * 1024;
+    Size im_index_memory = (Size)getIntOption_("im_index_memory") * 1024 * 1024;
+    Size shard_count = (Size)getIntOption_("shard_count");
+    Size shard_index = (Size)getIntOption_("shard_index");
+    bool lean_output = getFlag_("lean_output");
     int ms1_isotopes = (int)getIntOption_("ms1_isotopes");
     Size debug_level = (Size)getIntOption_("debug");
 
@@ -743,6 +791,21 @@ protected:
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           "OSW output files can only be generated in combination with PQP input files (-tr).");
     }
+    if (shard_index >= shard_count)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "shard_index needs to be smaller than shard_count.");
+    }
+    if (shard_count > 1 && (sonar || !out.empty()))
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Sharding (shard_count > 1) is only supported for non-SONAR data and out_tsv or out_osw output.");
+    }
+    if (lean_output && sonar)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "The lean_output mode is not supported for SONAR data.");
+    }
 
     // Check swath window input
     if (!swath_windows_file.empty())
@@ -850,6 +913,24 @@ protected:
       }
     }
 
+    // Keep recently read spectra of on-disk maps in memory (the budget is
+    // split evenly between the maps)
+    if (spectrum_cache_memory > 0 && !load_into_memory && !swath_maps.empty())
+    {
+      Size cache_per_map = spectrum_cache_memory / swath_maps.size();
+      for (auto& m : swath_maps)
+      {
+        if (auto cached = boost::dynamic_pointer_cast<SpectrumAccessOpenMSCached>(m.sptr))
+        {
+          cached->setCacheSize(cache_per_map);
+        }
+        else if (auto sqmass = boost::dynamic_pointer_cast<SpectrumAccessSqMass>(m.sptr))
+        {
+          sqmass->setCacheSize(cache_per_map);
+        }
+      }
+    }
+
 
     ///////////////////////////////////
     // Get the transformation information (using iRT peptides)
@@ -927,6 +1008,13 @@ protected:
     // Either use chrom.mzML or sqliteDB (sqMass)
     ///////////////////////////////////
     Interfaces::IMSDataConsumer* chromatogramConsumer;
+    if (shard_count > 1)
+    {
+      // processes of the same analysis may start at the same time (or use the
+      // fixed test seed), make sure their feature ids do not collide (also not
+      // with those of another analysis started a few seconds later)
+      UniqueIdGenerator::setSeed(UniqueIdGenerator::deriveSeed(UniqueIdGenerator::getSeed(), shard_index));
+    }
     UInt64 run_id = OpenMS::UniqueIdGenerator::getUniqueId();
     prepareChromOutput(&chromatogramConsumer, exp_meta, transition_exp, out_chrom, run_id);
 
@@ -949,8 +1037,11 @@ protected:
     }
     else
     {
-      OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, prm, outer_loop_threads);
+      OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, prm, outer_loop_threads, prefetch_memory);
       wf.setLogType(log_type_);
+      wf.setShard(shard_index, shard_count);
+      wf.setLeanOutput(lean_output);
+      wf.setIonMobilityIndexMemory(im_index_memory);
       wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
     }
@@ -77,6 +77,7 @@ if(NOT DISABLE_OPENSWATH)
     OpenSwathWorkflow
     OpenSwathFileSplitter
     OpenSwathRewriteToFeatureXML
+    OpenSwathShardMerger
     MRMTransitionGroupPicker
   )
 endif(NOT DISABLE_OPENSWATH)